@@ -0,0 +1,183 @@
+/**
+ * Arduino.h — Host stand-in for the Arduino-ESP32 core (emulator build only).
+ *
+ * Provides just enough of String, Serial, GPIO, timing and FreeRTOS for
+ * src/main.cpp to compile and run unmodified on a POSIX host. Time is the
+ * emulator's simulated clock (see emulator_clock.h), not wall time.
+ */
+
+#ifndef EMULATOR_ARDUINO_H
+#define EMULATOR_ARDUINO_H
+
+#include <cctype>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "emulator_clock.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+constexpr uint8_t LOW = 0;
+constexpr uint8_t HIGH = 1;
+constexpr uint8_t INPUT = 0x01;
+constexpr uint8_t OUTPUT = 0x03;
+
+// =============================================================================
+// String
+// =============================================================================
+
+class String {
+public:
+    String() {}
+    String(const char* s) : s_(s ? s : "") {}
+    String(const std::string& s) : s_(s) {}
+    explicit String(int v) : s_(std::to_string(v)) {}
+    explicit String(unsigned v) : s_(std::to_string(v)) {}
+    explicit String(long v) : s_(std::to_string(v)) {}
+    explicit String(unsigned long v) : s_(std::to_string(v)) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(s_.size()); }
+    bool isEmpty() const { return s_.empty(); }
+
+    int indexOf(char c, unsigned int from = 0) const { return find(s_.find(c, from)); }
+    int indexOf(const char* s, unsigned int from = 0) const { return find(s_.find(s, from)); }
+    int indexOf(const String& s, unsigned int from = 0) const { return find(s_.find(s.s_, from)); }
+
+    String substring(unsigned int from) const {
+        return from >= s_.size() ? String() : String(s_.substr(from));
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        return from >= s_.size() ? String() : String(s_.substr(from, to - from));
+    }
+
+    long toInt() const { return std::strtol(s_.c_str(), nullptr, 10); }
+    float toFloat() const { return std::strtof(s_.c_str(), nullptr); }
+    bool equalsIgnoreCase(const String& o) const {
+        if (s_.size() != o.s_.size()) return false;
+        for (size_t i = 0; i < s_.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(s_[i])) !=
+                std::tolower(static_cast<unsigned char>(o.s_[i]))) return false;
+        }
+        return true;
+    }
+
+    String& operator+=(const String& o) { s_ += o.s_; return *this; }
+    String& operator+=(const char* o) { s_ += o; return *this; }
+    String& operator+=(char c) { s_ += c; return *this; }
+    friend String operator+(String a, const String& b) { a += b; return a; }
+    bool operator==(const String& o) const { return s_ == o.s_; }
+    bool operator==(const char* o) const { return s_ == o; }
+    bool operator!=(const String& o) const { return s_ != o.s_; }
+    char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : '\0'; }
+
+    const std::string& str() const { return s_; }
+
+private:
+    static int find(size_t pos) { return pos == std::string::npos ? -1 : static_cast<int>(pos); }
+    std::string s_;
+};
+
+// =============================================================================
+// IPAddress (IPv4, stored in network byte order like the ESP32 core)
+// =============================================================================
+
+class IPAddress {
+public:
+    IPAddress() {}
+    explicit IPAddress(uint32_t address) : address_(address) {}
+    operator uint32_t() const { return address_; }
+
+private:
+    uint32_t address_ = 0;
+};
+
+// =============================================================================
+// Serial
+// =============================================================================
+
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t println(const char* s = "") { return write(s) + write("\n"); }
+    size_t println(const String& s) { return println(s.c_str()); }
+    size_t println(int v) { return printf("%d\n", v); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = std::vprintf(fmt, ap);
+        va_end(ap);
+        std::fflush(stdout);
+        return n < 0 ? 0 : static_cast<size_t>(n);
+    }
+
+private:
+    size_t write(const char* s) {
+        size_t n = std::fputs(s, stdout) < 0 ? 0 : std::strlen(s);
+        std::fflush(stdout);
+        return n;
+    }
+};
+
+extern HardwareSerial Serial;
+
+// =============================================================================
+// GPIO & Timing
+// =============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+inline uint32_t millis() { return static_cast<uint32_t>(emulatorNowUs() / 1000ULL); }
+inline uint32_t micros() { return static_cast<uint32_t>(emulatorNowUs()); }
+inline void delay(uint32_t ms) { emulatorSleepSimUs(static_cast<uint64_t>(ms) * 1000ULL); }
+inline void yield() {}
+
+// =============================================================================
+// FreeRTOS (tasks run as detached host threads)
+// =============================================================================
+
+typedef void (*TaskFunction_t)(void*);
+typedef void* TaskHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+constexpr UBaseType_t tskIDLE_PRIORITY = 0;
+constexpr BaseType_t pdPASS = 1;
+constexpr TickType_t portTICK_PERIOD_MS = 1;
+
+inline TickType_t pdMS_TO_TICKS(uint32_t ms) { return ms; }
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+
+// =============================================================================
+// ESP (chip control)
+// =============================================================================
+
+class EspClass {
+public:
+    /** A device restart ends the emulator process. */
+    [[noreturn]] void restart() {
+        std::fflush(stdout);
+        std::exit(0);
+    }
+};
+
+extern EspClass ESP;
+
+#endif // EMULATOR_ARDUINO_H
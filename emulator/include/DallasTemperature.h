@@ -0,0 +1,36 @@
+/**
+ * DallasTemperature.h — Host stand-in for the DS18B20 driver (emulator
+ * build only).
+ *
+ * Readings come from the emulator's thermal plant, quantized to the
+ * DS18B20's 12-bit resolution (1/16 °C). A conversion only completes
+ * 750 ms (simulated) after requestTemperatures(); reading earlier returns
+ * the previous result, as the real scratchpad does. Each probe has a ROM
+ * code of its own; bus indexes count only the probes still present, so a
+ * probe dropped with --drop-probe renumbers the ones after it.
+ */
+
+#ifndef EMULATOR_DALLAS_TEMPERATURE_H
+#define EMULATOR_DALLAS_TEMPERATURE_H
+
+#include <cstdint>
+
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+typedef uint8_t DeviceAddress[8];
+
+class DallasTemperature {
+public:
+    explicit DallasTemperature(OneWire* wire) { (void)wire; }
+
+    void begin() {}
+    uint8_t getDeviceCount();
+    void setWaitForConversion(bool wait) { (void)wait; }
+    void requestTemperatures();
+    bool getAddress(uint8_t* address, uint8_t index);
+    float getTempC(const uint8_t* address);
+};
+
+#endif // EMULATOR_DALLAS_TEMPERATURE_H
@@ -0,0 +1,138 @@
+/**
+ * HomeSpan.h — Host stand-in for the HomeSpan library (emulator build only).
+ *
+ * Characteristics hold values in memory; there is no HAP server. poll()
+ * fires the WiFi callback once and then runs every service's loop(), the
+ * same call order HomeSpan uses on the device.
+ */
+
+#ifndef EMULATOR_HOMESPAN_H
+#define EMULATOR_HOMESPAN_H
+
+#include <cstdarg>
+#include <vector>
+
+#include "Arduino.h"
+
+#define LOG0(...) Serial.printf(__VA_ARGS__)
+#define LOG1(...) Serial.printf(__VA_ARGS__)
+#define LOG2(...) do {} while (0)
+
+enum class Category { Thermostats = 9 };
+
+// =============================================================================
+// Characteristics
+// =============================================================================
+
+class SpanCharacteristic {
+public:
+    explicit SpanCharacteristic(double value = 0.0) : value_(value), newValue_(value) {}
+    virtual ~SpanCharacteristic() {}
+
+    template <class T = int> T getVal() const { return static_cast<T>(value_); }
+    template <class T = int> T getNewVal() const { return static_cast<T>(newValue_); }
+    bool updated() const { return updated_; }
+
+    template <typename T> void setVal(T value, bool notify = true) {
+        (void)notify;
+        value_ = newValue_ = static_cast<double>(value);
+    }
+
+    SpanCharacteristic* setRange(double min, double max, double step = 0) {
+        (void)min; (void)max; (void)step;
+        return this;
+    }
+    SpanCharacteristic* setValidValues(int n, ...) {
+        (void)n;
+        return this;
+    }
+
+private:
+    double value_;
+    double newValue_;
+    bool updated_ = false;
+};
+
+/** String-valued characteristics carry no state in the emulator. */
+class SpanStringCharacteristic : public SpanCharacteristic {
+public:
+    explicit SpanStringCharacteristic(const char* = "") : SpanCharacteristic(0.0) {}
+};
+
+namespace Characteristic {
+    struct CurrentTemperature : SpanCharacteristic {
+        explicit CurrentTemperature(double v = 0) : SpanCharacteristic(v) {}
+    };
+    struct TargetTemperature : SpanCharacteristic {
+        explicit TargetTemperature(double v = 10) : SpanCharacteristic(v) {}
+    };
+    struct CurrentHeatingCoolingState : SpanCharacteristic {
+        explicit CurrentHeatingCoolingState(double v = 0) : SpanCharacteristic(v) {}
+    };
+    struct TargetHeatingCoolingState : SpanCharacteristic {
+        explicit TargetHeatingCoolingState(double v = 0) : SpanCharacteristic(v) {}
+    };
+    struct TemperatureDisplayUnits : SpanCharacteristic {
+        explicit TemperatureDisplayUnits(double v = 0) : SpanCharacteristic(v) {}
+    };
+    struct Identify : SpanCharacteristic {};
+    struct Name : SpanStringCharacteristic {
+        explicit Name(const char* s = "") : SpanStringCharacteristic(s) {}
+    };
+    struct Manufacturer : SpanStringCharacteristic {
+        explicit Manufacturer(const char* s = "") : SpanStringCharacteristic(s) {}
+    };
+    struct Model : SpanStringCharacteristic {
+        explicit Model(const char* s = "") : SpanStringCharacteristic(s) {}
+    };
+    struct SerialNumber : SpanStringCharacteristic {
+        explicit SerialNumber(const char* s = "") : SpanStringCharacteristic(s) {}
+    };
+    struct FirmwareRevision : SpanStringCharacteristic {
+        explicit FirmwareRevision(const char* s = "") : SpanStringCharacteristic(s) {}
+    };
+}
+
+// =============================================================================
+// Services & Accessories
+// =============================================================================
+
+class SpanService {
+public:
+    SpanService();
+    virtual ~SpanService() {}
+    virtual bool update() { return true; }
+    virtual void loop() {}
+};
+
+namespace Service {
+    struct AccessoryInformation : SpanService {};
+    struct Thermostat : SpanService {};
+}
+
+struct SpanAccessory {
+    explicit SpanAccessory(uint32_t aid = 0) { (void)aid; }
+};
+
+// =============================================================================
+// Span
+// =============================================================================
+
+class Span {
+public:
+    void begin(Category category, const char* displayName);
+    void poll();
+    Span& setWifiCallback(void (*callback)()) { wifiCallback_ = callback; return *this; }
+    Span& enableOTA(const char* password) { (void)password; return *this; }
+
+    void registerService(SpanService* service) { services_.push_back(service); }
+
+private:
+    void (*wifiCallback_)() = nullptr;
+    bool wifiStarted_ = false;
+    std::vector<SpanService*> services_;
+};
+
+extern Span homeSpan;
+
+#endif // EMULATOR_HOMESPAN_H
@@ -0,0 +1,19 @@
+/**
+ * OneWire.h — Host stand-in for the OneWire library (emulator build only).
+ */
+
+#ifndef EMULATOR_ONEWIRE_H
+#define EMULATOR_ONEWIRE_H
+
+#include <cstdint>
+
+class OneWire {
+public:
+    explicit OneWire(uint8_t pin) : pin_(pin) {}
+    uint8_t pin() const { return pin_; }
+
+private:
+    uint8_t pin_;
+};
+
+#endif // EMULATOR_ONEWIRE_H
@@ -0,0 +1,77 @@
+/**
+ * Preferences.h — Host stand-in for the Arduino-ESP32 NVS key-value store
+ * (emulator build only).
+ *
+ * Values live in memory for the life of the process, so every emulator
+ * start behaves like a freshly erased flash. Only the calls the firmware
+ * uses are provided.
+ */
+
+#ifndef EMULATOR_PREFERENCES_H
+#define EMULATOR_PREFERENCES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        ns_ = name;
+        readOnly_ = readOnly;
+        open_ = true;
+        return true;
+    }
+
+    void end() { open_ = false; }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        if (!open_ || readOnly_) return 0;
+        const uint8_t* p = static_cast<const uint8_t*>(value);
+        store()[ns_ + "/" + key].assign(p, p + len);
+        return len;
+    }
+
+    size_t getBytesLength(const char* key) {
+        const std::vector<uint8_t>* v = find(key);
+        return v ? v->size() : 0;
+    }
+
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        const std::vector<uint8_t>* v = find(key);
+        if (!v || v->size() > maxLen) return 0;
+        std::memcpy(buf, v->data(), v->size());
+        return v->size();
+    }
+
+    size_t putULong64(const char* key, uint64_t value) {
+        return putBytes(key, &value, sizeof(value));
+    }
+
+    uint64_t getULong64(const char* key, uint64_t defaultValue = 0) {
+        uint64_t value;
+        return getBytesLength(key) == sizeof(value) && getBytes(key, &value, sizeof(value))
+                   ? value : defaultValue;
+    }
+
+private:
+    static std::map<std::string, std::vector<uint8_t>>& store() {
+        static std::map<std::string, std::vector<uint8_t>> s;
+        return s;
+    }
+
+    const std::vector<uint8_t>* find(const char* key) {
+        if (!open_) return nullptr;
+        auto it = store().find(ns_ + "/" + key);
+        return it == store().end() ? nullptr : &it->second;
+    }
+
+    std::string ns_;
+    bool readOnly_ = false;
+    bool open_ = false;
+};
+
+#endif // EMULATOR_PREFERENCES_H
@@ -0,0 +1,125 @@
+/**
+ * WebServer.h — Host stand-in for the Arduino-ESP32 WebServer (emulator
+ * build only).
+ *
+ * A real HTTP/1.1 server on POSIX sockets with the same programming model
+ * as the device: route registration with on(), one connection serviced per
+ * handleClient() call, Connection: close after every response, and the
+ * request body exposed as arg("plain") — cut at its first zero byte, as on
+ * the device — or, on routes with an upload callback, streamed to it intact
+ * through raw().
+ */
+
+#ifndef EMULATOR_WEBSERVER_H
+#define EMULATOR_WEBSERVER_H
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Arduino.h"
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+enum HTTPUploadStatus {
+    UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED
+};
+
+/** Multipart upload state. Uploads are not emulated — the handler never sees one. */
+struct HTTPUpload {
+    HTTPUploadStatus status = UPLOAD_FILE_START;
+    String filename;
+    String name;
+    String type;
+    size_t totalSize = 0;
+    size_t currentSize = 0;
+    uint8_t buf[1436] = {};
+};
+
+enum HTTPRawStatus { RAW_START, RAW_WRITE, RAW_END, RAW_ABORTED };
+
+#define HTTP_RAW_BUFLEN 1436
+
+/**
+ * Raw body state. As on the device, a route registered with an upload
+ * callback gets any non-multipart body streamed to that callback in
+ * HTTP_RAW_BUFLEN chunks, bytes as sent, and arg("plain") is not set.
+ */
+struct HTTPRaw {
+    HTTPRawStatus status = RAW_START;
+    size_t totalSize = 0;
+    size_t currentSize = 0;
+    uint8_t buf[HTTP_RAW_BUFLEN] = {};
+};
+
+/** The connected client — only the peer address is emulated. */
+class WiFiClient {
+public:
+    IPAddress remoteIP() const { return remoteIP_; }
+    void setRemoteIP(IPAddress ip) { remoteIP_ = ip; }
+
+private:
+    IPAddress remoteIP_;
+};
+
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit WebServer(int port = 80) : port_(port) {}
+    ~WebServer();
+
+    void begin();
+    void handleClient();
+
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+    void collectHeaders(const char* headerKeys[], size_t headerKeysCount);
+
+    void send(int code, const char* contentType = nullptr, const String& content = String(""));
+    void send_P(int code, const char* contentType, const char* content, size_t contentLength);
+    void sendHeader(const String& name, const String& value, bool first = false);
+
+    String header(const String& name) const;
+    String arg(const String& name) const;
+    bool hasArg(const String& name) const;
+    String uri() const { return uri_; }
+    HTTPMethod method() const { return method_; }
+    HTTPUpload& upload() { return upload_; }
+    HTTPRaw& raw() { return raw_; }
+    WiFiClient& client() { return client_; }
+
+private:
+    struct Route {
+        std::string uri;
+        HTTPMethod method;
+        THandlerFunction fn;
+        THandlerFunction ufn;
+    };
+    typedef std::vector<std::pair<std::string, std::string> > KeyValues;
+
+    bool readRequest(int fd);
+    void dispatch();
+    void streamRaw(const Route& r);
+
+    int port_;
+    int listenFd_ = -1;
+    int clientFd_ = -1;
+    bool responded_ = false;
+    std::vector<Route> routes_;
+    std::vector<std::string> collected_;
+
+    // Current request
+    HTTPMethod method_ = HTTP_ANY;
+    String uri_;
+    KeyValues headers_;
+    KeyValues args_;
+    KeyValues responseHeaders_;
+    std::string body_;
+    HTTPUpload upload_;
+    HTTPRaw raw_;
+    WiFiClient client_;
+};
+
+#endif // EMULATOR_WEBSERVER_H
@@ -0,0 +1,49 @@
+/**
+ * WiFiUdp.h — Host stand-in for the Arduino-ESP32 WiFiUDP (emulator build
+ * only).
+ *
+ * A non-blocking POSIX UDP socket with the device's packet-at-a-time
+ * model: parsePacket() receives one datagram, read() copies it out, and
+ * beginPacket()/write()/endPacket() send one reply.
+ */
+
+#ifndef EMULATOR_WIFIUDP_H
+#define EMULATOR_WIFIUDP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Arduino.h"
+
+class WiFiUDP {
+public:
+    ~WiFiUDP();
+
+    /** Returns 1 on success, 0 if the port cannot be bound. */
+    uint8_t begin(uint16_t port);
+
+    int parsePacket();
+    int read(uint8_t* buf, size_t len);
+    IPAddress remoteIP() const { return remoteIP_; }
+    uint16_t remotePort() const { return remotePort_; }
+
+    int beginPacket(IPAddress ip, uint16_t port);
+    size_t write(const uint8_t* buf, size_t len);
+    int endPacket();
+
+private:
+    static constexpr size_t MAX_DATAGRAM = 1472;
+
+    int fd_ = -1;
+    uint8_t rx_[MAX_DATAGRAM];
+    size_t rxLen_ = 0;
+    size_t rxPos_ = 0;
+    IPAddress remoteIP_;
+    uint16_t remotePort_ = 0;
+    uint8_t tx_[MAX_DATAGRAM];
+    size_t txLen_ = 0;
+    IPAddress txIP_;
+    uint16_t txPort_ = 0;
+};
+
+#endif // EMULATOR_WIFIUDP_H
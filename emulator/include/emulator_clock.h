@@ -0,0 +1,24 @@
+/**
+ * emulator_clock.h — Simulated time base for the host emulator.
+ *
+ * Simulated time runs at a configurable multiple of wall time
+ * (--speed), so a 60-minute session can be exercised in well under a
+ * minute. millis(), micros(), delay() and vTaskDelay() all use it.
+ */
+
+#ifndef EMULATOR_CLOCK_H
+#define EMULATOR_CLOCK_H
+
+#include <cstdint>
+
+/** Sets how many simulated seconds pass per wall-clock second (default 1). */
+void emulatorSetSpeed(double factor);
+double emulatorSpeed();
+
+/** Simulated microseconds since the emulator started. */
+uint64_t emulatorNowUs();
+
+/** Blocks for simUs of simulated time (simUs / speed of wall time). */
+void emulatorSleepSimUs(uint64_t simUs);
+
+#endif // EMULATOR_CLOCK_H
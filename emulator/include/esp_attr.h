@@ -0,0 +1,11 @@
+/**
+ * esp_attr.h — Host stand-in for ESP-IDF placement attributes (emulator
+ * build only). There is no RTC memory; variables are ordinary globals.
+ */
+
+#ifndef EMULATOR_ESP_ATTR_H
+#define EMULATOR_ESP_ATTR_H
+
+#define RTC_NOINIT_ATTR
+
+#endif // EMULATOR_ESP_ATTR_H
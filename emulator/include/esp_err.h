@@ -0,0 +1,13 @@
+/**
+ * esp_err.h — Host stand-in for ESP-IDF error codes (emulator build only).
+ */
+
+#ifndef EMULATOR_ESP_ERR_H
+#define EMULATOR_ESP_ERR_H
+
+typedef int esp_err_t;
+constexpr esp_err_t ESP_OK = 0;
+constexpr esp_err_t ESP_FAIL = -1;
+constexpr esp_err_t ESP_ERR_NOT_SUPPORTED = 0x106;
+
+#endif // EMULATOR_ESP_ERR_H
@@ -0,0 +1,38 @@
+/**
+ * esp_ota_ops.h — Host stand-in for the ESP-IDF OTA API (emulator build
+ * only). There are no OTA partitions; every call reports failure.
+ */
+
+#ifndef EMULATOR_ESP_OTA_OPS_H
+#define EMULATOR_ESP_OTA_OPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+#include "esp_partition.h"
+
+typedef uint32_t esp_ota_handle_t;
+constexpr size_t OTA_SIZE_UNKNOWN = 0xffffffff;
+
+inline const esp_partition_t* esp_ota_get_running_partition() { return nullptr; }
+inline const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start) {
+    (void)start;
+    return nullptr;
+}
+inline esp_err_t esp_ota_begin(const esp_partition_t* partition, size_t imageSize, esp_ota_handle_t* handle) {
+    (void)partition; (void)imageSize; (void)handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+inline esp_err_t esp_ota_write(esp_ota_handle_t handle, const void* data, size_t size) {
+    (void)handle; (void)data; (void)size;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+inline esp_err_t esp_ota_end(esp_ota_handle_t handle) { (void)handle; return ESP_ERR_NOT_SUPPORTED; }
+inline esp_err_t esp_ota_abort(esp_ota_handle_t handle) { (void)handle; return ESP_OK; }
+inline esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition) {
+    (void)partition;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // EMULATOR_ESP_OTA_OPS_H
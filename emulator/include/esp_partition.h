@@ -0,0 +1,26 @@
+/**
+ * esp_partition.h — Host stand-in for the ESP-IDF partition API (emulator
+ * build only). The emulator has no flash; reads always fail.
+ */
+
+#ifndef EMULATOR_ESP_PARTITION_H
+#define EMULATOR_ESP_PARTITION_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+struct esp_partition_t {
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+};
+
+inline esp_err_t esp_partition_read(const esp_partition_t* partition, size_t srcOffset,
+                                    void* dst, size_t size) {
+    (void)partition; (void)srcOffset; (void)dst; (void)size;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // EMULATOR_ESP_PARTITION_H
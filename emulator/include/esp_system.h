@@ -0,0 +1,25 @@
+/**
+ * esp_system.h — Host stand-in for ESP-IDF reset reasons (emulator build
+ * only). Every emulator start is a cold boot, so session resume never runs.
+ */
+
+#ifndef EMULATOR_ESP_SYSTEM_H
+#define EMULATOR_ESP_SYSTEM_H
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+inline esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+
+#endif // EMULATOR_ESP_SYSTEM_H
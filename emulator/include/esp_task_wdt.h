@@ -0,0 +1,20 @@
+/**
+ * esp_task_wdt.h — Host stand-in for the ESP-IDF task watchdog (emulator
+ * build only). The emulator has no watchdog; calls are accepted and ignored.
+ */
+
+#ifndef EMULATOR_ESP_TASK_WDT_H
+#define EMULATOR_ESP_TASK_WDT_H
+
+#include <cstdint>
+
+#include "esp_err.h"
+
+inline esp_err_t esp_task_wdt_init(uint32_t timeoutSec, bool panic) {
+    (void)timeoutSec; (void)panic;
+    return ESP_OK;
+}
+inline esp_err_t esp_task_wdt_add(void* task) { (void)task; return ESP_OK; }
+inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+
+#endif // EMULATOR_ESP_TASK_WDT_H
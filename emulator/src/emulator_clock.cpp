@@ -0,0 +1,38 @@
+/**
+ * emulator_clock.cpp — Scaled wall clock backing millis()/micros()/delay().
+ */
+
+#include "emulator_clock.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const Clock::time_point startTime = Clock::now();
+std::atomic<double> speedFactor{1.0};
+
+}  // namespace
+
+void emulatorSetSpeed(double factor) {
+    speedFactor.store(factor > 0.0 ? factor : 1.0);
+}
+
+double emulatorSpeed() {
+    return speedFactor.load();
+}
+
+uint64_t emulatorNowUs() {
+    double realUs = std::chrono::duration<double, std::micro>(Clock::now() - startTime).count();
+    return static_cast<uint64_t>(realUs * speedFactor.load());
+}
+
+void emulatorSleepSimUs(uint64_t simUs) {
+    // Never spin: even at high speed-ups, give up the CPU for at least 50 µs
+    double realUs = static_cast<double>(simUs) / speedFactor.load();
+    if (realUs < 50.0) realUs = 50.0;
+    std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(realUs)));
+}
@@ -0,0 +1,152 @@
+/**
+ * emulator_hal.cpp — GPIO, DS18B20, HomeSpan and FreeRTOS shims backed by
+ * the simulated thermal plant.
+ */
+
+#include "emulator_hal.h"
+
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include <Arduino.h>
+#include <DallasTemperature.h>
+#include <HomeSpan.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+Span homeSpan;
+
+EmulatorConfig emulatorConfig;
+ThermalPlantParams plantParams;
+ThermalPlantState plantState;
+
+// =============================================================================
+// GPIO
+// =============================================================================
+
+namespace {
+uint8_t pinLevels[EMU_PIN_COUNT] = {};
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin; (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < EMU_PIN_COUNT) pinLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < EMU_PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+uint8_t emulatorPinLevel(uint8_t pin) {
+    return pin < EMU_PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+// =============================================================================
+// DS18B20
+// =============================================================================
+
+namespace {
+constexpr uint32_t DS18B20_CONVERSION_MS = 750;
+constexpr uint8_t DS18B20_FAMILY = 0x28;
+uint32_t conversionStartMs = 0;
+bool conversionPending = false;
+float scratchpadC = 85.0f;   // DS18B20 power-on reset value
+bool stuck = false;
+float stuckC = 0.0f;
+
+bool probePresent(uint8_t probe) {
+    if (probe >= emulatorConfig.probeCount) return false;
+    return !(probe == emulatorConfig.dropProbe && millis() / 1000.0 >= emulatorConfig.dropAtSec);
+}
+
+float probeReading(uint8_t probe) {
+    if (emulatorConfig.sensorFaultAtSec >= 0.0 &&
+        millis() / 1000.0 >= emulatorConfig.sensorFaultAtSec) {
+        return DEVICE_DISCONNECTED_C;
+    }
+    if (conversionPending && millis() - conversionStartMs >= DS18B20_CONVERSION_MS) {
+        conversionPending = false;
+        scratchpadC = std::round(plantState.sensorC * 16.0f) / 16.0f;
+    }
+    if (probe == emulatorConfig.stuckProbe && millis() / 1000.0 >= emulatorConfig.stuckAtSec) {
+        // The frozen probe keeps answering with the last value it converted
+        if (!stuck) {
+            stuck = true;
+            stuckC = scratchpadC;
+        }
+        return stuckC;
+    }
+    return scratchpadC;
+}
+}
+
+uint8_t DallasTemperature::getDeviceCount() {
+    uint8_t n = 0;
+    for (uint8_t p = 0; p < emulatorConfig.probeCount; ++p) n += probePresent(p) ? 1 : 0;
+    return n;
+}
+
+void DallasTemperature::requestTemperatures() {
+    conversionStartMs = millis();
+    conversionPending = true;
+}
+
+bool DallasTemperature::getAddress(uint8_t* address, uint8_t index) {
+    // Like a bus search, the index counts only the probes that answer
+    uint8_t seen = 0;
+    for (uint8_t p = 0; p < emulatorConfig.probeCount; ++p) {
+        if (!probePresent(p)) continue;
+        if (seen++ == index) {
+            const uint8_t rom[8] = {DS18B20_FAMILY, static_cast<uint8_t>(p + 1), 0xE1, 0x5A, 0, 0, 0, 0};
+            std::memcpy(address, rom, sizeof(rom));
+            return true;
+        }
+    }
+    return false;
+}
+
+float DallasTemperature::getTempC(const uint8_t* address) {
+    if (address[0] != DS18B20_FAMILY || address[1] == 0) return DEVICE_DISCONNECTED_C;
+    uint8_t probe = static_cast<uint8_t>(address[1] - 1);
+    return probePresent(probe) ? probeReading(probe) : DEVICE_DISCONNECTED_C;
+}
+
+// =============================================================================
+// HomeSpan
+// =============================================================================
+
+SpanService::SpanService() {
+    homeSpan.registerService(this);
+}
+
+void Span::begin(Category category, const char* displayName) {
+    (void)category;
+    Serial.printf("HomeSpan (emulated): '%s' — no HAP server, REST only\n", displayName);
+}
+
+void Span::poll() {
+    if (!wifiStarted_) {
+        wifiStarted_ = true;
+        if (wifiCallback_) wifiCallback_();
+    }
+    for (SpanService* service : services_) {
+        service->loop();
+    }
+}
+
+// =============================================================================
+// FreeRTOS
+// =============================================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+    (void)name; (void)stackDepth; (void)priority; (void)core;
+    std::thread(fn, param).detach();
+    if (handle) *handle = nullptr;
+    return pdPASS;
+}
@@ -0,0 +1,40 @@
+/**
+ * emulator_hal.h — Shared state between the emulator's hardware shims and
+ * its main loop.
+ */
+
+#ifndef EMULATOR_HAL_H
+#define EMULATOR_HAL_H
+
+#include <cstdint>
+#include <string>
+
+#include "thermal_plant.h"
+
+// Must match the pin assignments in src/main.cpp
+constexpr uint8_t EMU_PIN_RELAY = 26;
+constexpr uint8_t EMU_PIN_COUNT = 40;
+
+struct EmulatorConfig {
+    int httpPort = 0;                  // 0 = use the port main.cpp asked for
+    int coapPort = 0;                  // 0 = use the port main.cpp asked for (5683)
+    std::string bindAddress = "127.0.0.1";
+    double speed = 1.0;                // Simulated seconds per wall second
+    double sensorFaultAtSec = -1.0;    // < 0 = never
+    double traceEverySec = 0.0;        // 0 = no plant trace
+    double durationSec = 0.0;          // 0 = run until killed
+    uint8_t probeCount = 1;            // DS18B20s on the bus, all reading the plant
+    int stuckProbe = -1;               // Probe that freezes at stuckAtSec, < 0 = none
+    double stuckAtSec = 0.0;
+    int dropProbe = -1;                // Probe that leaves the bus at dropAtSec, < 0 = none
+    double dropAtSec = 0.0;
+};
+
+extern EmulatorConfig emulatorConfig;
+extern ThermalPlantParams plantParams;
+extern ThermalPlantState plantState;
+
+/** Current level of an output pin as last written by the firmware. */
+uint8_t emulatorPinLevel(uint8_t pin);
+
+#endif // EMULATOR_HAL_H
@@ -0,0 +1,149 @@
+/**
+ * emulator_main.cpp — Runs the unmodified firmware (src/main.cpp) on the
+ * host against a simulated sauna.
+ *
+ * The firmware's setup() and loop() are called exactly as the Arduino core
+ * would call them. Between loop() passes the thermal plant is advanced to
+ * the current simulated time with the relay state the firmware last wrote.
+ *
+ *   emulator --port 8080 --speed 100 --trace 60
+ */
+
+#include <Arduino.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "emulator_hal.h"
+
+void setup();
+void loop();
+
+namespace {
+
+void usage(const char* argv0) {
+    std::printf(
+        "usage: %s [options]\n"
+        "  --port N             HTTP port (default: the firmware's, 8080)\n"
+        "  --coap-port N        CoAP UDP port (default: the firmware's, 5683)\n"
+        "  --bind ADDR          IPv4 address to listen on (default 127.0.0.1)\n"
+        "  --speed X            simulated seconds per wall second (default 1)\n"
+        "  --ambient C          ambient temperature (default 20)\n"
+        "  --start-temp C       initial room temperature (default: ambient)\n"
+        "  --heater-watts W     heater power (default 7000)\n"
+        "  --sensor-fault-at S  disconnect the probe at S simulated seconds\n"
+        "  --probes N           DS18B20 probes on the bus, 1-3 (default 1)\n"
+        "  --stuck-probe I@S    freeze probe I's reading at S simulated seconds\n"
+        "  --drop-probe I@S     take probe I off the bus at S simulated seconds\n"
+        "  --trace S            print plant state every S simulated seconds\n"
+        "  --duration S         exit after S simulated seconds\n",
+        argv0);
+}
+
+bool parseArgs(int argc, char** argv) {
+    bool startTempSet = false;
+    float startTemp = 0.0f;
+    for (int i = 1; i < argc; ++i) {
+        const char* opt = argv[i];
+        if (std::strcmp(opt, "--help") == 0 || std::strcmp(opt, "-h") == 0) {
+            usage(argv[0]);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", opt);
+            return false;
+        }
+        const char* val = argv[++i];
+        if (std::strcmp(opt, "--port") == 0) {
+            emulatorConfig.httpPort = std::atoi(val);
+        } else if (std::strcmp(opt, "--coap-port") == 0) {
+            emulatorConfig.coapPort = std::atoi(val);
+        } else if (std::strcmp(opt, "--bind") == 0) {
+            emulatorConfig.bindAddress = val;
+        } else if (std::strcmp(opt, "--speed") == 0) {
+            emulatorConfig.speed = std::atof(val);
+        } else if (std::strcmp(opt, "--ambient") == 0) {
+            plantParams.ambientC = static_cast<float>(std::atof(val));
+        } else if (std::strcmp(opt, "--start-temp") == 0) {
+            startTemp = static_cast<float>(std::atof(val));
+            startTempSet = true;
+        } else if (std::strcmp(opt, "--heater-watts") == 0) {
+            plantParams.heaterPowerW = static_cast<float>(std::atof(val));
+        } else if (std::strcmp(opt, "--sensor-fault-at") == 0) {
+            emulatorConfig.sensorFaultAtSec = std::atof(val);
+        } else if (std::strcmp(opt, "--probes") == 0) {
+            emulatorConfig.probeCount = static_cast<uint8_t>(std::atoi(val));
+        } else if (std::strcmp(opt, "--stuck-probe") == 0) {
+            const char* at = std::strchr(val, '@');
+            if (!at) {
+                std::fprintf(stderr, "--stuck-probe takes INDEX@SECONDS\n");
+                return false;
+            }
+            emulatorConfig.stuckProbe = std::atoi(val);
+            emulatorConfig.stuckAtSec = std::atof(at + 1);
+        } else if (std::strcmp(opt, "--drop-probe") == 0) {
+            const char* at = std::strchr(val, '@');
+            if (!at) {
+                std::fprintf(stderr, "--drop-probe takes INDEX@SECONDS\n");
+                return false;
+            }
+            emulatorConfig.dropProbe = std::atoi(val);
+            emulatorConfig.dropAtSec = std::atof(at + 1);
+        } else if (std::strcmp(opt, "--trace") == 0) {
+            emulatorConfig.traceEverySec = std::atof(val);
+        } else if (std::strcmp(opt, "--duration") == 0) {
+            emulatorConfig.durationSec = std::atof(val);
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", opt);
+            return false;
+        }
+    }
+    if (emulatorConfig.probeCount < 1 || emulatorConfig.probeCount > 3) {
+        std::fprintf(stderr, "--probes must be 1 to 3\n");
+        return false;
+    }
+    if (!(emulatorConfig.speed > 0.0)) {
+        std::fprintf(stderr, "--speed must be positive\n");
+        return false;
+    }
+    plantState.airC = plantState.sensorC = startTempSet ? startTemp : plantParams.ambientC;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (!parseArgs(argc, argv)) {
+        usage(argv[0]);
+        return 2;
+    }
+    emulatorSetSpeed(emulatorConfig.speed);
+    std::printf("emulator: %.0fx real time, ambient %.1f°C, heater %.0f W\n",
+                emulatorConfig.speed, plantParams.ambientC, plantParams.heaterPowerW);
+
+    setup();
+
+    uint64_t lastUs = emulatorNowUs();
+    double nextTraceSec = 0.0;
+    for (;;) {
+        uint64_t nowUs = emulatorNowUs();
+        bool relayOn = emulatorPinLevel(EMU_PIN_RELAY) == HIGH;
+        thermalPlantStep(plantState, plantParams, static_cast<float>(nowUs - lastUs) / 1e6f, relayOn);
+        lastUs = nowUs;
+
+        double nowSec = static_cast<double>(nowUs) / 1e6;
+        if (emulatorConfig.traceEverySec > 0.0 && nowSec >= nextTraceSec) {
+            std::printf("plant: t=%8.0fs air=%6.2f°C probe=%6.2f°C relay=%s\n",
+                        nowSec, plantState.airC, plantState.sensorC, relayOn ? "ON" : "off");
+            nextTraceSec = nowSec + emulatorConfig.traceEverySec;
+        }
+        if (emulatorConfig.durationSec > 0.0 && nowSec >= emulatorConfig.durationSec) {
+            return 0;
+        }
+
+        loop();
+        // The device loop spins; on the host, give the CPU back between passes
+        emulatorSleepSimUs(0);
+    }
+}
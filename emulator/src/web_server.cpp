@@ -0,0 +1,334 @@
+/**
+ * web_server.cpp — POSIX-socket implementation of the emulated WebServer.
+ */
+
+#include <WebServer.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+#include "emulator_hal.h"
+
+namespace {
+
+constexpr size_t MAX_REQUEST_BYTES = 16384;
+constexpr int CLIENT_TIMEOUT_MS = 2000;
+
+const char* reasonPhrase(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 413: return "Payload Too Large";
+        case 415: return "Unsupported Media Type";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default:  return "Status";
+    }
+}
+
+HTTPMethod parseMethod(const std::string& m) {
+    if (m == "GET") return HTTP_GET;
+    if (m == "HEAD") return HTTP_HEAD;
+    if (m == "POST") return HTTP_POST;
+    if (m == "PUT") return HTTP_PUT;
+    if (m == "PATCH") return HTTP_PATCH;
+    if (m == "DELETE") return HTTP_DELETE;
+    if (m == "OPTIONS") return HTTP_OPTIONS;
+    return HTTP_ANY;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::string urlDecode(const std::string& in) {
+    std::string out;
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i] == '+') {
+            out += ' ';
+        } else if (in[i] == '%' && i + 2 < in.size() &&
+                   hexValue(in[i + 1]) >= 0 && hexValue(in[i + 2]) >= 0) {
+            out += static_cast<char>(hexValue(in[i + 1]) * 16 + hexValue(in[i + 2]));
+            i += 2;
+        } else {
+            out += in[i];
+        }
+    }
+    return out;
+}
+
+std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t");
+    size_t e = s.find_last_not_of(" \t\r");
+    return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
+
+WebServer::~WebServer() {
+    if (listenFd_ >= 0) ::close(listenFd_);
+}
+
+void WebServer::begin() {
+    int port = emulatorConfig.httpPort > 0 ? emulatorConfig.httpPort : port_;
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        Serial.printf("emulator: socket() failed: %s\n", std::strerror(errno));
+        std::exit(1);
+    }
+    int one = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (::inet_pton(AF_INET, emulatorConfig.bindAddress.c_str(), &addr.sin_addr) != 1) {
+        Serial.printf("emulator: invalid bind address '%s'\n", emulatorConfig.bindAddress.c_str());
+        std::exit(1);
+    }
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listenFd_, 16) < 0) {
+        Serial.printf("emulator: cannot listen on %s:%d: %s\n",
+                      emulatorConfig.bindAddress.c_str(), port, std::strerror(errno));
+        std::exit(1);
+    }
+    ::fcntl(listenFd_, F_SETFL, ::fcntl(listenFd_, F_GETFL, 0) | O_NONBLOCK);
+    Serial.printf("emulator: HTTP on %s:%d\n", emulatorConfig.bindAddress.c_str(), port);
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+    routes_.push_back(Route{uri.str(), method, fn, nullptr});
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn) {
+    // Multipart bodies are not parsed, so ufn only ever sees raw bodies
+    routes_.push_back(Route{uri.str(), method, fn, ufn});
+}
+
+void WebServer::collectHeaders(const char* headerKeys[], size_t headerKeysCount) {
+    collected_.clear();
+    for (size_t i = 0; i < headerKeysCount; ++i) collected_.push_back(headerKeys[i]);
+}
+
+void WebServer::handleClient() {
+    if (listenFd_ < 0) return;
+    sockaddr_in peer;
+    socklen_t peerLen = sizeof(peer);
+    int fd = ::accept(listenFd_, reinterpret_cast<sockaddr*>(&peer), &peerLen);
+    if (fd < 0) return;  // EAGAIN — nothing pending
+    client_.setRemoteIP(IPAddress(peer.sin_addr.s_addr));
+
+    timeval tv;
+    tv.tv_sec = CLIENT_TIMEOUT_MS / 1000;
+    tv.tv_usec = (CLIENT_TIMEOUT_MS % 1000) * 1000;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    clientFd_ = fd;
+    responded_ = false;
+    if (readRequest(fd)) {
+        dispatch();
+    } else {
+        send(400, "text/plain", "Bad Request");
+    }
+    ::close(fd);
+    clientFd_ = -1;
+}
+
+bool WebServer::readRequest(int fd) {
+    body_.clear();
+    std::string raw;
+    size_t headerEnd = std::string::npos;
+    char buf[2048];
+    while (headerEnd == std::string::npos) {
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0 || raw.size() > MAX_REQUEST_BYTES) return false;
+        raw.append(buf, static_cast<size_t>(n));
+        headerEnd = raw.find("\r\n\r\n");
+    }
+
+    // Request line
+    size_t lineEnd = raw.find("\r\n");
+    std::string requestLine = raw.substr(0, lineEnd);
+    size_t sp1 = requestLine.find(' ');
+    size_t sp2 = requestLine.find(' ', sp1 + 1);
+    if (sp1 == std::string::npos || sp2 == std::string::npos) return false;
+    method_ = parseMethod(requestLine.substr(0, sp1));
+    std::string target = requestLine.substr(sp1 + 1, sp2 - sp1 - 1);
+
+    // Query string
+    args_.clear();
+    size_t q = target.find('?');
+    uri_ = String(target.substr(0, q));
+    if (q != std::string::npos) {
+        std::string query = target.substr(q + 1);
+        size_t pos = 0;
+        while (pos <= query.size()) {
+            size_t amp = query.find('&', pos);
+            std::string pair = query.substr(pos, amp == std::string::npos ? std::string::npos : amp - pos);
+            if (!pair.empty()) {
+                size_t eq = pair.find('=');
+                args_.push_back(std::make_pair(urlDecode(pair.substr(0, eq)),
+                    eq == std::string::npos ? std::string() : urlDecode(pair.substr(eq + 1))));
+            }
+            if (amp == std::string::npos) break;
+            pos = amp + 1;
+        }
+    }
+
+    // Headers
+    headers_.clear();
+    size_t contentLength = 0;
+    size_t pos = lineEnd + 2;
+    while (pos < headerEnd) {
+        size_t eol = raw.find("\r\n", pos);
+        std::string line = raw.substr(pos, eol - pos);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string name = trim(line.substr(0, colon));
+            std::string value = trim(line.substr(colon + 1));
+            if (::strcasecmp(name.c_str(), "Content-Length") == 0) {
+                contentLength = static_cast<size_t>(std::strtoul(value.c_str(), nullptr, 10));
+            }
+            headers_.push_back(std::make_pair(name, value));
+        }
+        pos = eol + 2;
+    }
+    if (contentLength > MAX_REQUEST_BYTES) return false;
+
+    // Body
+    std::string body = raw.substr(headerEnd + 4);
+    while (body.size() < contentLength) {
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) return false;
+        body.append(buf, static_cast<size_t>(n));
+    }
+    body.resize(contentLength);
+    body_ = body;
+    return true;
+}
+
+void WebServer::streamRaw(const Route& r) {
+    raw_.status = RAW_START;
+    raw_.totalSize = 0;
+    raw_.currentSize = 0;
+    r.ufn();
+    raw_.status = RAW_WRITE;
+    while (raw_.totalSize < body_.size()) {
+        size_t n = std::min(body_.size() - raw_.totalSize, sizeof(raw_.buf));
+        std::memcpy(raw_.buf, body_.data() + raw_.totalSize, n);
+        raw_.currentSize = n;
+        raw_.totalSize += n;
+        r.ufn();
+    }
+    raw_.status = RAW_END;
+    raw_.currentSize = 0;
+    r.ufn();
+}
+
+void WebServer::dispatch() {
+    responseHeaders_.clear();
+    for (const Route& r : routes_) {
+        if (r.uri == uri_.str() && (r.method == HTTP_ANY || r.method == method_)) {
+            // Content-Type is read whether or not it was collected, as on the device
+            bool multipart = false;
+            for (const auto& h : headers_) {
+                if (::strcasecmp(h.first.c_str(), "Content-Type") == 0) {
+                    multipart = h.second.compare(0, 10, "multipart/") == 0;
+                }
+            }
+            if (r.ufn && method_ != HTTP_GET && !multipart) {
+                streamRaw(r);
+            } else if (!body_.empty()) {
+                // The device builds arg("plain") with String(char*), so it
+                // ends at the body's first zero byte
+                args_.push_back(std::make_pair(std::string("plain"),
+                                               std::string(body_.c_str())));
+            }
+            r.fn();
+            if (!responded_) send(500, "text/plain", "handler sent no response");
+            return;
+        }
+    }
+    send(404, "text/plain", String("Not found: ") + uri_);
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    if (clientFd_ < 0 || responded_) return;
+    responded_ = true;
+
+    std::string out = "HTTP/1.1 " + std::to_string(code) + " " + reasonPhrase(code) + "\r\n";
+    if (contentType) out += std::string("Content-Type: ") + contentType + "\r\n";
+    out += "Content-Length: " + std::to_string(content.length()) + "\r\n";
+    for (const auto& h : responseHeaders_) out += h.first + ": " + h.second + "\r\n";
+    out += "Connection: close\r\n\r\n";
+    if (method_ != HTTP_HEAD) out += content.str();
+    sendAll(clientFd_, out);
+    responseHeaders_.clear();
+}
+
+void WebServer::send_P(int code, const char* contentType, const char* content, size_t contentLength) {
+    // Binary-safe: the length is explicit, so zero bytes are sent as-is
+    send(code, contentType, String(std::string(content, contentLength)));
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    auto h = std::make_pair(name.str(), value.str());
+    if (first) {
+        responseHeaders_.insert(responseHeaders_.begin(), h);
+    } else {
+        responseHeaders_.push_back(h);
+    }
+}
+
+String WebServer::header(const String& name) const {
+    // Like the device, only headers registered with collectHeaders() are kept
+    bool collected = false;
+    for (const std::string& key : collected_) {
+        if (::strcasecmp(key.c_str(), name.c_str()) == 0) collected = true;
+    }
+    if (!collected) return String();
+    for (const auto& h : headers_) {
+        if (::strcasecmp(h.first.c_str(), name.c_str()) == 0) return String(h.second);
+    }
+    return String();
+}
+
+String WebServer::arg(const String& name) const {
+    for (const auto& a : args_) {
+        if (a.first == name.str()) return String(a.second);
+    }
+    return String();
+}
+
+bool WebServer::hasArg(const String& name) const {
+    for (const auto& a : args_) {
+        if (a.first == name.str()) return true;
+    }
+    return false;
+}
@@ -0,0 +1,92 @@
+/**
+ * wifi_udp.cpp — POSIX-socket implementation of the emulated WiFiUDP.
+ */
+
+#include <WiFiUdp.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "emulator_hal.h"
+
+WiFiUDP::~WiFiUDP() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+uint8_t WiFiUDP::begin(uint16_t port) {
+    if (emulatorConfig.coapPort > 0) port = static_cast<uint16_t>(emulatorConfig.coapPort);
+
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) {
+        Serial.printf("emulator: UDP socket() failed: %s\n", std::strerror(errno));
+        return 0;
+    }
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, emulatorConfig.bindAddress.c_str(), &addr.sin_addr) != 1 ||
+        ::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        Serial.printf("emulator: cannot bind UDP %s:%u: %s\n",
+                      emulatorConfig.bindAddress.c_str(), static_cast<unsigned>(port),
+                      std::strerror(errno));
+        ::close(fd_);
+        fd_ = -1;
+        return 0;
+    }
+    ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
+    Serial.printf("emulator: CoAP on udp://%s:%u\n", emulatorConfig.bindAddress.c_str(),
+                  static_cast<unsigned>(port));
+    return 1;
+}
+
+int WiFiUDP::parsePacket() {
+    rxLen_ = rxPos_ = 0;
+    if (fd_ < 0) return 0;
+    sockaddr_in peer;
+    socklen_t peerLen = sizeof(peer);
+    ssize_t n = ::recvfrom(fd_, rx_, sizeof(rx_), 0, reinterpret_cast<sockaddr*>(&peer), &peerLen);
+    if (n <= 0) return 0;   // EAGAIN — nothing pending
+    rxLen_ = static_cast<size_t>(n);
+    remoteIP_ = IPAddress(peer.sin_addr.s_addr);
+    remotePort_ = ntohs(peer.sin_port);
+    return static_cast<int>(n);
+}
+
+int WiFiUDP::read(uint8_t* buf, size_t len) {
+    size_t n = rxLen_ - rxPos_;
+    if (n > len) n = len;
+    std::memcpy(buf, rx_ + rxPos_, n);
+    rxPos_ += n;
+    return static_cast<int>(n);
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+    txIP_ = ip;
+    txPort_ = port;
+    txLen_ = 0;
+    return fd_ >= 0 ? 1 : 0;
+}
+
+size_t WiFiUDP::write(const uint8_t* buf, size_t len) {
+    size_t room = sizeof(tx_) - txLen_;
+    if (len > room) len = room;
+    std::memcpy(tx_ + txLen_, buf, len);
+    txLen_ += len;
+    return len;
+}
+
+int WiFiUDP::endPacket() {
+    if (fd_ < 0) return 0;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(txPort_);
+    addr.sin_addr.s_addr = static_cast<uint32_t>(txIP_);
+    ssize_t n = ::sendto(fd_, tx_, txLen_, 0, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    return n == static_cast<ssize_t>(txLen_) ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+/**
+ * admission_control.h — Rate limiting for the REST API and a time budget
+ * for network work on the loop task.
+ *
+ * handleClient() runs on the same task as the safety jobs, so a client (or
+ * a LAN scan) hammering port 8080 steals time from them. Two limits:
+ *
+ *   ClientRateLimiter  per-client-IP token bucket; over-limit requests get
+ *                      429 with Retry-After instead of a handler run.
+ *   TokenBucket        also used, in microseconds, as the network time
+ *                      budget: each network pass is charged what it used,
+ *                      and once the budget is overdrawn further passes
+ *                      are deferred (connections wait in the TCP backlog).
+ *
+ * Times are millis() values, wrap-safe. Pure logic, no allocation —
+ * testable on any host.
+ */
+
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include <cstdint>
+
+/**
+ * Token bucket holding up to `capacity` units, refilled at `refillPerSec`
+ * units per second. Units are whatever the caller charges: milli-requests
+ * for rate limiting, microseconds for a time budget.
+ */
+class TokenBucket {
+public:
+    TokenBucket() {}
+    TokenBucket(int32_t capacity, uint32_t refillPerSec, uint32_t nowMs = 0) {
+        configure(capacity, refillPerSec, nowMs);
+    }
+
+    /** Sets the limits and fills the bucket. */
+    void configure(int32_t capacity, uint32_t refillPerSec, uint32_t nowMs) {
+        capacity_ = capacity;
+        refillPerSec_ = refillPerSec;
+        level_ = capacity;
+        lastMs_ = nowMs;
+        remainder_ = 0;
+    }
+
+    /** Takes `cost` units if available; never overdraws. */
+    bool tryTake(uint32_t nowMs, int32_t cost) {
+        refill(nowMs);
+        if (level_ < cost) return false;
+        level_ -= cost;
+        return true;
+    }
+
+    /** Charges `cost` after the fact — may overdraw, which delays the next take. */
+    void charge(uint32_t nowMs, int32_t cost) {
+        refill(nowMs);
+        level_ -= cost;
+    }
+
+    int32_t level(uint32_t nowMs) {
+        refill(nowMs);
+        return level_;
+    }
+
+    /** Milliseconds until the level reaches `amount` (0 if it already has). */
+    uint32_t msUntil(uint32_t nowMs, int32_t amount) {
+        refill(nowMs);
+        if (level_ >= amount) return 0;
+        if (refillPerSec_ == 0) return UINT32_MAX;
+        uint64_t missing = static_cast<uint64_t>(static_cast<int64_t>(amount) - level_);
+        uint64_t ms = (missing * 1000 + refillPerSec_ - 1) / refillPerSec_;
+        return ms > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(ms);
+    }
+
+private:
+    void refill(uint32_t nowMs) {
+        uint32_t elapsed = nowMs - lastMs_;
+        lastMs_ = nowMs;
+        if (level_ >= capacity_) {
+            remainder_ = 0;
+            return;
+        }
+        // Carry the sub-unit remainder so slow refill rates are not rounded away
+        uint64_t scaled = static_cast<uint64_t>(elapsed) * refillPerSec_ + remainder_;
+        uint64_t add = scaled / 1000;
+        remainder_ = static_cast<uint32_t>(scaled % 1000);
+        uint64_t room = static_cast<uint64_t>(static_cast<int64_t>(capacity_) - level_);
+        if (add >= room) {
+            level_ = capacity_;
+            remainder_ = 0;
+        } else {
+            level_ += static_cast<int32_t>(add);
+        }
+    }
+
+    int32_t capacity_ = 0;
+    uint32_t refillPerSec_ = 0;
+    int32_t level_ = 0;
+    uint32_t lastMs_ = 0;
+    uint32_t remainder_ = 0;
+};
+
+struct AdmissionDecision {
+    bool admitted;
+    uint32_t retryAfterSec;   // For Retry-After when !admitted (≥ 1)
+};
+
+/**
+ * Per-client request limiter over a fixed table of N client slots keyed by
+ * IPv4 address. A new client takes a free slot or evicts the least recently
+ * seen one, starting with a full bucket.
+ */
+template <uint8_t N>
+class ClientRateLimiter {
+public:
+    static constexpr int32_t REQUEST_COST = 1000;   // Buckets count milli-requests
+
+    /** burst: requests allowed back-to-back; perSec: sustained request rate. */
+    ClientRateLimiter(uint16_t burst, uint16_t perSec)
+        : burst_(burst), perSec_(perSec) {}
+
+    /**
+     * Takes one request from the client's bucket. An exempt request — a
+     * validated heater OFF, which must never be refused — is admitted
+     * without taking or needing a token.
+     */
+    AdmissionDecision admit(uint32_t ip, uint32_t nowMs, bool exempt = false) {
+        Client& c = slotFor(ip, nowMs);
+        c.lastSeenMs = nowMs;
+        if (exempt || c.bucket.tryTake(nowMs, REQUEST_COST)) {
+            ++admitted_;
+            return AdmissionDecision{true, 0};
+        }
+        ++rejected_;
+        uint32_t waitMs = c.bucket.msUntil(nowMs, REQUEST_COST);
+        uint32_t sec = (waitMs + 999) / 1000;
+        return AdmissionDecision{false, sec > 0 ? sec : 1};
+    }
+
+    uint32_t admitted() const { return admitted_; }
+    uint32_t rejected() const { return rejected_; }
+    uint32_t evictions() const { return evictions_; }
+
+    uint8_t clients() const {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < N; ++i) n += clients_[i].used ? 1 : 0;
+        return n;
+    }
+
+private:
+    struct Client {
+        bool used = false;
+        uint32_t ip = 0;
+        uint32_t lastSeenMs = 0;
+        TokenBucket bucket;
+    };
+
+    Client& slotFor(uint32_t ip, uint32_t nowMs) {
+        Client* victim = &clients_[0];
+        for (uint8_t i = 0; i < N; ++i) {
+            Client& c = clients_[i];
+            if (c.used && c.ip == ip) return c;
+            if (!c.used) {
+                if (victim->used) victim = &c;
+            } else if (victim->used && nowMs - c.lastSeenMs > nowMs - victim->lastSeenMs) {
+                victim = &c;
+            }
+        }
+        if (victim->used) ++evictions_;
+        victim->used = true;
+        victim->ip = ip;
+        victim->bucket.configure(static_cast<int32_t>(burst_) * REQUEST_COST,
+                                 static_cast<uint32_t>(perSec_) * REQUEST_COST, nowMs);
+        return *victim;
+    }
+
+    uint16_t burst_;
+    uint16_t perSec_;
+    Client clients_[N];
+    uint32_t admitted_ = 0;
+    uint32_t rejected_ = 0;
+    uint32_t evictions_ = 0;
+};
+
+#endif // ADMISSION_CONTROL_H
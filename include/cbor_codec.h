@@ -0,0 +1,408 @@
+/**
+ * cbor_codec.h — CBOR (RFC 8949) encodings of the status and command
+ * documents, for REST clients that send Accept / Content-Type
+ * application/cbor.
+ *
+ * The schema is fixed and mirrors the JSON one field for field — same
+ * text keys, same nesting, null where JSON has null — so a generic CBOR
+ * decoder yields the same document as a JSON parser would. Numbers are
+ * binary, so nothing is formatted or parsed as text:
+ *
+ *   - Temperatures are rounded to 0.1 °C as in JSON, then written as the
+ *     shortest float that holds them exactly (half or single precision)
+ *   - Durations and counts are unsigned integers, flags are booleans
+ *
+ * The decoder accepts one definite-length map, the same keys as
+ * parseSessionCommand(), and any CBOR number where JSON takes one — or a
+ * boolean for "state". Unknown keys are skipped; indefinite lengths,
+ * duplicate keys and trailing bytes are malformed. Range and safety rules
+ * stay in validateSessionCommand(), shared with the JSON path.
+ *
+ * CborWriter and CborReader work in the caller's buffer — nothing is
+ * allocated. Pure logic with no hardware dependencies — testable on any host.
+ */
+
+#ifndef CBOR_CODEC_H
+#define CBOR_CODEC_H
+
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "session_command.h"
+#include "status_report.h"
+
+constexpr const char* CBOR_CONTENT_TYPE = "application/cbor";
+constexpr size_t STATUS_CBOR_SIZE = 256;
+constexpr uint8_t CBOR_MAX_DEPTH = 8;      // Nesting skipped inside unknown values
+
+namespace cbor_detail {
+
+constexpr uint8_t MAJOR_UINT = 0;
+constexpr uint8_t MAJOR_NINT = 1;
+constexpr uint8_t MAJOR_BYTES = 2;
+constexpr uint8_t MAJOR_TEXT = 3;
+constexpr uint8_t MAJOR_ARRAY = 4;
+constexpr uint8_t MAJOR_MAP = 5;
+constexpr uint8_t MAJOR_TAG = 6;
+constexpr uint8_t MAJOR_SIMPLE = 7;
+
+constexpr uint8_t SIMPLE_FALSE = 20;
+constexpr uint8_t SIMPLE_TRUE = 21;
+constexpr uint8_t SIMPLE_NULL = 22;
+constexpr uint8_t FLOAT_HALF = 25;
+constexpr uint8_t FLOAT_SINGLE = 26;
+constexpr uint8_t FLOAT_DOUBLE = 27;
+
+/** Half-precision bits for f when that is exact; false if it needs more. */
+inline bool floatToHalf(float f, uint16_t& h) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    int32_t exp = static_cast<int32_t>((bits >> 23) & 0xFF) - 127;
+    uint32_t mant = bits & 0x7FFFFF;
+    if (std::isnan(f)) { h = 0x7E00; return true; }
+    if (std::isinf(f)) { h = sign | 0x7C00; return true; }
+    if (f == 0.0f) { h = sign; return true; }
+    if (exp >= -14 && exp <= 15) {
+        if (mant & 0x1FFF) return false;
+        h = static_cast<uint16_t>(sign | ((exp + 15) << 10) | (mant >> 13));
+        return true;
+    }
+    if (exp >= -24 && exp < -14) {
+        // Subnormal half: f = m × 2^-24
+        uint32_t full = mant | 0x800000;
+        int32_t shift = -exp - 1;
+        if (full & ((1u << shift) - 1)) return false;
+        h = static_cast<uint16_t>(sign | (full >> shift));
+        return true;
+    }
+    return false;
+}
+
+inline float halfToFloat(uint16_t h) {
+    int32_t exp = (h >> 10) & 0x1F;
+    int32_t mant = h & 0x3FF;
+    float v;
+    if (exp == 0) v = std::ldexp(static_cast<float>(mant), -24);
+    else if (exp == 31) v = mant ? NAN : INFINITY;
+    else v = std::ldexp(static_cast<float>(mant + 1024), exp - 25);
+    return (h & 0x8000) ? -v : v;
+}
+
+/** Rounds to the 0.1 °C the JSON renders. */
+inline float tenths(float c) {
+    return std::round(c * 10.0f) / 10.0f;
+}
+
+}  // namespace cbor_detail
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+/**
+ * Appends CBOR items to a fixed buffer. An item that does not fit marks
+ * the writer failed and length() returns 0, so callers check once at the end.
+ */
+class CborWriter {
+public:
+    CborWriter(uint8_t* buf, size_t cap) : buf_(buf), cap_(cap) {}
+
+    void beginMap(size_t pairs) { head(cbor_detail::MAJOR_MAP, pairs); }
+    void beginArray(size_t items) { head(cbor_detail::MAJOR_ARRAY, items); }
+    void unsignedInt(uint64_t v) { head(cbor_detail::MAJOR_UINT, v); }
+    void boolean(bool b) { put(0xE0 | (b ? cbor_detail::SIMPLE_TRUE : cbor_detail::SIMPLE_FALSE)); }
+    void null() { put(0xE0 | cbor_detail::SIMPLE_NULL); }
+
+    void text(const char* s) {
+        size_t n = std::strlen(s);
+        head(cbor_detail::MAJOR_TEXT, n);
+        bytes(s, n);
+    }
+
+    /** The shortest float that holds f exactly: half, else single precision. */
+    void number(float f) {
+        uint16_t h;
+        if (cbor_detail::floatToHalf(f, h)) {
+            put(0xE0 | cbor_detail::FLOAT_HALF);
+            put(static_cast<uint8_t>(h >> 8));
+            put(static_cast<uint8_t>(h));
+            return;
+        }
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        put(0xE0 | cbor_detail::FLOAT_SINGLE);
+        for (int shift = 24; shift >= 0; shift -= 8) put(static_cast<uint8_t>(bits >> shift));
+    }
+
+    bool ok() const { return ok_; }
+    size_t length() const { return ok_ ? len_ : 0; }
+
+private:
+    void put(uint8_t b) {
+        if (len_ >= cap_) {
+            ok_ = false;
+            return;
+        }
+        buf_[len_++] = b;
+    }
+
+    void bytes(const char* s, size_t n) {
+        if (n > cap_ - len_) {
+            ok_ = false;
+            return;
+        }
+        std::memcpy(buf_ + len_, s, n);
+        len_ += n;
+    }
+
+    /** Initial byte and argument in the shortest form. */
+    void head(uint8_t major, uint64_t arg) {
+        uint8_t mt = static_cast<uint8_t>(major << 5);
+        if (arg < 24) {
+            put(static_cast<uint8_t>(mt | arg));
+        } else if (arg <= 0xFF) {
+            put(mt | 24);
+            put(static_cast<uint8_t>(arg));
+        } else if (arg <= 0xFFFF) {
+            put(mt | 25);
+            put(static_cast<uint8_t>(arg >> 8));
+            put(static_cast<uint8_t>(arg));
+        } else if (arg <= 0xFFFFFFFFu) {
+            put(mt | 26);
+            for (int shift = 24; shift >= 0; shift -= 8) put(static_cast<uint8_t>(arg >> shift));
+        } else {
+            put(mt | 27);
+            for (int shift = 56; shift >= 0; shift -= 8) put(static_cast<uint8_t>(arg >> shift));
+        }
+    }
+
+    uint8_t* buf_;
+    size_t cap_;
+    size_t len_ = 0;
+    bool ok_ = true;
+};
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+/** Walks definite-length CBOR items in place. Every read fails cleanly at the end of input. */
+class CborReader {
+public:
+    CborReader(const uint8_t* data, size_t len) : p_(data), end_(data + len) {}
+
+    bool atEnd() const { return p_ == end_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+
+    /**
+     * Reads an initial byte and its argument. For major type 7, info is the
+     * simple value or float width and arg holds the float's bits.
+     */
+    bool readHead(uint8_t& major, uint8_t& info, uint64_t& arg) {
+        if (p_ >= end_) return false;
+        uint8_t b = *p_++;
+        major = b >> 5;
+        info = b & 0x1F;
+        if (info < 24) {
+            arg = info;
+            return true;
+        }
+        if (info > 27) return false;    // Reserved, or indefinite length
+        size_t n = static_cast<size_t>(1) << (info - 24);
+        if (static_cast<size_t>(end_ - p_) < n) return false;
+        arg = 0;
+        for (size_t i = 0; i < n; ++i) arg = arg << 8 | *p_++;
+        return true;
+    }
+
+    bool readText(const char*& s, size_t& n) {
+        uint8_t major, info;
+        uint64_t arg;
+        if (!readHead(major, info, arg) || major != cbor_detail::MAJOR_TEXT) return false;
+        if (arg > static_cast<uint64_t>(end_ - p_)) return false;
+        s = reinterpret_cast<const char*>(p_);
+        n = static_cast<size_t>(arg);
+        p_ += n;
+        return true;
+    }
+
+    /** Skips one complete item, nested at most CBOR_MAX_DEPTH deep. */
+    bool skip(uint8_t depth = 0) {
+        if (depth > CBOR_MAX_DEPTH) return false;
+        uint8_t major, info;
+        uint64_t arg;
+        if (!readHead(major, info, arg)) return false;
+        switch (major) {
+            case cbor_detail::MAJOR_BYTES:
+            case cbor_detail::MAJOR_TEXT:
+                if (arg > static_cast<uint64_t>(end_ - p_)) return false;
+                p_ += arg;
+                return true;
+            case cbor_detail::MAJOR_ARRAY:
+            case cbor_detail::MAJOR_MAP: {
+                uint64_t items = major == cbor_detail::MAJOR_MAP ? arg * 2 : arg;
+                if (items > static_cast<uint64_t>(end_ - p_)) return false;  // Each item is at least a byte
+                for (uint64_t i = 0; i < items; ++i) {
+                    if (!skip(static_cast<uint8_t>(depth + 1))) return false;
+                }
+                return true;
+            }
+            case cbor_detail::MAJOR_TAG:
+                return skip(static_cast<uint8_t>(depth + 1));
+            default:
+                return true;
+        }
+    }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+/** A number from a head already read: integers and all three float widths. */
+inline bool cborNumber(uint8_t major, uint8_t info, uint64_t arg, float& out) {
+    switch (major) {
+        case cbor_detail::MAJOR_UINT:
+            out = static_cast<float>(arg);
+            return true;
+        case cbor_detail::MAJOR_NINT:
+            out = -1.0f - static_cast<float>(arg);
+            return true;
+        case cbor_detail::MAJOR_SIMPLE:
+            if (info == cbor_detail::FLOAT_HALF) {
+                out = cbor_detail::halfToFloat(static_cast<uint16_t>(arg));
+                return true;
+            }
+            if (info == cbor_detail::FLOAT_SINGLE) {
+                uint32_t bits = static_cast<uint32_t>(arg);
+                std::memcpy(&out, &bits, sizeof(out));
+                return true;
+            }
+            if (info == cbor_detail::FLOAT_DOUBLE) {
+                double d;
+                std::memcpy(&d, &arg, sizeof(d));
+                out = static_cast<float>(d);
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+// =============================================================================
+// Documents
+// =============================================================================
+
+/** GET /status as CBOR — the fields of formatStatusJson(). Returns the length, 0 if it did not fit. */
+inline size_t encodeStatusCbor(const StatusReport& s, uint8_t* buf, size_t cap) {
+    using cbor_detail::tenths;
+    CborWriter w(buf, cap);
+    w.beginMap(6);
+    w.text("current_temp");
+    w.number(tenths(s.currentC));
+    w.text("target_temp");
+    w.number(tenths(s.targetC));
+    w.text("heating");
+    w.boolean(s.heating);
+    w.text("firmware");
+    w.text(s.firmware);
+    w.text("profile");
+    if (s.profileRunning) {
+        w.beginMap(5);
+        w.text("segment");
+        w.unsignedInt(s.segment);
+        w.text("segments");
+        w.unsignedInt(s.segments);
+        w.text("phase");
+        w.text(profilePhaseName(s.phase));
+        w.text("segment_remaining_s");
+        w.unsignedInt(s.segmentRemainingS);
+        w.text("remaining_s");
+        w.unsignedInt(s.remainingS);
+    } else {
+        w.null();
+    }
+    uint8_t probes = s.probeCount < VOTE_MAX_PROBES ? s.probeCount : VOTE_MAX_PROBES;
+    w.text("probes");
+    w.beginArray(probes);
+    for (uint8_t i = 0; i < probes; ++i) {
+        w.beginMap(3);
+        w.text("c");
+        if (isSensorFault(s.probes[i].c)) w.null();
+        else w.number(tenths(s.probes[i].c));
+        w.text("dev");
+        w.number(tenths(s.probes[i].dev));
+        w.text("state");
+        w.text(probeStateName(s.probes[i].state));
+    }
+    return w.length();
+}
+
+/** {"ok": true} — the CBOR form of the single-field command acknowledgement. */
+inline size_t encodeOkCbor(uint8_t* buf, size_t cap) {
+    CborWriter w(buf, cap);
+    w.beginMap(1);
+    w.text("ok");
+    w.boolean(true);
+    return w.length();
+}
+
+/**
+ * Parses "state" and "temperature" from a CBOR map — the counterpart of
+ * parseSessionCommand(). Only syntax and types are checked here.
+ */
+inline SessionCommandResult parseSessionCommandCbor(const uint8_t* body, size_t len,
+                                                    SessionCommand& cmd) {
+    CborReader r(body, len);
+    uint8_t major, info;
+    uint64_t pairs;
+    if (!r.readHead(major, info, pairs) || major != cbor_detail::MAJOR_MAP) {
+        return SessionCommandResult::MalformedCbor;
+    }
+    for (uint64_t i = 0; i < pairs; ++i) {
+        const char* key;
+        size_t keyLen;
+        if (!r.readText(key, keyLen)) return SessionCommandResult::MalformedCbor;
+
+        bool isState = keyLen == 5 && std::memcmp(key, "state", 5) == 0;
+        bool isTemperature = keyLen == 11 && std::memcmp(key, "temperature", 11) == 0;
+        if (!isState && !isTemperature) {
+            if (!r.skip()) return SessionCommandResult::MalformedCbor;
+            continue;
+        }
+
+        uint64_t arg;
+        if (!r.readHead(major, info, arg)) return SessionCommandResult::MalformedCbor;
+        if (isState) {
+            if (cmd.hasState) return SessionCommandResult::MalformedCbor;
+            if (major == cbor_detail::MAJOR_UINT && arg <= INT_MAX) {
+                cmd.state = static_cast<int>(arg);
+            } else if (major == cbor_detail::MAJOR_NINT && arg < INT_MAX) {
+                cmd.state = -1 - static_cast<int>(arg);
+            } else if (major == cbor_detail::MAJOR_SIMPLE &&
+                       (info == cbor_detail::SIMPLE_FALSE || info == cbor_detail::SIMPLE_TRUE)) {
+                cmd.state = info == cbor_detail::SIMPLE_TRUE ? 1 : 0;
+            } else {
+                return SessionCommandResult::InvalidState;
+            }
+            cmd.hasState = true;
+        } else {
+            if (cmd.hasTemperature) return SessionCommandResult::MalformedCbor;
+            if (!cborNumber(major, info, arg, cmd.temperature)) {
+                return SessionCommandResult::InvalidTemperature;
+            }
+            cmd.hasTemperature = true;
+        }
+    }
+    if (!r.atEnd()) return SessionCommandResult::MalformedCbor;
+
+    if (!cmd.hasState && !cmd.hasTemperature) return SessionCommandResult::NoFields;
+    return SessionCommandResult::Ok;
+}
+
+#endif // CBOR_CODEC_H
@@ -0,0 +1,440 @@
+/**
+ * coap_codec.h — Minimal CoAP (RFC 7252) message codec and Observe
+ * (RFC 7641) registry for the UDP control endpoint on port 5683.
+ *
+ * One datagram per request and no connection setup, so a panel or an
+ * automation gets a reply in one LAN round trip instead of a TCP handshake
+ * plus a blocking WebServer slot. Only what the endpoint needs:
+ *
+ *   - Header, token (0–8 bytes), options with extended delta/length, payload
+ *   - Options: Observe, Uri-Path, Content-Format, Max-Age, Accept
+ *   - Unknown critical (odd-numbered) options are reported, elective ones skipped
+ *
+ * Messages decode into CoapMessage, whose payload and path point into the
+ * caller's datagram buffer — nothing is allocated. Resources and command
+ * handling stay in the firmware; this file is pure and host-testable.
+ */
+
+#ifndef COAP_CODEC_H
+#define COAP_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+constexpr uint16_t COAP_PORT = 5683;
+constexpr uint8_t COAP_VERSION = 1;
+constexpr uint8_t COAP_MAX_TOKEN = 8;
+constexpr size_t COAP_MAX_PATH = 32;          // Joined Uri-Path, e.g. "status"
+constexpr size_t COAP_MAX_DATAGRAM = 448;     // Status JSON + header and options
+
+enum class CoapType : uint8_t {
+    Confirmable = 0,
+    NonConfirmable = 1,
+    Acknowledgement = 2,
+    Reset = 3,
+};
+
+// Codes are class << 5 | detail, written c.dd in the RFC
+constexpr uint8_t coapCode(uint8_t cls, uint8_t detail) {
+    return static_cast<uint8_t>((cls << 5) | detail);
+}
+constexpr uint8_t COAP_EMPTY               = 0;
+constexpr uint8_t COAP_GET                 = coapCode(0, 1);
+constexpr uint8_t COAP_POST                = coapCode(0, 2);
+constexpr uint8_t COAP_PUT                 = coapCode(0, 3);
+constexpr uint8_t COAP_CHANGED             = coapCode(2, 4);
+constexpr uint8_t COAP_CONTENT             = coapCode(2, 5);
+constexpr uint8_t COAP_BAD_REQUEST         = coapCode(4, 0);
+constexpr uint8_t COAP_BAD_OPTION          = coapCode(4, 2);
+constexpr uint8_t COAP_NOT_FOUND           = coapCode(4, 4);
+constexpr uint8_t COAP_METHOD_NOT_ALLOWED  = coapCode(4, 5);
+constexpr uint8_t COAP_UNSUPPORTED_FORMAT  = coapCode(4, 15);
+constexpr uint8_t COAP_SERVICE_UNAVAILABLE = coapCode(5, 3);
+
+constexpr uint16_t COAP_OPTION_OBSERVE        = 6;
+constexpr uint16_t COAP_OPTION_URI_PATH       = 11;
+constexpr uint16_t COAP_OPTION_CONTENT_FORMAT = 12;
+constexpr uint16_t COAP_OPTION_MAX_AGE        = 14;
+constexpr uint16_t COAP_OPTION_ACCEPT         = 17;
+
+constexpr uint16_t COAP_FORMAT_TEXT = 0;
+constexpr uint16_t COAP_FORMAT_JSON = 50;
+constexpr uint16_t COAP_FORMAT_NONE = 0xFFFF;  // Option absent
+
+/** Maps a REST status code onto the CoAP response code the endpoint uses. */
+inline uint8_t coapCodeForHttpStatus(int status) {
+    switch (status) {
+        case 200: return COAP_CHANGED;
+        case 400: return COAP_BAD_REQUEST;
+        case 404: return COAP_NOT_FOUND;
+        case 415: return COAP_UNSUPPORTED_FORMAT;
+        case 429:
+        case 503: return COAP_SERVICE_UNAVAILABLE;
+        default:  return coapCode(5, 0);
+    }
+}
+
+struct CoapMessage {
+    CoapType type = CoapType::Confirmable;
+    uint8_t code = COAP_EMPTY;
+    uint16_t messageId = 0;
+    uint8_t token[COAP_MAX_TOKEN] = {};
+    uint8_t tokenLen = 0;
+    bool hasObserve = false;
+    uint32_t observe = 0;                       // 24-bit; 0 = register, 1 = deregister
+    char path[COAP_MAX_PATH + 1] = "";          // Uri-Path segments joined with '/'
+    uint16_t contentFormat = COAP_FORMAT_NONE;
+    uint16_t accept = COAP_FORMAT_NONE;
+    bool hasMaxAge = false;
+    uint32_t maxAge = 0;
+    const uint8_t* payload = nullptr;
+    size_t payloadLen = 0;
+};
+
+enum class CoapParseResult : uint8_t {
+    Ok,
+    TooShort,
+    BadVersion,
+    BadTokenLength,
+    BadOption,             // Truncated option, reserved nibble 15, or bad marker
+    UnknownCriticalOption, // Message is well formed — answer 4.02 Bad Option
+    PathTooLong,
+};
+
+namespace coap_detail {
+
+/** Reads an extended option delta/length nibble. Returns false if truncated or reserved. */
+inline bool readExtended(uint8_t nibble, const uint8_t*& p, const uint8_t* end, uint32_t& out) {
+    if (nibble < 13) {
+        out = nibble;
+    } else if (nibble == 13) {
+        if (end - p < 1) return false;
+        out = 13u + p[0];
+        p += 1;
+    } else if (nibble == 14) {
+        if (end - p < 2) return false;
+        out = 269u + (static_cast<uint32_t>(p[0]) << 8 | p[1]);
+        p += 2;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline uint32_t readUint(const uint8_t* p, uint32_t len) {
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < len; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+inline size_t uintLength(uint32_t v) {
+    size_t n = 0;
+    while (v) {
+        ++n;
+        v >>= 8;
+    }
+    return n;
+}
+
+/** Appends one option; prev tracks the last option number for delta encoding. */
+inline bool writeOption(uint8_t*& p, const uint8_t* end, uint16_t& prev, uint16_t number,
+                        const uint8_t* value, size_t len) {
+    uint32_t delta = number - prev;
+    prev = number;
+    uint8_t ext[4];
+    size_t extLen = 0;
+    uint8_t dn, ln;
+    if (delta < 13) {
+        dn = static_cast<uint8_t>(delta);
+    } else if (delta < 269) {
+        dn = 13;
+        ext[extLen++] = static_cast<uint8_t>(delta - 13);
+    } else {
+        dn = 14;
+        ext[extLen++] = static_cast<uint8_t>((delta - 269) >> 8);
+        ext[extLen++] = static_cast<uint8_t>(delta - 269);
+    }
+    if (len < 13) {
+        ln = static_cast<uint8_t>(len);
+    } else if (len < 269) {
+        ln = 13;
+        ext[extLen++] = static_cast<uint8_t>(len - 13);
+    } else {
+        return false;   // Longer values are never written by this endpoint
+    }
+    if (static_cast<size_t>(end - p) < 1 + extLen + len) return false;
+    *p++ = static_cast<uint8_t>(dn << 4 | ln);
+    std::memcpy(p, ext, extLen);
+    p += extLen;
+    if (len) std::memcpy(p, value, len);
+    p += len;
+    return true;
+}
+
+inline bool writeUintOption(uint8_t*& p, const uint8_t* end, uint16_t& prev, uint16_t number,
+                            uint32_t v) {
+    size_t len = uintLength(v);
+    uint8_t bytes[4];
+    for (size_t i = 0; i < len; ++i) bytes[i] = static_cast<uint8_t>(v >> (8 * (len - 1 - i)));
+    return writeOption(p, end, prev, number, bytes, len);
+}
+
+} // namespace coap_detail
+
+/** Decodes one datagram. On error `out` holds whatever was parsed so far (header, token). */
+inline CoapParseResult parseCoap(const uint8_t* buf, size_t len, CoapMessage& out) {
+    out = CoapMessage();
+    if (len < 4) return CoapParseResult::TooShort;
+    if ((buf[0] >> 6) != COAP_VERSION) return CoapParseResult::BadVersion;
+    out.type = static_cast<CoapType>((buf[0] >> 4) & 0x03);
+    out.tokenLen = buf[0] & 0x0F;
+    out.code = buf[1];
+    out.messageId = static_cast<uint16_t>(buf[2] << 8 | buf[3]);
+    if (out.tokenLen > COAP_MAX_TOKEN) return CoapParseResult::BadTokenLength;
+    if (len < 4u + out.tokenLen) return CoapParseResult::TooShort;
+    std::memcpy(out.token, buf + 4, out.tokenLen);
+
+    const uint8_t* p = buf + 4 + out.tokenLen;
+    const uint8_t* end = buf + len;
+    uint32_t number = 0;
+    size_t pathLen = 0;
+    bool unknownCritical = false;
+    while (p < end) {
+        if (*p == 0xFF) {
+            ++p;
+            if (p == end) return CoapParseResult::BadOption;   // Marker with no payload
+            out.payload = p;
+            out.payloadLen = static_cast<size_t>(end - p);
+            break;
+        }
+        uint8_t dn = *p >> 4;
+        uint8_t ln = *p & 0x0F;
+        ++p;
+        uint32_t delta, optLen;
+        if (!coap_detail::readExtended(dn, p, end, delta)) return CoapParseResult::BadOption;
+        if (!coap_detail::readExtended(ln, p, end, optLen)) return CoapParseResult::BadOption;
+        if (static_cast<uint32_t>(end - p) < optLen) return CoapParseResult::BadOption;
+        number += delta;
+
+        switch (number) {
+            case COAP_OPTION_OBSERVE:
+                if (optLen > 3) return CoapParseResult::BadOption;
+                out.hasObserve = true;
+                out.observe = coap_detail::readUint(p, optLen);
+                break;
+            case COAP_OPTION_URI_PATH:
+                if (pathLen + (pathLen ? 1 : 0) + optLen > COAP_MAX_PATH) return CoapParseResult::PathTooLong;
+                if (pathLen) out.path[pathLen++] = '/';
+                std::memcpy(out.path + pathLen, p, optLen);
+                pathLen += optLen;
+                out.path[pathLen] = '\0';
+                break;
+            case COAP_OPTION_CONTENT_FORMAT:
+                if (optLen > 2) return CoapParseResult::BadOption;
+                out.contentFormat = static_cast<uint16_t>(coap_detail::readUint(p, optLen));
+                break;
+            case COAP_OPTION_ACCEPT:
+                if (optLen > 2) return CoapParseResult::BadOption;
+                out.accept = static_cast<uint16_t>(coap_detail::readUint(p, optLen));
+                break;
+            case COAP_OPTION_MAX_AGE:
+                if (optLen > 4) return CoapParseResult::BadOption;
+                out.hasMaxAge = true;
+                out.maxAge = coap_detail::readUint(p, optLen);
+                break;
+            default:
+                if (number & 1) unknownCritical = true;   // Odd = critical
+                break;
+        }
+        p += optLen;
+    }
+    return unknownCritical ? CoapParseResult::UnknownCriticalOption : CoapParseResult::Ok;
+}
+
+/**
+ * Encodes a message. Options written: Observe, Uri-Path (single segment),
+ * Content-Format, Max-Age. Returns the datagram length, or 0 if it does
+ * not fit in `cap`.
+ */
+inline size_t encodeCoap(const CoapMessage& m, uint8_t* buf, size_t cap) {
+    if (m.tokenLen > COAP_MAX_TOKEN) return 0;
+    if (cap < 4u + m.tokenLen) return 0;
+    buf[0] = static_cast<uint8_t>(COAP_VERSION << 6 | static_cast<uint8_t>(m.type) << 4 | m.tokenLen);
+    buf[1] = m.code;
+    buf[2] = static_cast<uint8_t>(m.messageId >> 8);
+    buf[3] = static_cast<uint8_t>(m.messageId);
+    std::memcpy(buf + 4, m.token, m.tokenLen);
+
+    uint8_t* p = buf + 4 + m.tokenLen;
+    const uint8_t* end = buf + cap;
+    uint16_t prev = 0;
+    if (m.hasObserve &&
+        !coap_detail::writeUintOption(p, end, prev, COAP_OPTION_OBSERVE, m.observe & 0xFFFFFF)) {
+        return 0;
+    }
+    size_t pathLen = std::strlen(m.path);
+    if (pathLen && !coap_detail::writeOption(p, end, prev, COAP_OPTION_URI_PATH,
+                                             reinterpret_cast<const uint8_t*>(m.path), pathLen)) {
+        return 0;
+    }
+    if (m.contentFormat != COAP_FORMAT_NONE &&
+        !coap_detail::writeUintOption(p, end, prev, COAP_OPTION_CONTENT_FORMAT, m.contentFormat)) {
+        return 0;
+    }
+    if (m.hasMaxAge && !coap_detail::writeUintOption(p, end, prev, COAP_OPTION_MAX_AGE, m.maxAge)) {
+        return 0;
+    }
+    if (m.payloadLen) {
+        if (static_cast<size_t>(end - p) < 1 + m.payloadLen) return 0;
+        *p++ = 0xFF;
+        std::memcpy(p, m.payload, m.payloadLen);
+        p += m.payloadLen;
+    }
+    return static_cast<size_t>(p - buf);
+}
+
+/**
+ * Response skeleton for a request: piggybacked ACK for a CON request
+ * (same message id), NON with `newMessageId` for a NON request. The token
+ * is echoed as the RFC requires.
+ */
+inline CoapMessage coapResponseTo(const CoapMessage& req, uint8_t code, uint16_t newMessageId) {
+    CoapMessage r;
+    bool con = req.type == CoapType::Confirmable;
+    r.type = con ? CoapType::Acknowledgement : CoapType::NonConfirmable;
+    r.messageId = con ? req.messageId : newMessageId;
+    r.code = code;
+    r.tokenLen = req.tokenLen;
+    std::memcpy(r.token, req.token, req.tokenLen);
+    return r;
+}
+
+/** RST for a CON message we cannot process (format errors). Empty, no token. */
+inline CoapMessage coapReset(uint16_t messageId) {
+    CoapMessage r;
+    r.type = CoapType::Reset;
+    r.messageId = messageId;
+    return r;
+}
+
+// =============================================================================
+// Observe registry
+// =============================================================================
+
+constexpr uint32_t COAP_OBSERVE_CON_INTERVAL_MS = 30000;   // Liveness probe period
+
+enum class CoapNotifyKind : uint8_t {
+    NonConfirmable,
+    Confirmable,   // Liveness probe — the observer must ACK before the next one
+    Dropped,       // Previous probe never ACKed; the slot has been freed
+};
+
+struct CoapObserver {
+    bool used = false;
+    uint32_t ip = 0;
+    uint16_t port = 0;
+    uint8_t token[COAP_MAX_TOKEN] = {};
+    uint8_t tokenLen = 0;
+    uint32_t lastConMs = 0;
+    uint16_t pendingMid = 0;
+    bool conPending = false;
+};
+
+/**
+ * Up to N observers of the one observable resource, keyed by endpoint
+ * (ip, port) — a repeat registration from the same endpoint replaces its
+ * token. Notifications are NON; every COAP_OBSERVE_CON_INTERVAL_MS one is
+ * sent CON instead, and an observer that has not ACKed the previous CON by
+ * then (or answered any notification with RST) is dropped.
+ */
+template <uint8_t N>
+class CoapObservers {
+public:
+    /** Registers (or re-registers). Returns false when the table is full. */
+    bool add(uint32_t ip, uint16_t port, const uint8_t* token, uint8_t tokenLen, uint32_t nowMs) {
+        CoapObserver* slot = find(ip, port);
+        if (!slot) {
+            for (uint8_t i = 0; i < N && !slot; ++i) {
+                if (!observers_[i].used) slot = &observers_[i];
+            }
+        }
+        if (!slot) return false;
+        slot->used = true;
+        slot->ip = ip;
+        slot->port = port;
+        slot->tokenLen = tokenLen > COAP_MAX_TOKEN ? COAP_MAX_TOKEN : tokenLen;
+        std::memcpy(slot->token, token, slot->tokenLen);
+        slot->lastConMs = nowMs;
+        slot->conPending = false;
+        return true;
+    }
+
+    bool remove(uint32_t ip, uint16_t port) {
+        CoapObserver* slot = find(ip, port);
+        if (!slot) return false;
+        slot->used = false;
+        return true;
+    }
+
+    /** An ACK or RST from ip:port for message `mid`. RST deregisters. */
+    void acknowledge(uint32_t ip, uint16_t port, uint16_t mid, bool reset) {
+        CoapObserver* slot = find(ip, port);
+        if (!slot) return;
+        if (reset) {
+            slot->used = false;
+        } else if (slot->conPending && slot->pendingMid == mid) {
+            slot->conPending = false;
+        }
+    }
+
+    /**
+     * Decides how to send the next notification to slot i, whose message
+     * will carry `mid`. Call only for used slots.
+     */
+    CoapNotifyKind beginNotify(uint8_t i, uint32_t nowMs, uint16_t mid) {
+        CoapObserver& o = observers_[i];
+        if (nowMs - o.lastConMs < COAP_OBSERVE_CON_INTERVAL_MS) return CoapNotifyKind::NonConfirmable;
+        if (o.conPending) {
+            o.used = false;
+            ++dropped_;
+            return CoapNotifyKind::Dropped;
+        }
+        o.conPending = true;
+        o.pendingMid = mid;
+        o.lastConMs = nowMs;
+        return CoapNotifyKind::Confirmable;
+    }
+
+    /** Observe sequence number for the next notification (24-bit, increasing). */
+    uint32_t nextSequence() {
+        sequence_ = (sequence_ + 1) & 0xFFFFFF;
+        return sequence_;
+    }
+
+    const CoapObserver& at(uint8_t i) const { return observers_[i]; }
+    static constexpr uint8_t capacity() { return N; }
+    uint32_t dropped() const { return dropped_; }
+
+    uint8_t count() const {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < N; ++i) n += observers_[i].used ? 1 : 0;
+        return n;
+    }
+
+private:
+    CoapObserver* find(uint32_t ip, uint16_t port) {
+        for (uint8_t i = 0; i < N; ++i) {
+            if (observers_[i].used && observers_[i].ip == ip && observers_[i].port == port) {
+                return &observers_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    CoapObserver observers_[N];
+    uint32_t sequence_ = 1;
+    uint32_t dropped_ = 0;
+};
+
+#endif // COAP_CODEC_H
@@ -0,0 +1,144 @@
+/**
+ * deadline_scheduler.h — Fixed-table deadline scheduler for the main loop.
+ *
+ * Each job (DS18B20 conversion request, conversion read, session-expiry
+ * check, network servicing) arms its own next deadline instead of the loop
+ * re-checking elapsed time on every pass. The loop runs whatever is due and
+ * then yields until the earliest armed deadline, so an idle controller
+ * sleeps instead of spinning a core.
+ *
+ * Ordering: among jobs that are due, the lowest id runs first — give safety
+ * jobs the lowest ids. The loop never sleeps past an armed deadline, so a
+ * job's lateness is bounded by the work that ran before it; every job
+ * records its worst lateness, and lateness beyond the job's budget counts
+ * as an overrun.
+ *
+ * Times are millis() values; comparisons are wrap-safe for deadlines less
+ * than ~24 days away. Single-threaded, no allocation.
+ * Hardware-independent — testable on any host with a fake clock.
+ */
+
+#ifndef DEADLINE_SCHEDULER_H
+#define DEADLINE_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct SchedulerJobStats {
+    uint32_t runs = 0;
+    uint32_t lastLatenessMs = 0;  // Run time − deadline of the most recent run
+    uint32_t maxLatenessMs = 0;   // Worst lateness since last resetMaxima()
+    uint32_t overruns = 0;        // Runs later than the job's latency budget
+};
+
+struct SchedulerWakeStats {
+    uint32_t sleeps = 0;          // Times the loop yielded
+    uint32_t sleptMs = 0;         // Total time spent yielded
+    uint32_t earlyWakes = 0;      // Woke before the requested sleep elapsed
+    uint32_t lateWakes = 0;       // Overslept the requested sleep
+};
+
+template<uint8_t N>
+class DeadlineScheduler {
+public:
+    static constexpr int NONE = -1;
+
+    /** Sets a job's latency budget in ms (0 = best effort, never an overrun). */
+    void setBudget(uint8_t id, uint32_t budgetMs) {
+        if (id < N) jobs_[id].budgetMs = budgetMs;
+    }
+
+    void arm(uint8_t id, uint32_t deadlineMs) {
+        if (id >= N) return;
+        jobs_[id].deadlineMs = deadlineMs;
+        jobs_[id].armed = true;
+    }
+
+    void armIn(uint8_t id, uint32_t nowMs, uint32_t delayMs) {
+        arm(id, nowMs + delayMs);
+    }
+
+    void disarm(uint8_t id) {
+        if (id < N) jobs_[id].armed = false;
+    }
+
+    bool armed(uint8_t id) const { return id < N && jobs_[id].armed; }
+    uint32_t deadline(uint8_t id) const { return id < N ? jobs_[id].deadlineMs : 0; }
+    uint32_t budget(uint8_t id) const { return id < N ? jobs_[id].budgetMs : 0; }
+
+    /** True if the job's most recent run was later than its budget. */
+    bool lastRunOverran(uint8_t id) const {
+        return id < N && jobs_[id].budgetMs > 0 && jobs_[id].stats.runs > 0 &&
+               jobs_[id].stats.lastLatenessMs > jobs_[id].budgetMs;
+    }
+
+    /**
+     * Returns the highest-priority (lowest id) job whose deadline has passed,
+     * disarmed and with its lateness recorded, or NONE. The job re-arms
+     * itself when it runs.
+     */
+    int takeDue(uint32_t nowMs) {
+        for (uint8_t id = 0; id < N; ++id) {
+            Job& job = jobs_[id];
+            if (!job.armed || !reached(job.deadlineMs, nowMs)) continue;
+            job.armed = false;
+            uint32_t lateness = nowMs - job.deadlineMs;
+            ++job.stats.runs;
+            job.stats.lastLatenessMs = lateness;
+            if (lateness > job.stats.maxLatenessMs) job.stats.maxLatenessMs = lateness;
+            if (job.budgetMs > 0 && lateness > job.budgetMs) ++job.stats.overruns;
+            return id;
+        }
+        return NONE;
+    }
+
+    /**
+     * Milliseconds until the earliest armed deadline among jobs with id below
+     * idLimit (all jobs by default), capped at capMs. 0 means something is
+     * due now; capMs when nothing is armed.
+     */
+    uint32_t msUntilNext(uint32_t nowMs, uint32_t capMs, uint8_t idLimit = N) const {
+        uint32_t wait = capMs;
+        for (uint8_t id = 0; id < N && id < idLimit; ++id) {
+            const Job& job = jobs_[id];
+            if (!job.armed) continue;
+            if (reached(job.deadlineMs, nowMs)) return 0;
+            uint32_t until = job.deadlineMs - nowMs;
+            if (until < wait) wait = until;
+        }
+        return wait;
+    }
+
+    /** Records one yield: the loop asked to sleep requestedMs and slept actualMs. */
+    void recordSleep(uint32_t requestedMs, uint32_t actualMs) {
+        ++wake_.sleeps;
+        wake_.sleptMs += actualMs;
+        if (actualMs < requestedMs) ++wake_.earlyWakes;
+        else if (actualMs > requestedMs) ++wake_.lateWakes;
+    }
+
+    const SchedulerJobStats& stats(uint8_t id) const { return jobs_[id < N ? id : 0].stats; }
+    const SchedulerWakeStats& wakeStats() const { return wake_; }
+
+    /** Clears per-job worst-lateness so each diagnostic read covers a fresh interval. */
+    void resetMaxima() {
+        for (uint8_t id = 0; id < N; ++id) jobs_[id].stats.maxLatenessMs = 0;
+    }
+
+private:
+    struct Job {
+        uint32_t deadlineMs = 0;
+        uint32_t budgetMs = 0;
+        bool armed = false;
+        SchedulerJobStats stats;
+    };
+
+    static bool reached(uint32_t deadlineMs, uint32_t nowMs) {
+        return static_cast<int32_t>(nowMs - deadlineMs) >= 0;
+    }
+
+    Job jobs_[N];
+    SchedulerWakeStats wake_;
+};
+
+#endif // DEADLINE_SCHEDULER_H
@@ -0,0 +1,285 @@
+/**
+ * delta_patch.h — Streaming delta-update applier for OTA firmware images.
+ *
+ * A patch (produced by tools/mkdelta.py) rebuilds the new firmware image
+ * from the running one: COPY ops reference byte ranges of the running
+ * image, INSERT ops carry new bytes inline. The applier consumes the patch
+ * in arbitrary-sized chunks as it arrives over HTTP and writes the rebuilt
+ * image sequentially to the inactive OTA partition, using a fixed 256-byte
+ * copy buffer — RAM use does not depend on image or patch size.
+ *
+ * Patch format (integers little-endian, varints unsigned LEB128 ≤ 32 bits):
+ *
+ *   header   "SDP1" | u32 sourceSize | u32 targetSize
+ *            | sha256(source image) | sha256(target image)      (76 bytes)
+ *   ops      0x01 COPY   varint srcOffset, varint length
+ *            0x02 INSERT varint length, <length bytes>
+ *            0x00 END
+ *
+ * Before writing anything the source hash is checked, so a patch built for
+ * a different base image is rejected instead of producing garbage. The
+ * target hash is checked at END; the caller must only switch boot
+ * partitions when finish() returns DeltaResult::Done.
+ *
+ * Hardware-independent — partitions are reached through DeltaSource and
+ * DeltaSink, so native tests run against file-backed stand-ins.
+ */
+
+#ifndef DELTA_PATCH_H
+#define DELTA_PATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "sha256.h"
+
+constexpr uint8_t DELTA_MAGIC[4] = {'S', 'D', 'P', '1'};
+constexpr size_t DELTA_HEADER_SIZE = 4 + 4 + 4 + SHA256_DIGEST_SIZE + SHA256_DIGEST_SIZE;
+constexpr size_t DELTA_COPY_CHUNK = 256;
+
+constexpr uint8_t DELTA_OP_END    = 0x00;
+constexpr uint8_t DELTA_OP_COPY   = 0x01;
+constexpr uint8_t DELTA_OP_INSERT = 0x02;
+
+enum class DeltaResult : uint8_t {
+    NeedMore,         // Chunk consumed, patch not complete yet
+    Done,             // END reached and target hash verified
+    BadHeader,        // Wrong magic
+    SourceMismatch,   // Running image is not the patch's base
+    SourceReadError,
+    SinkWriteError,
+    BadOp,            // Unknown opcode, oversized varint, or bytes after END
+    OutOfBounds,      // COPY outside the source, or output past targetSize
+    Truncated,        // finish() before END
+    SizeMismatch,     // END before targetSize bytes were written
+    HashMismatch,     // Rebuilt image does not match the target hash
+};
+
+inline const char* deltaResultName(DeltaResult r) {
+    switch (r) {
+        case DeltaResult::NeedMore:        return "incomplete";
+        case DeltaResult::Done:            return "ok";
+        case DeltaResult::BadHeader:       return "not a delta patch";
+        case DeltaResult::SourceMismatch:  return "patch does not match running firmware";
+        case DeltaResult::SourceReadError: return "source read failed";
+        case DeltaResult::SinkWriteError:  return "partition write failed";
+        case DeltaResult::BadOp:           return "corrupt patch";
+        case DeltaResult::OutOfBounds:     return "patch references out of range";
+        case DeltaResult::Truncated:       return "patch truncated";
+        case DeltaResult::SizeMismatch:    return "image size mismatch";
+        case DeltaResult::HashMismatch:    return "image hash mismatch";
+    }
+    return "unknown";
+}
+
+/** Random-access reader over the running (source) image. */
+struct DeltaSource {
+    virtual ~DeltaSource() {}
+    virtual uint32_t size() const = 0;
+    virtual bool read(uint32_t offset, uint8_t* buf, size_t len) = 0;
+};
+
+/** Sequential writer to the inactive (target) partition. */
+struct DeltaSink {
+    virtual ~DeltaSink() {}
+    virtual bool write(const uint8_t* buf, size_t len) = 0;
+};
+
+class DeltaPatchApplier {
+public:
+    DeltaPatchApplier(DeltaSource& source, DeltaSink& sink) : source_(source), sink_(sink) {
+        reset();
+    }
+
+    /** Prepares for a new patch. */
+    void reset() {
+        state_ = State::Header;
+        result_ = DeltaResult::NeedMore;
+        headerLen_ = 0;
+        written_ = 0;
+        sha256Init(targetHash_);
+    }
+
+    /** Consumes the next patch chunk. Once an error is returned, it sticks. */
+    DeltaResult feed(const uint8_t* data, size_t len) {
+        if (result_ == DeltaResult::Done && len > 0) return result_ = DeltaResult::BadOp;
+        size_t i = 0;
+        while (i < len && result_ == DeltaResult::NeedMore) {
+            uint8_t b = data[i];
+            switch (state_) {
+                case State::Header:
+                    header_[headerLen_++] = b;
+                    ++i;
+                    if (headerLen_ == DELTA_HEADER_SIZE) result_ = parseHeader();
+                    break;
+
+                case State::Op:
+                    ++i;
+                    varint_ = 0;
+                    varintShift_ = 0;
+                    if (b == DELTA_OP_COPY) {
+                        state_ = State::CopyOffset;
+                    } else if (b == DELTA_OP_INSERT) {
+                        state_ = State::InsertLength;
+                    } else if (b == DELTA_OP_END) {
+                        result_ = verifyTarget();
+                        state_ = State::End;
+                    } else {
+                        result_ = DeltaResult::BadOp;
+                    }
+                    break;
+
+                case State::CopyOffset:
+                case State::CopyLength:
+                case State::InsertLength:
+                    ++i;
+                    if (!accumulateVarint(b)) {
+                        result_ = DeltaResult::BadOp;
+                    } else if (!(b & 0x80)) {
+                        result_ = varintComplete();
+                    }
+                    break;
+
+                case State::InsertData: {
+                    size_t take = len - i;
+                    if (take > remaining_) take = remaining_;
+                    result_ = emit(data + i, take);
+                    i += take;
+                    remaining_ -= static_cast<uint32_t>(take);
+                    if (remaining_ == 0) state_ = State::Op;
+                    break;
+                }
+
+                case State::End:
+                    result_ = DeltaResult::BadOp;
+                    break;
+            }
+        }
+        // Bytes after END mean the patch is not what the tool produced
+        if (result_ == DeltaResult::Done && i < len) result_ = DeltaResult::BadOp;
+        return result_;
+    }
+
+    /** Call after the last chunk. Returns Done only for a verified image. */
+    DeltaResult finish() {
+        if (result_ == DeltaResult::NeedMore) result_ = DeltaResult::Truncated;
+        return result_;
+    }
+
+    DeltaResult result() const { return result_; }
+    uint32_t written() const { return written_; }
+    uint32_t targetSize() const { return targetSize_; }
+
+private:
+    enum class State : uint8_t { Header, Op, CopyOffset, CopyLength, InsertLength, InsertData, End };
+
+    static uint32_t readLe32(const uint8_t* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    DeltaResult parseHeader() {
+        if (std::memcmp(header_, DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0) return DeltaResult::BadHeader;
+        sourceSize_ = readLe32(header_ + 4);
+        targetSize_ = readLe32(header_ + 8);
+        if (sourceSize_ > source_.size()) return DeltaResult::SourceMismatch;
+
+        // Hash the base image in place — bounded by the copy buffer
+        Sha256 sourceHash;
+        sha256Init(sourceHash);
+        for (uint32_t off = 0; off < sourceSize_; ) {
+            size_t n = sourceSize_ - off < DELTA_COPY_CHUNK ? sourceSize_ - off : DELTA_COPY_CHUNK;
+            if (!source_.read(off, buf_, n)) return DeltaResult::SourceReadError;
+            sha256Update(sourceHash, buf_, n);
+            off += static_cast<uint32_t>(n);
+        }
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        sha256Final(sourceHash, digest);
+        if (std::memcmp(digest, header_ + 12, SHA256_DIGEST_SIZE) != 0) {
+            return DeltaResult::SourceMismatch;
+        }
+        state_ = State::Op;
+        return DeltaResult::NeedMore;
+    }
+
+    bool accumulateVarint(uint8_t b) {
+        if (varintShift_ > 28) return false;
+        uint32_t bits = static_cast<uint32_t>(b & 0x7F);
+        if (varintShift_ == 28 && bits > 0x0F) return false;  // would overflow 32 bits
+        varint_ |= bits << varintShift_;
+        varintShift_ += 7;
+        return true;
+    }
+
+    DeltaResult varintComplete() {
+        uint32_t value = varint_;
+        varint_ = 0;
+        varintShift_ = 0;
+        switch (state_) {
+            case State::CopyOffset:
+                copyOffset_ = value;
+                state_ = State::CopyLength;
+                return DeltaResult::NeedMore;
+            case State::CopyLength:
+                state_ = State::Op;
+                return copy(copyOffset_, value);
+            case State::InsertLength:
+                if (value > targetSize_ - written_) return DeltaResult::OutOfBounds;
+                remaining_ = value;
+                state_ = value > 0 ? State::InsertData : State::Op;
+                return DeltaResult::NeedMore;
+            default:
+                return DeltaResult::BadOp;
+        }
+    }
+
+    DeltaResult copy(uint32_t offset, uint32_t length) {
+        if (offset > sourceSize_ || length > sourceSize_ - offset) return DeltaResult::OutOfBounds;
+        while (length > 0) {
+            size_t n = length < DELTA_COPY_CHUNK ? length : DELTA_COPY_CHUNK;
+            if (!source_.read(offset, buf_, n)) return DeltaResult::SourceReadError;
+            DeltaResult r = emit(buf_, n);
+            if (r != DeltaResult::NeedMore) return r;
+            offset += static_cast<uint32_t>(n);
+            length -= static_cast<uint32_t>(n);
+        }
+        return DeltaResult::NeedMore;
+    }
+
+    DeltaResult emit(const uint8_t* data, size_t len) {
+        if (len > targetSize_ - written_) return DeltaResult::OutOfBounds;
+        if (!sink_.write(data, len)) return DeltaResult::SinkWriteError;
+        sha256Update(targetHash_, data, len);
+        written_ += static_cast<uint32_t>(len);
+        return DeltaResult::NeedMore;
+    }
+
+    DeltaResult verifyTarget() {
+        if (written_ != targetSize_) return DeltaResult::SizeMismatch;
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        sha256Final(targetHash_, digest);
+        if (std::memcmp(digest, header_ + 12 + SHA256_DIGEST_SIZE, SHA256_DIGEST_SIZE) != 0) {
+            return DeltaResult::HashMismatch;
+        }
+        return DeltaResult::Done;
+    }
+
+    DeltaSource& source_;
+    DeltaSink& sink_;
+    State state_;
+    DeltaResult result_;
+    uint8_t header_[DELTA_HEADER_SIZE];
+    size_t headerLen_;
+    uint32_t sourceSize_ = 0;
+    uint32_t targetSize_ = 0;
+    uint32_t written_;
+    uint32_t varint_ = 0;
+    uint8_t varintShift_ = 0;
+    uint32_t copyOffset_ = 0;
+    uint32_t remaining_ = 0;
+    Sha256 targetHash_;
+    uint8_t buf_[DELTA_COPY_CHUNK];
+};
+
+#endif // DELTA_PATCH_H
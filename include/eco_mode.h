@@ -0,0 +1,329 @@
+/**
+ * eco_mode.h — Energy-optimal heat-up: be at temperature by a deadline
+ * (POST /eco), and not long before.
+ *
+ * Holding a hot room costs energy the whole time — envelope loss grows
+ * with the temperature difference — so for a given arrival time the least
+ * energy is spent by heating at full power, as late as possible. That
+ * needs a prediction of the heat-up time, which depends on the heater,
+ * the room and the weather, so it is learned from this sauna:
+ *
+ *   rate(T) = a − b · (T − ECO_FIT_CENTER_C)        [°C/min, heater on]
+ *
+ * a is the heating rate at 60 °C; b is the loss — how much slower the room
+ * heats per degree hotter. HeatupTracker cuts steady full-power stretches
+ * of every session into ECO_FIT_WINDOW_MS windows (after the probe lag has
+ * settled) and HeatupModel fits a and b by weighted least squares with
+ * exponential forgetting, so the model follows seasonal changes. Until
+ * the windows cover a wide enough temperature range the defaults are used.
+ *
+ * Heat-up time from T0 to T1 is the integral of dT / rate(T):
+ *
+ *   t = ln(rate(T0) / rate(T1)) / b
+ *
+ * EcoPlan turns a ready time into a start time: predicted heat-up plus
+ * ECO_LEAD_MARGIN, re-evaluated on every reading so a room that is still
+ * warm (or cooling) is accounted for. Starting is an ordinary HEAT command
+ * — the session limit and the safety pipeline are unchanged.
+ *
+ * Pure logic with no hardware dependencies — testable against the
+ * simulated traces of thermal_plant.h.
+ */
+
+#ifndef ECO_MODE_H
+#define ECO_MODE_H
+
+#include <cmath>
+#include <cstdint>
+
+#include "sauna_logic.h"
+#include "http_validation.h"
+
+constexpr float ECO_FIT_CENTER_C = 60.0f;
+constexpr uint32_t ECO_FIT_SETTLE_MS = 120000;    // Skip after the relay closes — 2 × probe lag
+constexpr uint32_t ECO_FIT_WINDOW_MS = 60000;
+constexpr uint32_t ECO_FIT_MAX_GAP_MS = 10000;    // Missed readings break a window
+constexpr float ECO_FIT_FORGET = 0.98f;           // Per window — roughly the last 50 count
+constexpr float ECO_FIT_MIN_WEIGHT = 8.0f;
+constexpr float ECO_FIT_MIN_VARIANCE = 25.0f;     // Windows must span ~±5 °C around their mean
+
+// Defaults: a 7 kW heater in a ~220 kJ/°C room (the thermal_plant.h figures)
+constexpr float ECO_DEFAULT_RATE_C_PER_MIN = 1.2f;   // a
+constexpr float ECO_DEFAULT_LOSS_PER_MIN = 0.0175f;  // b
+constexpr float ECO_MAX_LOSS_PER_MIN = 0.2f;
+
+constexpr uint32_t ECO_UNREACHABLE = 0xFFFFFFFFu;
+constexpr float ECO_LEAD_MARGIN = 0.10f;             // Added to the predicted heat-up...
+constexpr uint32_t ECO_LEAD_MARGIN_MS = 120000;      // ...plus a fixed 2 min
+constexpr int ECO_MAX_READY_IN_MIN = 24 * 60;
+
+// =============================================================================
+// Heat-up Model
+// =============================================================================
+
+/** Least-squares sums, x = T − ECO_FIT_CENTER_C, y = rate. Trivial so it can be persisted as bytes. */
+struct HeatupFit {
+    float w;
+    float sx;
+    float sy;
+    float sxx;
+    float sxy;
+};
+
+class HeatupModel {
+public:
+    HeatupModel() { reset(); }
+
+    void reset() {
+        fit_ = HeatupFit();
+        a_ = ECO_DEFAULT_RATE_C_PER_MIN;
+        b_ = ECO_DEFAULT_LOSS_PER_MIN;
+        fitted_ = false;
+    }
+
+    /** Continues from persisted sums. Returns false (and keeps the defaults) if they are not sane. */
+    bool restore(const HeatupFit& f) {
+        const float v[] = {f.w, f.sx, f.sy, f.sxx, f.sxy};
+        for (float x : v) {
+            if (!std::isfinite(x)) return false;
+        }
+        if (!(f.w >= 0.0f && f.w <= 1.0f / (1.0f - ECO_FIT_FORGET) + 1.0f) || f.sxx < 0.0f) return false;
+        fit_ = f;
+        solve();
+        return true;
+    }
+
+    /** Adds one window: the room heated at rateCPerMin around midC. */
+    void addWindow(float midC, float rateCPerMin) {
+        if (!std::isfinite(midC) || !std::isfinite(rateCPerMin)) return;
+        float x = midC - ECO_FIT_CENTER_C;
+        fit_.w = fit_.w * ECO_FIT_FORGET + 1.0f;
+        fit_.sx = fit_.sx * ECO_FIT_FORGET + x;
+        fit_.sy = fit_.sy * ECO_FIT_FORGET + rateCPerMin;
+        fit_.sxx = fit_.sxx * ECO_FIT_FORGET + x * x;
+        fit_.sxy = fit_.sxy * ECO_FIT_FORGET + x * rateCPerMin;
+        solve();
+    }
+
+    const HeatupFit& fit() const { return fit_; }
+    bool fitted() const { return fitted_; }
+    float lossPerMin() const { return b_; }
+
+    /** Heating rate at full power, °C/min (≤ 0: the heater cannot get the room hotter). */
+    float rateAt(float c) const { return a_ - b_ * (c - ECO_FIT_CENTER_C); }
+
+    /** Predicted full-power heat-up time, or ECO_UNREACHABLE. */
+    uint32_t heatupMs(float fromC, float toC) const {
+        if (!(toC > fromC)) return 0;
+        float r0 = rateAt(fromC);
+        float r1 = rateAt(toC);
+        if (!(r0 > 0.0f) || !(r1 > 0.0f)) return ECO_UNREACHABLE;
+        float minutes = b_ > 1e-5f ? std::log(r0 / r1) / b_ : (toC - fromC) / a_;
+        float ms = minutes * 60000.0f;
+        return ms >= 4.0e9f ? ECO_UNREACHABLE : static_cast<uint32_t>(ms + 0.5f);
+    }
+
+private:
+    void solve() {
+        a_ = ECO_DEFAULT_RATE_C_PER_MIN;
+        b_ = ECO_DEFAULT_LOSS_PER_MIN;
+        fitted_ = false;
+        if (fit_.w < ECO_FIT_MIN_WEIGHT) return;
+        float mx = fit_.sx / fit_.w;
+        float my = fit_.sy / fit_.w;
+        float var = fit_.sxx / fit_.w - mx * mx;
+        if (!(var >= ECO_FIT_MIN_VARIANCE)) return;
+        float cov = fit_.sxy / fit_.w - mx * my;
+        float b = -cov / var;
+        if (b < 0.0f) b = 0.0f;   // Noise — a room never heats faster when hotter
+        if (b > ECO_MAX_LOSS_PER_MIN) b = ECO_MAX_LOSS_PER_MIN;
+        float a = my + b * mx;
+        if (!(a > 0.0f)) return;
+        a_ = a;
+        b_ = b;
+        fitted_ = true;
+    }
+
+    HeatupFit fit_;
+    float a_;
+    float b_;
+    bool fitted_;
+};
+
+/**
+ * Cuts readings into heat-up windows for HeatupModel. Only stretches with
+ * the relay closed throughout count, starting ECO_FIT_SETTLE_MS after it
+ * closed, when the probe tracks the room at a steady lag.
+ */
+class HeatupTracker {
+public:
+    /**
+     * One valid reading. heaterWasOn is the relay state that held since the
+     * previous reading. Returns true when a window was added to the model.
+     */
+    bool observe(uint32_t nowMs, float tempC, bool heaterWasOn, HeatupModel& model) {
+        bool gap = haveLast_ && nowMs - lastMs_ > ECO_FIT_MAX_GAP_MS;
+        haveLast_ = true;
+        lastMs_ = nowMs;
+        if (!heaterWasOn || gap) {
+            on_ = false;
+            inWindow_ = false;
+            return false;
+        }
+        if (!on_) {
+            on_ = true;
+            onSinceMs_ = nowMs;
+            return false;
+        }
+        if (nowMs - onSinceMs_ < ECO_FIT_SETTLE_MS) return false;
+        if (!inWindow_) {
+            startWindow(nowMs, tempC);
+            return false;
+        }
+        uint32_t elapsed = nowMs - windowStartMs_;
+        if (elapsed < ECO_FIT_WINDOW_MS) return false;
+        float minutes = elapsed / 60000.0f;
+        model.addWindow((windowStartC_ + tempC) * 0.5f, (tempC - windowStartC_) / minutes);
+        startWindow(nowMs, tempC);
+        return true;
+    }
+
+private:
+    void startWindow(uint32_t nowMs, float tempC) {
+        inWindow_ = true;
+        windowStartMs_ = nowMs;
+        windowStartC_ = tempC;
+    }
+
+    bool haveLast_ = false;
+    uint32_t lastMs_ = 0;
+    bool on_ = false;
+    uint32_t onSinceMs_ = 0;
+    bool inWindow_ = false;
+    uint32_t windowStartMs_ = 0;
+    float windowStartC_ = 0.0f;
+};
+
+// =============================================================================
+// Plan
+// =============================================================================
+
+/** How long before the ready time heating must start: heat-up plus margin. */
+inline uint32_t ecoLeadMs(const HeatupModel& model, float fromC, float toC) {
+    uint32_t heat = model.heatupMs(fromC, toC);
+    if (heat == ECO_UNREACHABLE) return ECO_UNREACHABLE;
+    float lead = heat * (1.0f + ECO_LEAD_MARGIN) + ECO_LEAD_MARGIN_MS;
+    return lead >= 4.0e9f ? ECO_UNREACHABLE : static_cast<uint32_t>(lead);
+}
+
+class EcoPlan {
+public:
+    void schedule(uint32_t nowMs, uint32_t readyInMs, float targetC) {
+        active_ = true;
+        readyAtMs_ = nowMs + readyInMs;
+        targetC_ = targetC;
+    }
+
+    void cancel() { active_ = false; }
+    bool active() const { return active_; }
+    float target() const { return targetC_; }
+
+    /** Time left until the room should be ready (0 once the time has passed). */
+    uint32_t readyInMs(uint32_t nowMs) const {
+        int32_t left = static_cast<int32_t>(readyAtMs_ - nowMs);
+        return left > 0 ? static_cast<uint32_t>(left) : 0;
+    }
+
+    /** Time until heating must start from tempC (0 = now). */
+    uint32_t startInMs(uint32_t nowMs, float tempC, const HeatupModel& model) const {
+        uint32_t lead = ecoLeadMs(model, tempC, targetC_);
+        uint32_t ready = readyInMs(nowMs);
+        return ready > lead ? ready - lead : 0;
+    }
+
+    bool due(uint32_t nowMs, float tempC, const HeatupModel& model) const {
+        return active_ && startInMs(nowMs, tempC, model) == 0;
+    }
+
+private:
+    bool active_ = false;
+    uint32_t readyAtMs_ = 0;
+    float targetC_ = 0.0f;
+};
+
+// =============================================================================
+// POST /eco
+// =============================================================================
+
+struct EcoCommand {
+    float temperature = 0.0f;
+    int readyInMin = 0;
+};
+
+enum class EcoResult : uint8_t {
+    Ok,
+    MalformedJson,
+    MissingFields,
+    InvalidTemperature,
+    TemperatureOutOfRange,
+    InvalidReadyIn,
+    Unreachable,       // Predicted heat-up does not fit the session limit
+    SessionActive,
+    SensorFault,
+};
+
+/** Parses {"temperature":85.0,"ready_in_min":90} — both fields required. */
+inline EcoResult parseEcoCommand(const char* body, EcoCommand& cmd) {
+    char value[24];
+    JsonField field = extractJsonField(body, "temperature", value, sizeof(value));
+    if (field == JsonField::Malformed) return EcoResult::MalformedJson;
+    if (field == JsonField::Missing) return EcoResult::MissingFields;
+    if (!parseFloatValue(value, cmd.temperature)) return EcoResult::InvalidTemperature;
+
+    field = extractJsonField(body, "ready_in_min", value, sizeof(value));
+    if (field == JsonField::Malformed) return EcoResult::MalformedJson;
+    if (field == JsonField::Missing) return EcoResult::MissingFields;
+    if (!parseIntValue(value, cmd.readyInMin)) return EcoResult::InvalidReadyIn;
+    return EcoResult::Ok;
+}
+
+inline EcoResult validateEcoStart(const EcoCommand& cmd, const HeatupModel& model, float currentC,
+                                  bool sessionActive, bool sensorFault) {
+    if (!isValidTargetTemp(cmd.temperature)) return EcoResult::TemperatureOutOfRange;
+    if (cmd.readyInMin < 1 || cmd.readyInMin > ECO_MAX_READY_IN_MIN) return EcoResult::InvalidReadyIn;
+    if (!canAcceptHeatCommand(sensorFault)) return EcoResult::SensorFault;
+    if (sessionActive) return EcoResult::SessionActive;
+    if (model.heatupMs(currentC, cmd.temperature) >= SESSION_MAX_MS) return EcoResult::Unreachable;
+    return EcoResult::Ok;
+}
+
+inline int ecoHttpStatus(EcoResult result) {
+    switch (result) {
+        case EcoResult::Ok:            return 200;
+        case EcoResult::SessionActive: return 409;
+        case EcoResult::SensorFault:   return 503;
+        default:                       return 400;
+    }
+}
+
+static_assert(TARGET_TEMP_MIN == 40.0f && TARGET_TEMP_MAX == 100.0f,
+              "ecoError() text must match TARGET_TEMP_MIN/MAX");
+static_assert(ECO_MAX_READY_IN_MIN == 1440, "ecoError() text must match ECO_MAX_READY_IN_MIN");
+static_assert(SESSION_MAX_MINUTES == 60, "ecoError() text must match SESSION_MAX_MINUTES");
+
+inline const char* ecoError(EcoResult result) {
+    switch (result) {
+        case EcoResult::Ok:                    return "{\"ok\":true}";
+        case EcoResult::MalformedJson:         return "{\"error\":\"malformed JSON\"}";
+        case EcoResult::MissingFields:         return "{\"error\":\"missing 'temperature' or 'ready_in_min' field\"}";
+        case EcoResult::InvalidTemperature:    return "{\"error\":\"invalid temperature value\"}";
+        case EcoResult::TemperatureOutOfRange: return "{\"error\":\"temperature must be between 40 and 100\"}";
+        case EcoResult::InvalidReadyIn:        return "{\"error\":\"ready_in_min must be a whole number from 1 to 1440\"}";
+        case EcoResult::Unreachable:           return "{\"error\":\"target cannot be reached within the 60 min session limit\"}";
+        case EcoResult::SessionActive:         return "{\"error\":\"session active, turn heater off first\"}";
+        case EcoResult::SensorFault:           return "{\"error\":\"sensor fault active, cannot enable heater\"}";
+    }
+    return "{\"error\":\"invalid request\"}";
+}
+
+#endif // ECO_MODE_H
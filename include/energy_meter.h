@@ -0,0 +1,77 @@
+/**
+ * energy_meter.h — Heater energy from relay on-time.
+ *
+ * A sauna heater is a resistive load: it draws its rated power while the
+ * contactor is closed and nothing otherwise, so energy is on-time × power.
+ * EnergyMeter is told about every relay change and integrates on-time in
+ * whole milliseconds (uint64_t — never loses resolution, never wraps).
+ * Power is applied only when reporting, so correcting the configured
+ * rating corrects the history too.
+ *
+ * The lifetime total is persisted by the firmware. saveDue() asks for a
+ * write once ENERGY_SAVE_ON_MS of unsaved on-time has built up, which
+ * bounds both flash wear (a few writes per heating hour) and what a crash
+ * can lose.
+ *
+ * Pure logic with no hardware dependencies — testable on any host.
+ */
+
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <cstdint>
+
+constexpr uint32_t ENERGY_SAVE_ON_MS = 10UL * 60UL * 1000UL;   // Unsaved on-time before a save
+
+/** kWh drawn by a heater of powerW over onMs of relay on-time. */
+inline double energyKWh(uint64_t onMs, float powerW) {
+    return static_cast<double>(onMs) * powerW / 3.6e9;
+}
+
+class EnergyMeter {
+public:
+    /** Continues from a persisted total. Call once at boot, before update(). */
+    void restore(uint64_t lifetimeOnMs) {
+        onMs_ = lifetimeOnMs;
+        savedMs_ = lifetimeOnMs;
+    }
+
+    /** Relay state from nowMs on. Call on every change; repeated states are harmless. */
+    void update(uint32_t nowMs, bool on) {
+        credit(nowMs);
+        on_ = on;
+    }
+
+    /** Lifetime relay on-time, including the interval running now. */
+    uint64_t lifetimeOnMs(uint32_t nowMs) const {
+        return onMs_ + (on_ ? static_cast<uint32_t>(nowMs - lastMs_) : 0);
+    }
+
+    bool on() const { return on_; }
+
+    /** On-time not yet persisted. */
+    uint64_t unsavedMs(uint32_t nowMs) const { return lifetimeOnMs(nowMs) - savedMs_; }
+
+    /** True once ENERGY_SAVE_ON_MS of on-time has not been persisted. */
+    bool saveDue(uint32_t nowMs) const { return unsavedMs(nowMs) >= ENERGY_SAVE_ON_MS; }
+
+    /** Credits the running interval and returns the total to persist. */
+    uint64_t save(uint32_t nowMs) {
+        credit(nowMs);
+        savedMs_ = onMs_;
+        return onMs_;
+    }
+
+private:
+    void credit(uint32_t nowMs) {
+        if (on_) onMs_ += static_cast<uint32_t>(nowMs - lastMs_);
+        lastMs_ = nowMs;
+    }
+
+    bool on_ = false;
+    uint32_t lastMs_ = 0;
+    uint64_t onMs_ = 0;
+    uint64_t savedMs_ = 0;
+};
+
+#endif // ENERGY_METER_H
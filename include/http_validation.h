@@ -10,6 +10,8 @@
 
 #include <cstdlib>
 #include <cctype>
+#include <cstddef>
+#include <cstring>
 
 // =============================================================================
 // Target Temperature Range
@@ -79,4 +81,44 @@ inline bool parseFloatValue(const char* str, float& out) {
     return true;
 }
 
+// =============================================================================
+// Field Extraction (flat JSON objects with numeric values)
+// =============================================================================
+
+enum class JsonField : unsigned char {
+    Found,      // Value token copied to the output buffer
+    Missing,    // Key not present
+    Malformed,  // Key present but no ':' or the value does not fit
+};
+
+/**
+ * Locates "key" in a flat JSON object and copies its raw value token — the
+ * text between ':' and the next ',' or '}' — into `out`. Needed for
+ * multi-field bodies, where the substring after the colon is not
+ * isTrailingClean(). The token is then handed to parseIntValue() or
+ * parseFloatValue(), which do the strict checking.
+ */
+inline JsonField extractJsonField(const char* body, const char* key, char* out, size_t outLen) {
+    if (!body || !key || !out || outLen == 0) return JsonField::Missing;
+    const size_t keyLen = std::strlen(key);
+    const char* p = std::strstr(body, key);
+    // Only match the quoted key itself, not a substring of another key
+    while (p && !(p > body && p[-1] == '"' && p[keyLen] == '"')) {
+        p = std::strstr(p + 1, key);
+    }
+    if (!p) return JsonField::Missing;
+
+    p += keyLen + 1;  // past the closing quote
+    while (std::isspace(static_cast<unsigned char>(*p))) ++p;
+    if (*p != ':') return JsonField::Malformed;
+    ++p;
+
+    size_t n = 0;
+    while (p[n] && p[n] != ',' && p[n] != '}') ++n;
+    if (n >= outLen) return JsonField::Malformed;
+    std::memcpy(out, p, n);
+    out[n] = '\0';
+    return JsonField::Found;
+}
+
 #endif // HTTP_VALIDATION_H
@@ -0,0 +1,218 @@
+/**
+ * log_ring.h — Fixed-size, lock-free event log for the control path.
+ *
+ * Serial output at 115200 baud costs ~87 µs per character, so a single log
+ * line inside SaunaThermostat::loop() can delay a safety decision by several
+ * milliseconds. Call sites instead record a structured entry (level,
+ * timestamp, message id, numeric args) in constant time; a low-priority task
+ * drains the ring to Serial, and GET /logs reads the retained history.
+ *
+ * Concurrency: single producer (the Arduino loop task, which also serves
+ * HTTP), single consumer (the drain task). No locks, no allocation.
+ * Hardware-independent — testable on any host.
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// =============================================================================
+// Message Catalogue
+// =============================================================================
+
+enum class LogLevel : uint8_t {
+    Info   = 0,
+    Warn   = 1,
+    Safety = 2,
+};
+
+/**
+ * Message ids. Each maps to a printf format in logMessageFormat(); args are
+ * stored as floats, so formats may only use floating-point conversions.
+ * Append new ids before Count — ids are reported by GET /logs.
+ */
+enum class LogMsg : uint8_t {
+    HeatBlockedSensorFault = 0,
+    HomeKitTargetHeat,
+    HomeKitTargetOff,
+    HomeKitTargetTemp,
+    SessionTimeout,
+    SensorFault,
+    OverTemperature,
+    SchedulerOverrun,
+    ProfileComplete,
+    SessionResumed,
+    ResumeCorrupt,
+    ResumeTooMany,
+    ResumeLimitReached,
+    EcoStarted,
+    EnergySaveFailed,
+    ProbeVotedOut,
+    ProbesDisagree,
+    Count
+};
+
+constexpr uint8_t LOG_MAX_ARGS = 2;
+
+/** Returns the printf format for a message id. Formats must not contain
+ *  '"' or '\\' — formatLogJson() embeds them without escaping. */
+inline const char* logMessageFormat(LogMsg msg) {
+    switch (msg) {
+        case LogMsg::HeatBlockedSensorFault: return "SAFETY: HEAT command blocked — sensor fault active";
+        case LogMsg::HomeKitTargetHeat:      return "HomeKit: Target state set to HEAT";
+        case LogMsg::HomeKitTargetOff:       return "HomeKit: Target state set to OFF";
+        case LogMsg::HomeKitTargetTemp:      return "HomeKit: Target temp set to %.1f°C";
+        case LogMsg::SessionTimeout:         return "SAFETY: Session time limit (%.0f min) reached, heater disabled";
+        case LogMsg::SensorFault:            return "SAFETY: Temperature sensor fault (%.1f), heater disabled";
+        case LogMsg::OverTemperature:        return "SAFETY: Max temp (%.0f°C) reached, heater disabled";
+        case LogMsg::SchedulerOverrun:       return "WARN: Scheduler job %.0f ran %.0f ms late";
+        case LogMsg::ProfileComplete:        return "Profile: last segment finished, heater disabled";
+        case LogMsg::SessionResumed:         return "Session resumed after reset (%.0f s used, resume %.0f)";
+        case LogMsg::ResumeCorrupt:          return "SAFETY: Retained session failed its checksum, not resumed";
+        case LogMsg::ResumeTooMany:          return "SAFETY: Session not resumed after %.0f resets";
+        case LogMsg::ResumeLimitReached:     return "SAFETY: Session time limit used up across resets, not resumed";
+        case LogMsg::EcoStarted:             return "Eco: heating to %.1f°C, ready in %.0f min";
+        case LogMsg::EnergySaveFailed:       return "WARN: Energy totals could not be written to flash";
+        case LogMsg::ProbeVotedOut:          return "SAFETY: Probe %.0f voted out, %.1f°C from the others";
+        case LogMsg::ProbesDisagree:         return "SAFETY: Probes disagree by %.1f°C, heater disabled";
+        case LogMsg::Count:                  break;
+    }
+    return "unknown event";
+}
+
+inline const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Info:   return "INFO";
+        case LogLevel::Warn:   return "WARN";
+        case LogLevel::Safety: return "SAFETY";
+    }
+    return "?";
+}
+
+// =============================================================================
+// Entry & Formatting
+// =============================================================================
+
+struct LogEntry {
+    uint32_t seq;           // Monotonic sequence number (never reused)
+    uint32_t timestampMs;   // millis() at the time of the event
+    LogLevel level;
+    LogMsg msg;
+    float args[LOG_MAX_ARGS];
+};
+
+/** Renders the message text only. Returns snprintf()'s result. */
+inline int formatLogMessage(const LogEntry& e, char* buf, size_t len) {
+    return std::snprintf(buf, len, logMessageFormat(e.msg),
+                         static_cast<double>(e.args[0]),
+                         static_cast<double>(e.args[1]));
+}
+
+/** Renders a serial log line: "[   12345] SAFETY <message>". */
+inline int formatLogLine(const LogEntry& e, char* buf, size_t len) {
+    int n = std::snprintf(buf, len, "[%8u] %-6s ",
+                          static_cast<unsigned>(e.timestampMs), logLevelName(e.level));
+    if (n < 0 || static_cast<size_t>(n) >= len) return n;
+    int m = formatLogMessage(e, buf + n, len - n);
+    return m < 0 ? m : n + m;
+}
+
+/** Renders one GET /logs array element. */
+inline int formatLogJson(const LogEntry& e, char* buf, size_t len) {
+    int n = std::snprintf(buf, len, "{\"seq\":%u,\"t\":%u,\"level\":\"%s\",\"id\":%u,\"msg\":\"",
+                          static_cast<unsigned>(e.seq), static_cast<unsigned>(e.timestampMs),
+                          logLevelName(e.level), static_cast<unsigned>(e.msg));
+    if (n < 0 || static_cast<size_t>(n) >= len) return n;
+    int m = formatLogMessage(e, buf + n, len - n);
+    if (m < 0) return m;
+    n += m;
+    if (static_cast<size_t>(n) >= len) return n;
+    int c = std::snprintf(buf + n, len - n, "\"}");
+    return c < 0 ? c : n + c;
+}
+
+// =============================================================================
+// Ring Buffer
+// =============================================================================
+
+/**
+ * SPSC ring of N entries (N must be a power of two).
+ *
+ * push() never overwrites an entry the drain has not consumed yet — when the
+ * ring is full the new entry is discarded and dropped() increments, so a
+ * stalled drain costs log lines, never control-loop time.
+ *
+ * Drained entries stay in their slots until overwritten, so read() can serve
+ * the last N entries by sequence number. read() must run on the producer
+ * task (the same task that calls push()).
+ */
+template <uint32_t N>
+class LogRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "LogRing size must be a power of two");
+
+public:
+    /** Producer: records an entry in O(1). Returns false if it was dropped. */
+    bool push(LogLevel level, uint32_t timestampMs, LogMsg msg,
+              float a0 = 0.0f, float a1 = 0.0f) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= N) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        LogEntry& e = slots_[head & (N - 1)];
+        e.seq = head;
+        e.timestampMs = timestampMs;
+        e.level = level;
+        e.msg = msg;
+        e.args[0] = a0;
+        e.args[1] = a1;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: takes the oldest undrained entry. Returns false when empty. */
+    bool pop(LogEntry& out) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Producer task only: copies entry `seq` if it is still retained. */
+    bool read(uint32_t seq, LogEntry& out) const {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (seq >= head || head - seq > N) return false;
+        out = slots_[seq & (N - 1)];
+        return true;
+    }
+
+    /** Sequence number the next push() will receive. */
+    uint32_t nextSeq() const { return head_.load(std::memory_order_acquire); }
+
+    /** Oldest sequence number read() can still return. */
+    uint32_t oldestSeq() const {
+        uint32_t head = nextSeq();
+        return head > N ? head - N : 0;
+    }
+
+    /** Entries discarded because the drain fell N entries behind. */
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /** Entries recorded but not yet drained. */
+    uint32_t pending() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    LogEntry slots_[N] = {};
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> dropped_{0};
+};
+
+#endif // LOG_RING_H
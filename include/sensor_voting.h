@@ -0,0 +1,224 @@
+/**
+ * sensor_voting.h — Voting over two or three co-located DS18B20 probes.
+ *
+ * isSensorFault() catches a probe that stops answering, but not one that
+ * keeps answering with the wrong number: a probe pulled out of its mount,
+ * a cracked sleeve, or a reading stuck while the room heats. With more than
+ * one probe on the bus those show up as disagreement, and SensorVote turns
+ * each round of readings into one value for the controller:
+ *
+ *   - Three healthy probes: the median, so one bad probe cannot move the
+ *     control value or the over-temperature trip (2-out-of-3). A probe
+ *     that keeps disagreeing with the other two is voted out for good.
+ *   - Two healthy probes: the mean for control and the hotter one for the
+ *     trip. When they disagree there is no majority to say which is
+ *     wrong, so the vote is invalid and the heater stays off.
+ *   - One probe configured: exactly the single-probe behaviour.
+ *
+ * Two probes detect a fault; three tolerate one. A read failure leaves a
+ * probe out of that round only, so it rejoins when it answers again.
+ * Voting needs two agreeing probes whenever more than one is fitted:
+ * with one left the firmware cannot tell drift from temperature.
+ *
+ * A probe's deviation is its distance from the median (three probes) or
+ * from the other probe (two). Detection is counted in readings, so the
+ * worst-case latency is fixed:
+ *
+ *   deviation > VOTE_DISAGREE_C   confirmed at the VOTE_DISAGREE_READINGS-th
+ *                                 consecutive reading
+ *   deviation > VOTE_DRIFT_C      confirmed within VOTE_DRIFT_READINGS
+ *                                 readings. The count is leaky — up two
+ *                                 per deviating reading, down one per good
+ *                                 one — so a deviation present more than
+ *                                 a third of the time is still caught.
+ *
+ * At the 2 s read interval that is 6 s and 60 s. The thresholds allow for
+ * two ±0.5 °C parts plus different lag during a fast heat-up.
+ *
+ * Pure logic with no hardware dependencies — testable on any host.
+ */
+
+#ifndef SENSOR_VOTING_H
+#define SENSOR_VOTING_H
+
+#include <cmath>
+#include <cstdint>
+
+#include "sauna_logic.h"
+
+constexpr uint8_t VOTE_MAX_PROBES = 3;
+constexpr float VOTE_DISAGREE_C = 3.0f;
+constexpr uint8_t VOTE_DISAGREE_READINGS = 3;
+constexpr float VOTE_DRIFT_C = 1.5f;
+constexpr uint8_t VOTE_DRIFT_READINGS = 30;
+constexpr uint8_t VOTE_DRIFT_CONFIRM = 2 * VOTE_DRIFT_READINGS;   // Leaky count at confirmation
+
+enum class ProbeState : uint8_t {
+    Ok,
+    Missing,    // Read failed this round
+    Disagree,   // Voted out: far from the others
+    Drift,      // Voted out: persistently off
+};
+
+inline const char* probeStateName(ProbeState state) {
+    switch (state) {
+        case ProbeState::Ok:       return "ok";
+        case ProbeState::Missing:  return "missing";
+        case ProbeState::Disagree: return "disagree";
+        case ProbeState::Drift:    return "drift";
+    }
+    return "unknown";
+}
+
+enum class VoteFault : uint8_t {
+    None,
+    TooFewProbes,   // Not enough probes answered
+    Disagreement,   // Probes disagree and there is no majority
+};
+
+struct VoteResult {
+    bool valid = false;
+    VoteFault fault = VoteFault::TooFewProbes;
+    float controlC = NAN;    // For the thermostat
+    float tripC = NAN;       // For isOverTemperature()
+    float spreadC = 0.0f;    // Hottest minus coldest voting probe
+    uint8_t healthy = 0;     // Probes in this round's vote
+    int8_t excluded = -1;    // Probe voted out this round, or -1
+};
+
+class SensorVote {
+public:
+    /** Starts voting over probeCount probes (clamped to 1–VOTE_MAX_PROBES), all healthy. */
+    void begin(uint8_t probeCount) {
+        count_ = probeCount < 1 ? 1 : (probeCount > VOTE_MAX_PROBES ? VOTE_MAX_PROBES : probeCount);
+        for (uint8_t i = 0; i < VOTE_MAX_PROBES; ++i) {
+            state_[i] = ProbeState::Ok;
+            readingC_[i] = NAN;
+            deviationC_[i] = 0.0f;
+            disagreeRun_[i] = 0;
+            driftCount_[i] = 0;
+        }
+    }
+
+    /** Votes on one round of readings, readings[0 .. probeCount() - 1]. */
+    VoteResult update(const float* readings) {
+        VoteResult r;
+        uint8_t idx[VOTE_MAX_PROBES];
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < count_; ++i) {
+            readingC_[i] = readings[i];
+            if (votedOut(i)) continue;
+            if (isSensorFault(readings[i])) {
+                state_[i] = ProbeState::Missing;
+                continue;
+            }
+            state_[i] = ProbeState::Ok;
+            idx[n++] = i;
+        }
+
+        r.healthy = n;
+        if (n < required()) return r;
+        vote(idx, n, r);
+
+        // Score each voting probe against the others
+        float median = r.controlC;
+        uint8_t deviating = 0;
+        uint8_t confirmed = 0;
+        int8_t suspect = -1;
+        for (uint8_t k = 0; k < n; ++k) {
+            uint8_t i = idx[k];
+            float dev = n >= 3 ? std::fabs(readingC_[i] - median) : r.spreadC;
+            deviationC_[i] = dev;
+            if (dev > VOTE_DISAGREE_C) {
+                if (disagreeRun_[i] < VOTE_DISAGREE_READINGS) ++disagreeRun_[i];
+            } else {
+                disagreeRun_[i] = 0;
+            }
+            if (dev > VOTE_DRIFT_C) {
+                ++deviating;
+                driftCount_[i] += 2;
+                if (driftCount_[i] > VOTE_DRIFT_CONFIRM) driftCount_[i] = VOTE_DRIFT_CONFIRM;
+            } else if (driftCount_[i] > 0) {
+                --driftCount_[i];
+            }
+            if (confirmedFault(i)) {
+                ++confirmed;
+                suspect = static_cast<int8_t>(i);
+            }
+        }
+        if (confirmed == 0) return r;
+
+        // A lone outlier among three is voted out and the other two carry on
+        if (n >= 3 && confirmed == 1 && deviating == 1) {
+            uint8_t out = static_cast<uint8_t>(suspect);
+            state_[out] = disagreeRun_[out] >= VOTE_DISAGREE_READINGS ? ProbeState::Disagree
+                                                                     : ProbeState::Drift;
+            uint8_t rest[VOTE_MAX_PROBES];
+            uint8_t m = 0;
+            for (uint8_t k = 0; k < n; ++k) {
+                if (idx[k] != out) rest[m++] = idx[k];
+            }
+            r.healthy = m;
+            r.excluded = suspect;
+            vote(rest, m, r);
+            return r;
+        }
+
+        r.valid = false;
+        r.fault = VoteFault::Disagreement;
+        return r;
+    }
+
+    uint8_t probeCount() const { return count_; }
+
+    /** Probes needed for a valid vote: two whenever more than one is fitted. */
+    uint8_t required() const { return count_ > 1 ? 2 : 1; }
+
+    ProbeState state(uint8_t i) const { return state_[i]; }
+    float reading(uint8_t i) const { return readingC_[i]; }
+
+    /** Distance from the others at the probe's last vote. */
+    float deviation(uint8_t i) const { return deviationC_[i]; }
+
+private:
+    bool votedOut(uint8_t i) const {
+        return state_[i] == ProbeState::Disagree || state_[i] == ProbeState::Drift;
+    }
+
+    bool confirmedFault(uint8_t i) const {
+        return disagreeRun_[i] >= VOTE_DISAGREE_READINGS || driftCount_[i] >= VOTE_DRIFT_CONFIRM;
+    }
+
+    /** Fills the control and trip values from the probes in idx. */
+    void vote(const uint8_t* idx, uint8_t n, VoteResult& r) const {
+        float lo = readingC_[idx[0]];
+        float hi = lo;
+        float sum = lo;
+        for (uint8_t k = 1; k < n; ++k) {
+            float c = readingC_[idx[k]];
+            if (c < lo) lo = c;
+            if (c > hi) hi = c;
+            sum += c;
+        }
+        r.valid = true;
+        r.fault = VoteFault::None;
+        r.spreadC = hi - lo;
+        if (n >= 3) {
+            // Median of three, which is also the 2-out-of-3 trip value
+            r.controlC = sum - lo - hi;
+            r.tripC = r.controlC;
+        } else {
+            r.controlC = sum / n;
+            r.tripC = hi;
+        }
+    }
+
+    uint8_t count_ = 1;
+    ProbeState state_[VOTE_MAX_PROBES] = {};
+    float readingC_[VOTE_MAX_PROBES] = {};
+    float deviationC_[VOTE_MAX_PROBES] = {};
+    uint8_t disagreeRun_[VOTE_MAX_PROBES] = {};
+    uint8_t driftCount_[VOTE_MAX_PROBES] = {};
+};
+
+#endif // SENSOR_VOTING_H
@@ -0,0 +1,121 @@
+/**
+ * session_command.h — Parsing and validation for the batch POST /session
+ * endpoint.
+ *
+ * A session command carries any combination of heater state and target
+ * temperature. Every field is validated (isValidHeaterState,
+ * isValidTargetTemp, canAcceptHeatCommand) before the handler applies
+ * anything, so a request is either applied in full or rejected in full.
+ *
+ * Pure functions with no hardware dependencies — testable on any host.
+ */
+
+#ifndef SESSION_COMMAND_H
+#define SESSION_COMMAND_H
+
+#include "sauna_logic.h"
+#include "http_validation.h"
+
+struct SessionCommand {
+    bool hasState = false;
+    int state = 0;
+    bool hasTemperature = false;
+    float temperature = 0.0f;
+};
+
+enum class SessionCommandResult : uint8_t {
+    Ok,
+    MalformedJson,
+    MalformedCbor,          // Body sent as application/cbor (cbor_codec.h)
+    NoFields,
+    InvalidState,
+    InvalidTemperature,     // Non-numeric value
+    TemperatureOutOfRange,
+    SensorFault,
+};
+
+/**
+ * Parses the optional "state" and "temperature" fields. Only syntax is
+ * checked here — range and safety checks are validateSessionCommand()'s job.
+ */
+inline SessionCommandResult parseSessionCommand(const char* body, SessionCommand& cmd) {
+    char value[24];
+
+    JsonField field = extractJsonField(body, "state", value, sizeof(value));
+    if (field == JsonField::Malformed) return SessionCommandResult::MalformedJson;
+    if (field == JsonField::Found) {
+        if (!parseIntValue(value, cmd.state)) return SessionCommandResult::InvalidState;
+        cmd.hasState = true;
+    }
+
+    field = extractJsonField(body, "temperature", value, sizeof(value));
+    if (field == JsonField::Malformed) return SessionCommandResult::MalformedJson;
+    if (field == JsonField::Found) {
+        if (!parseFloatValue(value, cmd.temperature)) {
+            return SessionCommandResult::InvalidTemperature;
+        }
+        cmd.hasTemperature = true;
+    }
+
+    if (!cmd.hasState && !cmd.hasTemperature) return SessionCommandResult::NoFields;
+    return SessionCommandResult::Ok;
+}
+
+/** Checks every field against the same rules as /heater and /target. */
+inline SessionCommandResult validateSessionCommand(const SessionCommand& cmd, bool sensorFault) {
+    if (cmd.hasState && !isValidHeaterState(cmd.state)) {
+        return SessionCommandResult::InvalidState;
+    }
+    if (cmd.hasTemperature && !isValidTargetTemp(cmd.temperature)) {
+        return SessionCommandResult::TemperatureOutOfRange;
+    }
+    if (cmd.hasState && cmd.state == 1 && !canAcceptHeatCommand(sensorFault)) {
+        return SessionCommandResult::SensorFault;
+    }
+    return SessionCommandResult::Ok;
+}
+
+/**
+ * True for a validated command that turns the heater off. Admission control
+ * never refuses one: a rate limit must not stand between a client and OFF.
+ */
+inline bool isHeaterOffCommand(const SessionCommand& cmd) {
+    return cmd.hasState && cmd.state == 0;
+}
+
+/** HTTP status for a rejected command (200 for Ok). */
+inline int sessionCommandHttpStatus(SessionCommandResult result) {
+    switch (result) {
+        case SessionCommandResult::Ok:          return 200;
+        case SessionCommandResult::SensorFault: return 503;
+        default:                                return 400;
+    }
+}
+
+static_assert(TARGET_TEMP_MIN == 40.0f && TARGET_TEMP_MAX == 100.0f,
+              "Update the range in sessionCommandError() to match");
+
+/** JSON error body for a rejected command — matches the single-field endpoints. */
+inline const char* sessionCommandError(SessionCommandResult result) {
+    switch (result) {
+        case SessionCommandResult::Ok:
+            return "{\"ok\":true}";
+        case SessionCommandResult::MalformedJson:
+            return "{\"error\":\"malformed JSON\"}";
+        case SessionCommandResult::MalformedCbor:
+            return "{\"error\":\"malformed CBOR\"}";
+        case SessionCommandResult::NoFields:
+            return "{\"error\":\"missing 'state' or 'temperature' field\"}";
+        case SessionCommandResult::InvalidState:
+            return "{\"error\":\"invalid state, must be 0 or 1\"}";
+        case SessionCommandResult::InvalidTemperature:
+            return "{\"error\":\"invalid temperature value\"}";
+        case SessionCommandResult::TemperatureOutOfRange:
+            return "{\"error\":\"temperature must be between 40 and 100\"}";
+        case SessionCommandResult::SensorFault:
+            return "{\"error\":\"sensor fault active, cannot enable heater\"}";
+    }
+    return "{\"error\":\"invalid request\"}";
+}
+
+#endif // SESSION_COMMAND_H
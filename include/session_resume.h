@@ -0,0 +1,140 @@
+/**
+ * session_resume.h — Carrying an active session across a reset.
+ *
+ * A brownout when the contactor pulls in, a watchdog reset or a panic
+ * reboots the ESP32 with the heater OFF and sessionStartTime lost. While a
+ * session runs, the firmware checkpoints it into a RetainedSession kept in
+ * RTC slow memory (RTC_NOINIT_ATTR — survives every reset except power-on)
+ * with a checksum. At boot, decideResume() picks between resuming and
+ * starting idle.
+ *
+ * The session limit can never be reset by a crash loop:
+ *   - Elapsed session time is restored, not restarted, plus
+ *     SESSION_RESUME_PENALTY_MS per reset for time the checkpoint missed.
+ *   - After SESSION_MAX_RESUMES resets the session is not resumed at all.
+ *
+ * Resuming only restores targetState/targetTemp — the relay is engaged by
+ * the control job after the first valid reading, as for any HEAT command.
+ *
+ * Pure logic with no hardware dependencies — testable on any host.
+ */
+
+#ifndef SESSION_RESUME_H
+#define SESSION_RESUME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "sauna_logic.h"
+#include "http_validation.h"
+#include "temp_profile.h"
+
+constexpr uint32_t RETAINED_SESSION_MAGIC = 0x53455331;   // "SES1" — change with the layout
+constexpr uint32_t SESSION_RESUME_PENALTY_MS = 5000;       // > checkpoint interval + read time
+constexpr uint8_t SESSION_MAX_RESUMES = 3;
+
+/** Why the chip last reset — the firmware maps esp_reset_reason() onto this. */
+enum class ResetCause : uint8_t {
+    PowerOn,    // RTC memory contents undefined
+    Brownout,
+    Watchdog,   // Task, interrupt or RTC watchdog
+    Panic,
+    Software,   // esp_restart(), e.g. after OTA
+    External,   // EN pin
+    Unknown,    // Anything else (deep sleep, SDIO, ...) — treated like PowerOn
+};
+
+/** Session checkpoint kept in RTC slow memory. */
+struct RetainedSession {
+    uint32_t magic;
+    uint32_t elapsedMs;        // Session time used at the last checkpoint
+    float targetC;
+    uint8_t resumes;           // Resets this session has already survived
+    bool profileActive;
+    ProfileRunnerState profile;
+    uint32_t checksum;         // FNV-1a over everything above
+};
+
+// A constructor would run at every boot and overwrite the retained bytes
+static_assert(std::is_trivial<RetainedSession>::value, "RetainedSession must stay trivial");
+
+inline uint32_t retainedSessionChecksum(const RetainedSession& r) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&r);
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(RetainedSession, checksum); ++i) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+/** Writes a checkpoint. profile is null when no profile is running. */
+inline void retainSession(RetainedSession& r, uint32_t elapsedMs, float targetC, uint8_t resumes,
+                          const ProfileRunnerState* profile) {
+    r.magic = RETAINED_SESSION_MAGIC;
+    r.elapsedMs = elapsedMs;
+    r.targetC = targetC;
+    r.resumes = resumes;
+    r.profileActive = profile != nullptr;
+    if (profile) r.profile = *profile;
+    r.checksum = retainedSessionChecksum(r);
+}
+
+inline void clearRetainedSession(RetainedSession& r) {
+    r.magic = 0;
+    r.checksum = 0;
+}
+
+/** Session time to credit on resume: the checkpoint plus the per-reset penalty. */
+inline uint32_t resumedElapsedMs(const RetainedSession& r) {
+    uint32_t room = UINT32_MAX - r.elapsedMs;
+    return SESSION_RESUME_PENALTY_MS > room ? UINT32_MAX : r.elapsedMs + SESSION_RESUME_PENALTY_MS;
+}
+
+enum class ResumeDecision : uint8_t {
+    Resume,
+    PowerOn,          // Cold boot — retained memory ignored
+    NoSession,        // No session was running at the reset
+    Corrupt,          // Checksum or field check failed
+    TooManyResumes,   // SESSION_MAX_RESUMES reached
+    LimitReached,     // Restored elapsed time would meet SESSION_MAX_MS
+};
+
+inline const char* resumeDecisionName(ResumeDecision decision) {
+    switch (decision) {
+        case ResumeDecision::Resume:         return "resume";
+        case ResumeDecision::PowerOn:        return "power_on";
+        case ResumeDecision::NoSession:      return "no_session";
+        case ResumeDecision::Corrupt:        return "corrupt";
+        case ResumeDecision::TooManyResumes: return "too_many_resumes";
+        case ResumeDecision::LimitReached:   return "limit_reached";
+    }
+    return "unknown";
+}
+
+/** Field checks beyond the checksum — a resumed profile indexes its segments. */
+inline bool isRetainedProfileValid(const ProfileRunnerState& st) {
+    if (st.profile.count == 0 || st.profile.count > PROFILE_MAX_SEGMENTS) return false;
+    if (st.segment >= st.profile.count) return false;
+    if (st.phase != ProfilePhase::Ramp && st.phase != ProfilePhase::Settle &&
+        st.phase != ProfilePhase::Hold) {
+        return false;
+    }
+    for (uint8_t i = 0; i < st.profile.count; ++i) {
+        if (!isValidTargetTemp(st.profile.segments[i].holdC)) return false;
+    }
+    return isValidTargetTemp(st.setpointC) && isValidTargetTemp(st.rampFromC);
+}
+
+inline ResumeDecision decideResume(ResetCause cause, const RetainedSession& r) {
+    if (cause == ResetCause::PowerOn || cause == ResetCause::Unknown) return ResumeDecision::PowerOn;
+    if (r.magic != RETAINED_SESSION_MAGIC) return ResumeDecision::NoSession;
+    if (r.checksum != retainedSessionChecksum(r)) return ResumeDecision::Corrupt;
+    if (!isValidTargetTemp(r.targetC)) return ResumeDecision::Corrupt;
+    if (r.profileActive && !isRetainedProfileValid(r.profile)) return ResumeDecision::Corrupt;
+    if (r.resumes >= SESSION_MAX_RESUMES) return ResumeDecision::TooManyResumes;
+    if (resumedElapsedMs(r) >= SESSION_MAX_MS) return ResumeDecision::LimitReached;
+    return ResumeDecision::Resume;
+}
+
+#endif // SESSION_RESUME_H
@@ -0,0 +1,224 @@
+/**
+ * session_stats.h — Incremental per-session statistics and a fixed-size
+ * session journal (GET /sessions).
+ *
+ * SessionAggregator folds each temperature sample into running aggregates
+ * as it arrives — O(1) memory however long the session runs. Time-based
+ * figures (in-band time, relay duty) use sample-and-hold: the interval up
+ * to the next sample is credited to the previous sample's temperature and
+ * relay state, which is exactly what the 2 s read cycle controls on.
+ *
+ * Finished sessions are packed into SessionRecord (temperatures in tenths
+ * of a degree) and kept in a SessionJournal of the last N sessions.
+ *
+ * Times are millis() values (device uptime). Pure logic, no hardware
+ * dependencies — testable on any host.
+ */
+
+#ifndef SESSION_STATS_H
+#define SESSION_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+constexpr float SESSION_TARGET_BAND_C = 2.0f;         // "At temperature" = within ±2 °C
+constexpr uint32_t SESSION_TARGET_NOT_REACHED = 0xFFFFFFFFu;
+
+enum class SessionEndReason : uint8_t {
+    User,              // OFF from HomeKit or REST
+    Timeout,           // SESSION_MAX_MINUTES reached
+    SensorFault,
+    OverTemperature,
+    ProfileComplete,   // Last segment of a temperature profile finished
+};
+
+inline const char* sessionEndReasonName(SessionEndReason reason) {
+    switch (reason) {
+        case SessionEndReason::User:            return "user";
+        case SessionEndReason::Timeout:         return "timeout";
+        case SessionEndReason::SensorFault:     return "fault";
+        case SessionEndReason::OverTemperature: return "over_temp";
+        case SessionEndReason::ProfileComplete: return "profile";
+    }
+    return "unknown";
+}
+
+/** One session, packed for the journal (32 bytes). */
+struct SessionRecord {
+    uint32_t startMs;
+    uint32_t endMs;
+    uint32_t timeToTargetMs;   // SESSION_TARGET_NOT_REACHED if never within band
+    uint32_t inBandMs;         // Time within ±SESSION_TARGET_BAND_C of target
+    uint32_t heaterOnMs;       // Time the relay was closed
+    int16_t targetDeciC;       // Target at session end
+    int16_t minDeciC;
+    int16_t maxDeciC;
+    int16_t meanDeciC;
+    uint16_t samples;
+    SessionEndReason reason;
+};
+
+inline int16_t toDeciC(float c) {
+    float scaled = c * 10.0f;
+    return static_cast<int16_t>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+}
+
+class SessionAggregator {
+public:
+    /** Begins a session. Any session in progress is discarded. */
+    void start(uint32_t nowMs, float targetC) {
+        active_ = true;
+        startMs_ = nowMs;
+        targetC_ = targetC;
+        samples_ = 0;
+        lastSampleMs_ = nowMs;
+        lastInBand_ = false;
+        lastHeaterOn_ = false;
+        timeToTargetMs_ = SESSION_TARGET_NOT_REACHED;
+        inBandMs_ = 0;
+        heaterOnMs_ = 0;
+        minC_ = maxC_ = meanC_ = 0.0f;
+    }
+
+    bool active() const { return active_; }
+
+    /**
+     * Folds in one reading. heaterOn is the relay state after the control
+     * decision for this reading — it holds until the next sample.
+     */
+    void addSample(uint32_t nowMs, float tempC, float targetC, bool heaterOn) {
+        if (!active_) return;
+        accumulate(nowMs);
+        targetC_ = targetC;
+
+        if (samples_ == 0) {
+            minC_ = maxC_ = meanC_ = tempC;
+        } else {
+            if (tempC < minC_) minC_ = tempC;
+            if (tempC > maxC_) maxC_ = tempC;
+        }
+        if (samples_ < UINT16_MAX) ++samples_;
+        meanC_ += (tempC - meanC_) / samples_;   // Running mean, no sum to overflow
+
+        float diff = tempC - targetC;
+        lastInBand_ = diff >= -SESSION_TARGET_BAND_C && diff <= SESSION_TARGET_BAND_C;
+        if (timeToTargetMs_ == SESSION_TARGET_NOT_REACHED && diff >= -SESSION_TARGET_BAND_C) {
+            timeToTargetMs_ = nowMs - startMs_;
+        }
+        lastHeaterOn_ = heaterOn;
+    }
+
+    /** Ends the session and returns its record. */
+    SessionRecord finish(uint32_t nowMs, SessionEndReason reason) {
+        SessionRecord r = snapshot(nowMs);
+        r.reason = reason;
+        active_ = false;
+        return r;
+    }
+
+    /** Record of the session so far, as if it ended now (for GET /sessions). */
+    SessionRecord snapshot(uint32_t nowMs) const {
+        uint32_t tail = active_ ? nowMs - lastSampleMs_ : 0;
+        SessionRecord r;
+        r.startMs = startMs_;
+        r.endMs = nowMs;
+        r.timeToTargetMs = timeToTargetMs_;
+        r.inBandMs = inBandMs_ + (lastInBand_ ? tail : 0);
+        r.heaterOnMs = heaterOnMs_ + (lastHeaterOn_ ? tail : 0);
+        r.targetDeciC = toDeciC(targetC_);
+        r.minDeciC = toDeciC(minC_);
+        r.maxDeciC = toDeciC(maxC_);
+        r.meanDeciC = toDeciC(meanC_);
+        r.samples = samples_;
+        r.reason = SessionEndReason::User;
+        return r;
+    }
+
+private:
+    void accumulate(uint32_t nowMs) {
+        uint32_t dt = nowMs - lastSampleMs_;
+        if (lastInBand_) inBandMs_ += dt;
+        if (lastHeaterOn_) heaterOnMs_ += dt;
+        lastSampleMs_ = nowMs;
+    }
+
+    bool active_ = false;
+    uint32_t startMs_ = 0;
+    float targetC_ = 0.0f;
+    uint16_t samples_ = 0;
+    uint32_t lastSampleMs_ = 0;
+    bool lastInBand_ = false;
+    bool lastHeaterOn_ = false;
+    uint32_t timeToTargetMs_ = SESSION_TARGET_NOT_REACHED;
+    uint32_t inBandMs_ = 0;
+    uint32_t heaterOnMs_ = 0;
+    float minC_ = 0.0f;
+    float maxC_ = 0.0f;
+    float meanC_ = 0.0f;
+};
+
+/** The last N finished sessions, oldest overwritten first. */
+template <uint8_t N>
+class SessionJournal {
+public:
+    void add(const SessionRecord& r) {
+        records_[total_ % N] = r;
+        ++total_;
+    }
+
+    /** Sessions currently retained. */
+    uint8_t count() const { return total_ < N ? static_cast<uint8_t>(total_) : N; }
+
+    /** Sessions finished since boot — also the id the next one will get. */
+    uint32_t total() const { return total_; }
+
+    /** i = 0 is the newest retained session. Returns false past count(). */
+    bool newest(uint8_t i, SessionRecord& out, uint32_t& id) const {
+        if (i >= count()) return false;
+        id = total_ - 1 - i;
+        out = records_[id % N];
+        return true;
+    }
+
+private:
+    SessionRecord records_[N];
+    uint32_t total_ = 0;
+};
+
+/**
+ * Renders one GET /sessions element. Durations in seconds; temperatures are
+ * null before the first sample, and "end" is null for the session in
+ * progress. A heaterPowerW above zero adds "energy_kwh" (relay on-time ×
+ * power). Returns snprintf()'s result.
+ */
+inline int formatSessionJson(const SessionRecord& r, uint32_t id, bool inProgress,
+                             char* buf, size_t len, float heaterPowerW = 0.0f) {
+    char reached[12] = "null";
+    if (r.timeToTargetMs != SESSION_TARGET_NOT_REACHED) {
+        std::snprintf(reached, sizeof(reached), "%u", static_cast<unsigned>(r.timeToTargetMs / 1000));
+    }
+    char temps[64] = "\"min\":null,\"max\":null,\"mean\":null";
+    if (r.samples > 0) {
+        std::snprintf(temps, sizeof(temps), "\"min\":%.1f,\"max\":%.1f,\"mean\":%.1f",
+                      r.minDeciC / 10.0, r.maxDeciC / 10.0, r.meanDeciC / 10.0);
+    }
+    char end[16] = "null";
+    if (!inProgress) std::snprintf(end, sizeof(end), "\"%s\"", sessionEndReasonName(r.reason));
+    char energy[32] = "";
+    if (heaterPowerW > 0.0f) {
+        std::snprintf(energy, sizeof(energy), "\"energy_kwh\":%.3f,",
+                      static_cast<double>(r.heaterOnMs) * heaterPowerW / 3.6e9);
+    }
+
+    uint32_t durationMs = r.endMs - r.startMs;
+    double duty = durationMs > 0 ? 100.0 * r.heaterOnMs / durationMs : 0.0;
+    return std::snprintf(buf, len,
+        "{\"id\":%u,\"start_ms\":%u,\"end_ms\":%u,\"duration_s\":%u,\"target\":%.1f,"
+        "\"time_to_target_s\":%s,%s,\"in_band_s\":%u,\"duty_pct\":%.1f,%s\"samples\":%u,\"end\":%s}",
+        static_cast<unsigned>(id), static_cast<unsigned>(r.startMs), static_cast<unsigned>(r.endMs),
+        static_cast<unsigned>(durationMs / 1000), r.targetDeciC / 10.0, reached, temps,
+        static_cast<unsigned>(r.inBandMs / 1000), duty, energy, static_cast<unsigned>(r.samples), end);
+}
+
+#endif // SESSION_STATS_H
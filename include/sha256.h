@@ -0,0 +1,112 @@
+/**
+ * sha256.h — Incremental SHA-256 (FIPS 180-4).
+ *
+ * Portable so the delta OTA applier can verify images identically on the
+ * ESP32 and in native tests. ~100 bytes of state, no allocation.
+ *
+ * Hardware-independent — testable on any host.
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+constexpr size_t SHA256_DIGEST_SIZE = 32;
+
+struct Sha256 {
+    uint32_t state[8];
+    uint64_t totalBytes;
+    uint8_t block[64];
+    size_t blockLen;
+};
+
+inline uint32_t sha256Rotr(uint32_t x, unsigned n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+inline void sha256Compress(Sha256& ctx, const uint8_t* p) {
+    static const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (static_cast<uint32_t>(p[4 * i]) << 24) | (static_cast<uint32_t>(p[4 * i + 1]) << 16) |
+               (static_cast<uint32_t>(p[4 * i + 2]) << 8) | static_cast<uint32_t>(p[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = sha256Rotr(w[i - 15], 7) ^ sha256Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = sha256Rotr(w[i - 2], 17) ^ sha256Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = ctx.state[0], b = ctx.state[1], c = ctx.state[2], d = ctx.state[3];
+    uint32_t e = ctx.state[4], f = ctx.state[5], g = ctx.state[6], h = ctx.state[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t S1 = sha256Rotr(e, 6) ^ sha256Rotr(e, 11) ^ sha256Rotr(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + S1 + ch + K[i] + w[i];
+        uint32_t S0 = sha256Rotr(a, 2) ^ sha256Rotr(a, 13) ^ sha256Rotr(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = S0 + maj;
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    ctx.state[0] += a; ctx.state[1] += b; ctx.state[2] += c; ctx.state[3] += d;
+    ctx.state[4] += e; ctx.state[5] += f; ctx.state[6] += g; ctx.state[7] += h;
+}
+
+inline void sha256Init(Sha256& ctx) {
+    static const uint32_t H0[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    std::memcpy(ctx.state, H0, sizeof(H0));
+    ctx.totalBytes = 0;
+    ctx.blockLen = 0;
+}
+
+inline void sha256Update(Sha256& ctx, const uint8_t* data, size_t len) {
+    ctx.totalBytes += len;
+    while (len > 0) {
+        size_t take = 64 - ctx.blockLen;
+        if (take > len) take = len;
+        std::memcpy(ctx.block + ctx.blockLen, data, take);
+        ctx.blockLen += take;
+        data += take;
+        len -= take;
+        if (ctx.blockLen == 64) {
+            sha256Compress(ctx, ctx.block);
+            ctx.blockLen = 0;
+        }
+    }
+}
+
+inline void sha256Final(Sha256& ctx, uint8_t out[SHA256_DIGEST_SIZE]) {
+    uint64_t bits = ctx.totalBytes * 8;
+    uint8_t pad = 0x80;
+    sha256Update(ctx, &pad, 1);
+    pad = 0x00;
+    while (ctx.blockLen != 56) sha256Update(ctx, &pad, 1);
+    uint8_t len[8];
+    for (int i = 0; i < 8; ++i) len[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+    sha256Update(ctx, len, 8);
+    for (int i = 0; i < 8; ++i) {
+        out[4 * i]     = static_cast<uint8_t>(ctx.state[i] >> 24);
+        out[4 * i + 1] = static_cast<uint8_t>(ctx.state[i] >> 16);
+        out[4 * i + 2] = static_cast<uint8_t>(ctx.state[i] >> 8);
+        out[4 * i + 3] = static_cast<uint8_t>(ctx.state[i]);
+    }
+}
+
+#endif // SHA256_H
@@ -0,0 +1,86 @@
+/**
+ * status_report.h — The GET /status document, decoupled from where its
+ * values live.
+ *
+ * The firmware fills a StatusReport from the thermostat, the profile
+ * runner and the probe vote; formatStatusJson() renders it, and
+ * encodeStatusCbor() (cbor_codec.h) encodes the same fields for clients
+ * that ask for CBOR. Keeping both renderings on one struct keeps them in
+ * step and lets the native tests compare them.
+ *
+ * Pure logic with no hardware dependencies — testable on any host.
+ */
+
+#ifndef STATUS_REPORT_H
+#define STATUS_REPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "sauna_logic.h"
+#include "sensor_voting.h"
+#include "temp_profile.h"
+
+struct ProbeReport {
+    float c = NAN;             // Last reading; isSensorFault() values render as null
+    float dev = 0.0f;
+    ProbeState state = ProbeState::Ok;
+};
+
+struct StatusReport {
+    float currentC = 0.0f;
+    float targetC = 0.0f;
+    bool heating = false;
+    const char* firmware = "";
+
+    bool profileRunning = false;
+    uint8_t segment = 0;
+    uint8_t segments = 0;
+    ProfilePhase phase = ProfilePhase::Idle;
+    uint32_t segmentRemainingS = 0;
+    uint32_t remainingS = 0;
+
+    uint8_t probeCount = 0;
+    ProbeReport probes[VOTE_MAX_PROBES];
+};
+
+constexpr size_t STATUS_JSON_SIZE = 384;
+
+/** Renders the GET /status body. Returns the length, or 0 if it did not fit. */
+inline size_t formatStatusJson(const StatusReport& s, char* json, size_t len) {
+    char profile[128] = "null";
+    if (s.profileRunning) {
+        std::snprintf(profile, sizeof(profile),
+            "{\"segment\":%u,\"segments\":%u,\"phase\":\"%s\","
+            "\"segment_remaining_s\":%u,\"remaining_s\":%u}",
+            static_cast<unsigned>(s.segment),
+            static_cast<unsigned>(s.segments),
+            profilePhaseName(s.phase),
+            static_cast<unsigned>(s.segmentRemainingS),
+            static_cast<unsigned>(s.remainingS));
+    }
+    // Per-probe health; a probe that did not answer has no temperature
+    char probes[VOTE_MAX_PROBES * 48 + 2] = "[";
+    size_t used = 1;
+    for (uint8_t i = 0; i < s.probeCount && i < VOTE_MAX_PROBES; ++i) {
+        char c[12] = "null";
+        if (!isSensorFault(s.probes[i].c)) std::snprintf(c, sizeof(c), "%.1f", s.probes[i].c);
+        used += std::snprintf(probes + used, sizeof(probes) - used,
+                              "%s{\"c\":%s,\"dev\":%.1f,\"state\":\"%s\"}",
+                              i ? "," : "", c, s.probes[i].dev, probeStateName(s.probes[i].state));
+    }
+    std::snprintf(probes + used, sizeof(probes) - used, "]");
+    int n = std::snprintf(json, len,
+        "{\"current_temp\":%.1f,\"target_temp\":%.1f,\"heating\":%s,\"firmware\":\"%s\","
+        "\"profile\":%s,\"probes\":%s}",
+        s.currentC,
+        s.targetC,
+        s.heating ? "true" : "false",
+        s.firmware,
+        profile,
+        probes);
+    return n > 0 && static_cast<size_t>(n) < len ? static_cast<size_t>(n) : 0;
+}
+
+#endif // STATUS_REPORT_H
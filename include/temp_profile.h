@@ -0,0 +1,354 @@
+/**
+ * temp_profile.h — Ramp/soak temperature profiles (POST /profile).
+ *
+ * A profile is a sequence of up to PROFILE_MAX_SEGMENTS segments. Each
+ * segment ramps the control setpoint from where the previous one left it
+ * to its hold temperature at a fixed rate, then holds for a duration:
+ *
+ *     "<rate °C/min>:<hold °C>:<hold min>[;...]"    e.g. "0:80:15;1:90:10;0:75:20"
+ *
+ * Rate 0 steps the setpoint immediately. When a segment heats (hold above
+ * the previous setpoint) the hold timer starts only once the measured
+ * temperature is within SESSION_TARGET_BAND_C — a fast heat-up does not
+ * eat the soak. Cooling segments start their hold when the setpoint
+ * arrives.
+ *
+ * Every hold temperature must be within TARGET_TEMP_MIN/MAX, and the
+ * planned time (ramps plus holds) must fit SESSION_MAX_MINUTES. The
+ * session limit is still enforced on its own and ends the profile if
+ * waiting for the room to heat overruns the plan.
+ *
+ * Pure logic with no hardware dependencies — testable with a fake clock.
+ */
+
+#ifndef TEMP_PROFILE_H
+#define TEMP_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "sauna_logic.h"
+#include "http_validation.h"
+#include "session_stats.h"
+
+constexpr uint8_t PROFILE_MAX_SEGMENTS = 8;
+constexpr float PROFILE_MAX_RATE_C_PER_MIN = 10.0f;
+
+struct ProfileSegment {
+    float rateCPerMin;   // 0 = step
+    float holdC;
+    uint16_t holdMin;
+};
+
+/** Kept trivial (no initialisers) so it can live in RTC memory — see session_resume.h. */
+struct TempProfile {
+    ProfileSegment segments[PROFILE_MAX_SEGMENTS];
+    uint8_t count;
+};
+
+enum class ProfileResult : uint8_t {
+    Ok,
+    MalformedJson,
+    Empty,
+    Malformed,
+    TooManySegments,
+    RateOutOfRange,
+    TemperatureOutOfRange,
+    HoldTooLong,
+    TooLong,           // Planned time exceeds what is left of the session limit
+    SensorFault,
+};
+
+inline int profileHttpStatus(ProfileResult result) {
+    switch (result) {
+        case ProfileResult::Ok:          return 200;
+        case ProfileResult::SensorFault: return 503;
+        default:                         return 400;
+    }
+}
+
+inline const char* profileError(ProfileResult result) {
+    switch (result) {
+        case ProfileResult::Ok:                    return "{\"ok\":true}";
+        case ProfileResult::MalformedJson:         return "{\"error\":\"malformed JSON\"}";
+        case ProfileResult::Empty:                 return "{\"error\":\"missing 'profile' segments\"}";
+        case ProfileResult::Malformed:             return "{\"error\":\"segment must be rate:temperature:minutes\"}";
+        case ProfileResult::TooManySegments:       return "{\"error\":\"at most 8 segments\"}";
+        case ProfileResult::RateOutOfRange:        return "{\"error\":\"rate must be between 0 and 10 C/min\"}";
+        case ProfileResult::TemperatureOutOfRange: return "{\"error\":\"temperature must be between 40 and 100\"}";
+        case ProfileResult::HoldTooLong:           return "{\"error\":\"hold must be a whole number of minutes up to 60\"}";
+        case ProfileResult::TooLong:               return "{\"error\":\"profile does not fit in the remaining session time\"}";
+        case ProfileResult::SensorFault:           return "{\"error\":\"sensor fault active, cannot enable heater\"}";
+    }
+    return "{\"error\":\"invalid profile\"}";
+}
+
+static_assert(TARGET_TEMP_MIN == 40.0f && TARGET_TEMP_MAX == 100.0f,
+              "profileError() text must match TARGET_TEMP_MIN/MAX");
+static_assert(SESSION_MAX_MINUTES == 60, "profileError() hold text must match SESSION_MAX_MINUTES");
+static_assert(PROFILE_MAX_SEGMENTS == 8, "profileError() text must match PROFILE_MAX_SEGMENTS");
+
+/** Parses the compact segment list (no surrounding quotes). Checks syntax and ranges. */
+inline ProfileResult parseProfile(const char* text, TempProfile& out) {
+    out.count = 0;
+    if (!text) return ProfileResult::Empty;
+    const char* p = text;
+    while (*p == ' ') ++p;
+    if (*p == '\0') return ProfileResult::Empty;
+
+    for (;;) {
+        if (out.count == PROFILE_MAX_SEGMENTS) return ProfileResult::TooManySegments;
+        char* end = nullptr;
+        float rate = std::strtof(p, &end);
+        if (end == p || *end != ':') return ProfileResult::Malformed;
+        p = end + 1;
+        float hold = std::strtof(p, &end);
+        if (end == p || *end != ':') return ProfileResult::Malformed;
+        p = end + 1;
+        long minutes = std::strtol(p, &end, 10);
+        if (end == p) return ProfileResult::Malformed;
+        p = end;
+        while (*p == ' ') ++p;
+        if (*p != ';' && *p != '\0') return ProfileResult::Malformed;
+
+        // NaN fails every comparison, so test for the valid range
+        if (!(rate >= 0.0f && rate <= PROFILE_MAX_RATE_C_PER_MIN)) return ProfileResult::RateOutOfRange;
+        if (!isValidTargetTemp(hold)) return ProfileResult::TemperatureOutOfRange;
+        if (minutes < 0 || minutes > static_cast<long>(SESSION_MAX_MINUTES)) return ProfileResult::HoldTooLong;
+
+        ProfileSegment& s = out.segments[out.count++];
+        s.rateCPerMin = rate;
+        s.holdC = hold;
+        s.holdMin = static_cast<uint16_t>(minutes);
+
+        if (*p == '\0') return ProfileResult::Ok;
+        ++p;   // past ';'
+        while (*p == ' ') ++p;
+        if (*p == '\0') return ProfileResult::Ok;   // Trailing ';'
+    }
+}
+
+/** Parses a POST /profile body: {"profile":"<segments>"}. */
+inline ProfileResult parseProfileCommand(const char* body, TempProfile& out) {
+    out.count = 0;
+    char value[160];
+    JsonField f = extractJsonField(body, "profile", value, sizeof(value));
+    if (f == JsonField::Missing) return ProfileResult::Empty;
+    if (f == JsonField::Malformed) return ProfileResult::MalformedJson;
+
+    // The field value is a JSON string — strip whitespace and the quotes
+    char* start = value;
+    while (*start == ' ' || *start == '\t' || *start == '\n' || *start == '\r') ++start;
+    size_t len = std::strlen(start);
+    while (len > 0 && (start[len - 1] == ' ' || start[len - 1] == '\t' ||
+                       start[len - 1] == '\n' || start[len - 1] == '\r')) {
+        --len;
+    }
+    if (len < 2 || start[0] != '"' || start[len - 1] != '"') return ProfileResult::MalformedJson;
+    start[len - 1] = '\0';
+    return parseProfile(start + 1, out);
+}
+
+/** Clamps a temperature into the settable range — where a profile's setpoint starts. */
+inline float profileStartSetpoint(float measuredC) {
+    if (!(measuredC >= TARGET_TEMP_MIN)) return TARGET_TEMP_MIN;
+    if (measuredC > TARGET_TEMP_MAX) return TARGET_TEMP_MAX;
+    return measuredC;
+}
+
+inline uint32_t profileRampMs(float fromC, float toC, float rateCPerMin) {
+    if (rateCPerMin <= 0.0f) return 0;
+    float delta = toC > fromC ? toC - fromC : fromC - toC;
+    return static_cast<uint32_t>(delta / rateCPerMin * 60000.0f + 0.5f);
+}
+
+/** Planned duration (ramps + holds, no heat-up waits) starting from startSetpointC. */
+inline uint32_t profilePlannedMs(const TempProfile& profile, float startSetpointC) {
+    uint64_t total = 0;
+    float setpoint = startSetpointC;
+    for (uint8_t i = 0; i < profile.count; ++i) {
+        const ProfileSegment& s = profile.segments[i];
+        total += profileRampMs(setpoint, s.holdC, s.rateCPerMin);
+        total += static_cast<uint64_t>(s.holdMin) * 60000ULL;
+        setpoint = s.holdC;
+    }
+    return total > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(total);
+}
+
+/**
+ * Full check before starting. availableMs is the session time left: the
+ * whole SESSION_MAX_MS for a new session, less for one already running —
+ * a profile never extends the session limit.
+ */
+inline ProfileResult validateProfileStart(const TempProfile& profile, float startSetpointC,
+                                          uint32_t availableMs, bool sensorFault) {
+    if (profile.count == 0) return ProfileResult::Empty;
+    if (profilePlannedMs(profile, startSetpointC) > availableMs) return ProfileResult::TooLong;
+    if (!canAcceptHeatCommand(sensorFault)) return ProfileResult::SensorFault;
+    return ProfileResult::Ok;
+}
+
+// =============================================================================
+// Runner
+// =============================================================================
+
+enum class ProfilePhase : uint8_t {
+    Idle,
+    Ramp,       // Setpoint moving toward the hold temperature
+    Settle,     // Setpoint at hold, waiting for the room to come within band
+    Hold,
+    Done,
+};
+
+inline const char* profilePhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::Idle:   return "idle";
+        case ProfilePhase::Ramp:   return "ramp";
+        case ProfilePhase::Settle: return "settle";
+        case ProfilePhase::Hold:   return "hold";
+        case ProfilePhase::Done:   return "done";
+    }
+    return "unknown";
+}
+
+/** A runner's position, for carrying a profile across a reset (session_resume.h). */
+struct ProfileRunnerState {
+    TempProfile profile;
+    float setpointC;
+    float rampFromC;
+    uint32_t phaseElapsedMs;   // Time into the current ramp or hold
+    ProfilePhase phase;
+    uint8_t segment;
+    bool heating;
+};
+
+class ProfileRunner {
+public:
+    /** Starts a validated profile; the setpoint ramps from startSetpointC. */
+    void start(const TempProfile& profile, uint32_t nowMs, float startSetpointC) {
+        profile_ = profile;
+        setpoint_ = startSetpointC;
+        enterSegment(0, nowMs);
+    }
+
+    void stop() { phase_ = ProfilePhase::Idle; }
+
+    bool running() const {
+        return phase_ == ProfilePhase::Ramp || phase_ == ProfilePhase::Settle ||
+               phase_ == ProfilePhase::Hold;
+    }
+
+    /** True from the end of the last hold until stop() — the caller ends the session. */
+    bool finished() const { return phase_ == ProfilePhase::Done; }
+
+    /** Advances to nowMs with the latest reading. Returns the setpoint to control to. */
+    float update(uint32_t nowMs, float measuredC) {
+        // Loop so that a long gap between updates can cross several segments
+        for (uint8_t guard = 0; guard <= 2 * PROFILE_MAX_SEGMENTS && running(); ++guard) {
+            const ProfileSegment& s = profile_.segments[segment_];
+            if (phase_ == ProfilePhase::Ramp) {
+                uint32_t rampMs = profileRampMs(rampFromC_, s.holdC, s.rateCPerMin);
+                uint32_t elapsed = nowMs - phaseStartMs_;
+                if (elapsed < rampMs) {
+                    float moved = s.rateCPerMin * elapsed / 60000.0f;
+                    setpoint_ = s.holdC > rampFromC_ ? rampFromC_ + moved : rampFromC_ - moved;
+                    break;
+                }
+                setpoint_ = s.holdC;
+                phaseStartMs_ += rampMs;
+                phase_ = heating_ ? ProfilePhase::Settle : ProfilePhase::Hold;
+            } else if (phase_ == ProfilePhase::Settle) {
+                if (!(measuredC >= s.holdC - SESSION_TARGET_BAND_C)) break;
+                phaseStartMs_ = nowMs;
+                phase_ = ProfilePhase::Hold;
+            } else {
+                uint32_t holdMs = static_cast<uint32_t>(s.holdMin) * 60000UL;
+                if (nowMs - phaseStartMs_ < holdMs) break;
+                uint32_t holdEnd = phaseStartMs_ + holdMs;
+                if (segment_ + 1 >= profile_.count) {
+                    phase_ = ProfilePhase::Done;
+                    break;
+                }
+                enterSegment(segment_ + 1, holdEnd);
+            }
+        }
+        return setpoint_;
+    }
+
+    ProfileRunnerState save(uint32_t nowMs) const {
+        ProfileRunnerState st;
+        st.profile = profile_;
+        st.setpointC = setpoint_;
+        st.rampFromC = rampFromC_;
+        st.phaseElapsedMs = nowMs - phaseStartMs_;
+        st.phase = phase_;
+        st.segment = segment_;
+        st.heating = heating_;
+        return st;
+    }
+
+    /** Continues a saved profile; the current phase resumes at nowMs. */
+    void restore(const ProfileRunnerState& st, uint32_t nowMs) {
+        profile_ = st.profile;
+        setpoint_ = st.setpointC;
+        rampFromC_ = st.rampFromC;
+        phaseStartMs_ = nowMs - st.phaseElapsedMs;
+        phase_ = st.phase;
+        segment_ = st.segment;
+        heating_ = st.heating;
+    }
+
+    float setpoint() const { return setpoint_; }
+    ProfilePhase phase() const { return phase_; }
+    uint8_t segment() const { return segment_; }
+    uint8_t segmentCount() const { return profile_.count; }
+
+    /** Time left in the current segment as planned (a Settle wait counts as 0). */
+    uint32_t segmentRemainingMs(uint32_t nowMs) const {
+        if (!running()) return 0;
+        const ProfileSegment& s = profile_.segments[segment_];
+        uint32_t holdMs = static_cast<uint32_t>(s.holdMin) * 60000UL;
+        uint32_t elapsed = nowMs - phaseStartMs_;
+        if (phase_ == ProfilePhase::Ramp) {
+            uint32_t rampMs = profileRampMs(rampFromC_, s.holdC, s.rateCPerMin);
+            return (elapsed < rampMs ? rampMs - elapsed : 0) + holdMs;
+        }
+        if (phase_ == ProfilePhase::Settle) return holdMs;
+        return elapsed < holdMs ? holdMs - elapsed : 0;
+    }
+
+    /** Planned time left in the whole profile. */
+    uint32_t remainingMs(uint32_t nowMs) const {
+        if (!running()) return 0;
+        uint64_t total = segmentRemainingMs(nowMs);
+        float from = profile_.segments[segment_].holdC;
+        for (uint8_t i = segment_ + 1; i < profile_.count; ++i) {
+            const ProfileSegment& s = profile_.segments[i];
+            total += profileRampMs(from, s.holdC, s.rateCPerMin);
+            total += static_cast<uint64_t>(s.holdMin) * 60000ULL;
+            from = s.holdC;
+        }
+        return total > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(total);
+    }
+
+private:
+    void enterSegment(uint8_t index, uint32_t startMs) {
+        segment_ = index;
+        rampFromC_ = setpoint_;
+        heating_ = profile_.segments[index].holdC > rampFromC_;
+        phaseStartMs_ = startMs;
+        phase_ = ProfilePhase::Ramp;
+    }
+
+    TempProfile profile_;
+    ProfilePhase phase_ = ProfilePhase::Idle;
+    uint8_t segment_ = 0;
+    float setpoint_ = TARGET_TEMP_MIN;
+    float rampFromC_ = TARGET_TEMP_MIN;
+    bool heating_ = false;
+    uint32_t phaseStartMs_ = 0;
+};
+
+#endif // TEMP_PROFILE_H
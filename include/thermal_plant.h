@@ -0,0 +1,63 @@
+/**
+ * thermal_plant.h — Lumped thermal model of a sauna room and its probe.
+ *
+ * Used by the host emulator to stand in for the heater, room and DS18B20,
+ * and by native tests that need a realistic temperature trace. Not used by
+ * the ESP32 build.
+ *
+ * Model (single thermal mass, Newtonian loss, first-order probe lag):
+ *
+ *   C · dT/dt  = P · on − k · (T − T_ambient)
+ *   τs · dS/dt = T − S
+ *
+ * The defaults approximate a 7 kW heater in a barrel sauna: ~45 min from
+ * 20 °C to 80 °C, and a ~130 °C ceiling if the heater were never switched
+ * off (well above TEMP_MAX_CELSIUS, so the safety limit is reachable).
+ *
+ * Hardware-independent — testable on any host.
+ */
+
+#ifndef THERMAL_PLANT_H
+#define THERMAL_PLANT_H
+
+#include <cmath>
+
+struct ThermalPlantParams {
+    float heaterPowerW       = 7000.0f;    // Electrical = thermal power when ON
+    float lossWPerC          = 64.0f;      // Envelope loss coefficient k
+    float heatCapacityJPerC  = 219000.0f;  // Air, rocks, wood — lumped C
+    float ambientC           = 20.0f;
+    float sensorLagSec       = 60.0f;      // Probe time constant τs
+};
+
+struct ThermalPlantState {
+    float airC    = 20.0f;   // Room temperature
+    float sensorC = 20.0f;   // What the probe reports
+};
+
+/** Temperature the room would settle at with the heater held ON/OFF. */
+inline float plantEquilibriumC(const ThermalPlantParams& p, bool heaterOn) {
+    return p.ambientC + (heaterOn ? p.heaterPowerW / p.lossWPerC : 0.0f);
+}
+
+/**
+ * Advances the model by dtSec with the heater held constant. Uses the exact
+ * exponential solution, so it is stable for any step size; the probe is
+ * integrated in ≤ 1 s sub-steps against the evolving air temperature.
+ */
+inline void thermalPlantStep(ThermalPlantState& s, const ThermalPlantParams& p,
+                             float dtSec, bool heaterOn) {
+    if (!(dtSec > 0.0f)) return;
+    const float tau = p.heatCapacityJPerC / p.lossWPerC;
+    const float target = plantEquilibriumC(p, heaterOn);
+
+    float remaining = dtSec;
+    while (remaining > 0.0f) {
+        float h = remaining < 1.0f ? remaining : 1.0f;
+        s.airC = target + (s.airC - target) * std::exp(-h / tau);
+        s.sensorC = s.airC + (s.sensorC - s.airC) * std::exp(-h / p.sensorLagSec);
+        remaining -= h;
+    }
+}
+
+#endif // THERMAL_PLANT_H
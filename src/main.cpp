@@ -10,9 +10,29 @@
 #include <OneWire.h>
 #include <DallasTemperature.h>
 #include <esp_task_wdt.h>
+#include <esp_system.h>
+#include <esp_attr.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
 #include <WebServer.h>
+#include <WiFiUdp.h>
+#include <Preferences.h>
 #include "sauna_logic.h"
 #include "http_validation.h"
+#include "log_ring.h"
+#include "session_command.h"
+#include "delta_patch.h"
+#include "deadline_scheduler.h"
+#include "session_stats.h"
+#include "admission_control.h"
+#include "temp_profile.h"
+#include "session_resume.h"
+#include "coap_codec.h"
+#include "energy_meter.h"
+#include "eco_mode.h"
+#include "sensor_voting.h"
+#include "status_report.h"
+#include "cbor_codec.h"
 #include "secrets.h"
 
 // Compile-time check: our constant must match the DallasTemperature library
@@ -36,14 +56,126 @@ constexpr uint8_t PIN_STATUS_LED = 2;       // Onboard LED for status
 // =============================================================================
 constexpr uint32_t TEMP_READ_INTERVAL_MS = 2000;
 constexpr uint32_t CONVERSION_WAIT_MS = 750; // DS18B20 12-bit conversion time
+constexpr uint32_t LOG_DRAIN_INTERVAL_MS = 50; // Serial drain task period
+
+// =============================================================================
+// Scheduler Jobs — lower id runs first when several are due
+// =============================================================================
+constexpr uint8_t JOB_CONVERSION_READ    = 0;  // Safety: sensor fault, over-temp, control
+constexpr uint8_t JOB_SESSION_EXPIRY     = 1;  // Safety: 60-minute hard limit
+constexpr uint8_t JOB_CONVERSION_REQUEST = 2;
+constexpr uint8_t JOB_NETWORK            = 3;  // homeSpan.poll() + handleClient()
+constexpr uint8_t JOB_COUNT              = 4;
+
+constexpr uint32_t SAFETY_JOB_BUDGET_MS    = 100;  // Lateness logged as an overrun
+constexpr uint32_t NETWORK_POLL_IDLE_MS    = 20;   // Network service period when quiet
+constexpr uint32_t NETWORK_POLL_ACTIVE_MS  = 2;    // ...within NETWORK_ACTIVE_WINDOW_MS of a request
+constexpr uint32_t NETWORK_ACTIVE_WINDOW_MS = 1000;
+constexpr uint32_t LOOP_MAX_SLEEP_MS       = 100;  // Upper bound on one yield
+
+// =============================================================================
+// Admission Control — keeps port 8080 traffic from starving the safety jobs
+// =============================================================================
+constexpr uint8_t RATE_LIMIT_CLIENTS    = 8;       // Client IPs tracked at once
+constexpr uint16_t RATE_LIMIT_BURST     = 20;      // Requests back-to-back per client
+constexpr uint16_t RATE_LIMIT_PER_SEC   = 10;      // Sustained requests/s per client
+constexpr int32_t NETWORK_BUDGET_US     = 50000;   // Network work allowed in one burst
+constexpr uint32_t NETWORK_SHARE_US_PER_SEC = 500000;  // ...refilled at 50% of wall time
+constexpr size_t COMMAND_BODY_MAX       = 256;     // /heater, /target, /session bodies
+
+// =============================================================================
+// CoAP Endpoint (UDP 5683) — status/heater/target for panels and automations
+// =============================================================================
+constexpr uint8_t COAP_MAX_OBSERVERS      = 4;
+constexpr uint8_t COAP_DATAGRAMS_PER_POLL = 4;     // Bounds CoAP work per network pass
+constexpr uint32_t COAP_NOTIFY_REFRESH_MS = 30000; // Notify observers at least this often
+
+// =============================================================================
+// Energy
+// =============================================================================
+constexpr float HEATER_POWER_W = 7000.0f;          // Heater nameplate rating — set to yours
+constexpr const char* ENERGY_NVS_NAMESPACE = "energy";
+
+const char* const JOB_NAMES[JOB_COUNT] = {
+    "conversion_read", "session_expiry", "conversion_request", "network",
+};
 
 // =============================================================================
 // Global Objects
 // =============================================================================
 OneWire oneWire(PIN_TEMP_SENSOR);
 DallasTemperature tempSensor(&oneWire);
+// ROM codes of the voted probes, captured once at boot. Reading by address
+// keeps each probe in its own vote slot: a probe that leaves the bus reads
+// as disconnected instead of renumbering the others, and no read needs a
+// bus search.
+DeviceAddress probeAddresses[VOTE_MAX_PROBES];
+SensorVote sensorVote;   // Two or three probes on the bus are voted (sensor_voting.h)
 WebServer httpServer(8080);
 
+// Event log — written from the control path, drained to Serial by logDrainTask
+constexpr uint32_t LOG_RING_SIZE = 128;
+constexpr uint32_t LOG_HTTP_MAX_ENTRIES = 16;  // Per GET /logs response
+LogRing<LOG_RING_SIZE> eventLog;
+
+/** Records an event in O(1) — never blocks on Serial. */
+void logEvent(LogLevel level, LogMsg msg, float a0 = 0.0f, float a1 = 0.0f) {
+    eventLog.push(level, millis(), msg, a0, a1);
+}
+
+// Session statistics — folded in per reading, last N kept for GET /sessions
+constexpr uint8_t SESSION_JOURNAL_SIZE = 8;
+SessionAggregator sessionStats;
+SessionJournal<SESSION_JOURNAL_SIZE> sessionJournal;
+
+// Ramp/soak profile (POST /profile) — drives targetTemp while running
+ProfileRunner profileRunner;
+
+// Energy metering and eco heat-up (POST /eco) — totals and the heat-up model persist in NVS
+EnergyMeter energyMeter;
+HeatupModel heatupModel;
+HeatupTracker heatupTracker;
+bool heatupModelDirty = false;     // Windows learned since the last save
+EcoPlan ecoPlan;
+Preferences energyStore;
+
+/**
+ * Persists the lifetime on-time and the heat-up model. A flash write, so
+ * only at session end and after every ENERGY_SAVE_ON_MS of on-time.
+ */
+void saveEnergy(uint32_t now) {
+    uint64_t onMs = energyMeter.save(now);
+    HeatupFit fit = heatupModel.fit();
+    bool ok = energyStore.putULong64("on_ms", onMs) == sizeof(onMs) &&
+              energyStore.putBytes("fit", &fit, sizeof(fit)) == sizeof(fit);
+    heatupModelDirty = false;
+    if (!ok) logEvent(LogLevel::Warn, LogMsg::EnergySaveFailed);
+}
+
+// Session checkpoint — survives every reset except power-on, checked by checksum
+RTC_NOINIT_ATTR RetainedSession retainedSession;
+
+// Jobs arm their own next deadline; loop() runs what is due, then yields
+DeadlineScheduler<JOB_COUNT> scheduler;
+uint32_t lastHttpResponseMs = 0;   // Keeps network polling fast while a client (HTTP or CoAP) is active
+
+ClientRateLimiter<RATE_LIMIT_CLIENTS> rateLimiter(RATE_LIMIT_BURST, RATE_LIMIT_PER_SEC);
+TokenBucket networkBudget(NETWORK_BUDGET_US, NETWORK_SHARE_US_PER_SEC);
+uint32_t networkDeferrals = 0;     // Network passes postponed because the budget was spent
+
+// CoAP endpoint — observers get status pushed on change
+WiFiUDP coapSocket;
+bool coapStarted = false;
+CoapObservers<COAP_MAX_OBSERVERS> coapObservers;
+uint16_t coapMessageId = 0;
+uint32_t coapRequests = 0;
+uint64_t coapNotifiedKey = 0;      // coapObservedKey() at the last notification
+uint32_t coapNotifiedMs = 0;
+
+// Loop timing (GET /diag) — longest stretch the loop ran without yielding
+uint32_t maxLoopBusyUs = 0;
+uint32_t loopPassCount = 0;
+
 // Forward declaration — full definition below
 struct SaunaThermostat;
 SaunaThermostat *thermostat = nullptr;  // set in setup(), used by HTTP handlers
@@ -62,6 +194,7 @@ struct SaunaThermostat : Service::Thermostat {
     bool heaterActive = false;
     bool sensorFault = false;
     uint32_t sessionStartTime = 0;
+    uint8_t sessionResumes = 0;            // Resets the running session has survived
     bool conversionRequested = false;
     uint32_t lastConversionRequest = 0;
 
@@ -87,90 +220,228 @@ struct SaunaThermostat : Service::Thermostat {
             int state = targetState->getNewVal();
 
             if (state == 1 && !canAcceptHeatCommand(sensorFault)) {
-                LOG1("SAFETY: HEAT command blocked — sensor fault active\n");
+                logEvent(LogLevel::Safety, LogMsg::HeatBlockedSensorFault);
                 return false;
             }
+            ecoPlan.cancel();  // A manual heater command replaces a pending eco start
 
             if (state == 0) {
                 setHeaterState(false);
+                endSession(SessionEndReason::User);
             } else if (state == 1 && oldState != 1) {
                 startSession();
             }
             // state == 1 (HEAT): don't turn heater on immediately.
             // loop() will engage it when temperature is below target.
-            LOG1("HomeKit: Target state set to %s\n", state == 1 ? "HEAT" : "OFF");
+            logEvent(LogLevel::Info,
+                     state == 1 ? LogMsg::HomeKitTargetHeat : LogMsg::HomeKitTargetOff);
         }
 
         if (targetTemp->updated()) {
             float target = targetTemp->getNewVal<float>();
-            LOG1("HomeKit: Target temp set to %.1f°C\n", target);
+            profileRunner.stop();  // A manual setpoint takes over from the profile
+            logEvent(LogLevel::Info, LogMsg::HomeKitTargetTemp, target);
         }
 
         return true;
     }
 
-    void loop() override {
-        uint32_t now = millis();
+    // --- Session timeout safety check (JOB_SESSION_EXPIRY) ---
+    void checkSessionExpiry(uint32_t now) {
+        if (targetState->getVal() != 1) return;  // Session already ended
+        if (!isSessionExpired(sessionStartTime, now)) {
+            // Session restarted after this deadline was armed
+            scheduler.arm(JOB_SESSION_EXPIRY, sessionStartTime + SESSION_MAX_MS);
+            return;
+        }
+        setHeaterState(false);
+        targetState->setVal(0);
+        endSession(SessionEndReason::Timeout);
+        logEvent(LogLevel::Safety, LogMsg::SessionTimeout,
+                 static_cast<float>(SESSION_MAX_MINUTES));
+    }
 
-        // --- Session timeout safety check ---
-        if (targetState->getVal() == 1 && isSessionExpired(sessionStartTime, now)) {
-            setHeaterState(false);
-            targetState->setVal(0);
-            LOG1("SAFETY: Session time limit (%u min) reached, heater disabled\n",
-                 SESSION_MAX_MINUTES);
+    // --- Async temperature read state machine ---
+
+    /** Phase 1 (JOB_CONVERSION_REQUEST): start a conversion. */
+    void requestConversion(uint32_t now) {
+        tempSensor.requestTemperatures();
+        conversionRequested = true;
+        lastConversionRequest = now;
+        scheduler.arm(JOB_CONVERSION_READ, now + CONVERSION_WAIT_MS);
+    }
+
+    /** Phase 2 (JOB_CONVERSION_READ): conversion complete — process it. */
+    void readConversion() {
+        conversionRequested = false;
+        scheduler.arm(JOB_CONVERSION_REQUEST, lastConversionRequest + TEMP_READ_INTERVAL_MS);
+
+        // Backstop: a session must always have its expiry armed
+        if (targetState->getVal() == 1 && !scheduler.armed(JOB_SESSION_EXPIRY)) {
+            scheduler.arm(JOB_SESSION_EXPIRY, sessionStartTime + SESSION_MAX_MS);
+        }
+
+        float readings[VOTE_MAX_PROBES];
+        for (uint8_t i = 0; i < sensorVote.probeCount(); ++i) {
+            readings[i] = tempSensor.getTempC(probeAddresses[i]);
+        }
+        VoteResult vote = sensorVote.update(readings);
+        if (vote.excluded >= 0) {
+            logEvent(LogLevel::Safety, LogMsg::ProbeVotedOut, vote.excluded,
+                     sensorVote.deviation(vote.excluded));
         }
+        float temp = vote.controlC;
 
-        // --- Async temperature read state machine ---
-        if (!conversionRequested) {
-            // Phase 1: Request a new conversion at the configured interval
-            if (now - lastConversionRequest >= TEMP_READ_INTERVAL_MS) {
-                tempSensor.requestTemperatures();
-                conversionRequested = true;
-                lastConversionRequest = now;
+        if (!vote.valid) {
+            // Sensor fault — fail safe immediately
+            if (vote.fault == VoteFault::Disagreement) {
+                // Lasts until the probes agree again — log once, not every reading
+                if (!sensorFault) logEvent(LogLevel::Safety, LogMsg::ProbesDisagree, vote.spreadC);
+            } else {
+                logEvent(LogLevel::Safety, LogMsg::SensorFault, firstMissingReading(readings));
             }
+            setHeaterState(false);
+            targetState->setVal(0);
+            endSession(SessionEndReason::SensorFault);
+            sensorFault = true;
+            currentState->setVal(0);
         } else {
-            // Phase 2: Wait for conversion to complete, then process
-            if (now - lastConversionRequest >= CONVERSION_WAIT_MS) {
-                conversionRequested = false;
-                float temp = tempSensor.getTempCByIndex(0);
-
-                if (isSensorFault(temp)) {
-                    // Sensor fault — fail safe immediately
-                    LOG1("SAFETY: Temperature sensor fault (%.1f), heater disabled\n", temp);
-                    setHeaterState(false);
-                    targetState->setVal(0);
-                    sensorFault = true;
-                    currentState->setVal(0);
-                } else {
-                    // Valid reading
-                    sensorFault = false;
-                    currentTemp->setVal(temp);
-
-                    if (isOverTemperature(temp)) {
-                        setHeaterState(false);
-                        targetState->setVal(0);
-                        LOG1("SAFETY: Max temp (%.0f°C) reached, heater disabled\n",
-                             TEMP_MAX_CELSIUS);
-                    }
-                    else if (targetState->getVal() == 1) {
-                        float target = targetTemp->getVal<float>();
-                        bool desired = shouldHeaterEngage(temp, target, heaterActive);
-                        if (desired != heaterActive) {
-                            setHeaterState(desired);
-                        }
-                    }
-
-                    currentState->setVal(heaterActive ? 1 : 0);
+            // Valid reading
+            sensorFault = false;
+            currentTemp->setVal(temp);
+            // heaterActive still holds the relay state since the previous reading
+            if (heatupTracker.observe(millis(), temp, heaterActive, heatupModel)) {
+                heatupModelDirty = true;
+            }
+
+            if (isOverTemperature(vote.tripC)) {
+                setHeaterState(false);
+                targetState->setVal(0);
+                endSession(SessionEndReason::OverTemperature);
+                logEvent(LogLevel::Safety, LogMsg::OverTemperature, TEMP_MAX_CELSIUS);
+            }
+            else if (targetState->getVal() == 1 && advanceProfile(temp)) {
+                // advanceProfile() first, so control sees this reading's setpoint
+                float target = targetTemp->getVal<float>();
+                bool desired = shouldHeaterEngage(temp, target, heaterActive);
+                if (desired != heaterActive) {
+                    setHeaterState(desired);
                 }
             }
+            else if (targetState->getVal() == 0 && ecoPlan.due(millis(), temp, heatupModel)) {
+                startEcoSession();
+            }
+
+            currentState->setVal(heaterActive ? 1 : 0);
+            sessionStats.addSample(millis(), temp, targetTemp->getVal<float>(), heaterActive);
+        }
+
+        if (targetState->getVal() == 1) {
+            checkpointSession();
+        }
+        if (energyMeter.saveDue(millis())) {
+            saveEnergy(millis());
         }
     }
 
+    /** The reading that failed, for the log — the first probe that did not answer. */
+    float firstMissingReading(const float* readings) const {
+        for (uint8_t i = 0; i < sensorVote.probeCount(); ++i) {
+            if (sensorVote.state(i) == ProbeState::Missing) return readings[i];
+        }
+        return readings[0];
+    }
+
+    /**
+     * Moves the setpoint along the running profile, if any. After the last
+     * hold it turns the heater off, ends the session and returns false.
+     */
+    bool advanceProfile(float temp) {
+        if (!profileRunner.running()) return true;
+        float setpoint = profileRunner.update(millis(), temp);
+        if (profileRunner.finished()) {
+            setHeaterState(false);
+            targetState->setVal(0);
+            endSession(SessionEndReason::ProfileComplete);
+            logEvent(LogLevel::Info, LogMsg::ProfileComplete);
+            return false;
+        }
+        // HomeKit shows tenths — skip updates it would not display
+        float rounded = roundf(setpoint * 10.0f) / 10.0f;
+        if (fabsf(rounded - targetTemp->getVal<float>()) >= 0.05f) {
+            targetTemp->setVal(rounded);
+        }
+        return true;
+    }
+
     void startSession() {
         sessionStartTime = millis();
+        sessionResumes = 0;
+        scheduler.arm(JOB_SESSION_EXPIRY, sessionStartTime + SESSION_MAX_MS);
+        sessionStats.start(sessionStartTime, targetTemp->getVal<float>());
+        checkpointSession();
+    }
+
+    /**
+     * The eco plan's start time has come: an ordinary HEAT command for its
+     * target, issued from a valid reading. The relay engages on the next one.
+     */
+    void startEcoSession() {
+        uint32_t now = millis();
+        float target = ecoPlan.target();
+        uint32_t readyInMs = ecoPlan.readyInMs(now);
+        ecoPlan.cancel();
+        profileRunner.stop();
+        targetTemp->setVal(target);
+        startSession();
+        targetState->setVal(1);
+        logEvent(LogLevel::Info, LogMsg::EcoStarted, target, readyInMs / 60000.0f);
+    }
+
+    /**
+     * Continues a session interrupted by a reset (decideResume() said so).
+     * Elapsed time carries over, so the expiry deadline is the original one
+     * plus the resume penalty. HEAT only — the control job engages the relay.
+     */
+    void resumeSession(const RetainedSession& r) {
+        uint32_t now = millis();
+        sessionStartTime = now - resumedElapsedMs(r);
+        sessionResumes = r.resumes + 1;
+        targetTemp->setVal(r.targetC);
+        targetState->setVal(1);
+        scheduler.arm(JOB_SESSION_EXPIRY, sessionStartTime + SESSION_MAX_MS);
+        sessionStats.start(now, r.targetC);   // Journalled as its own session
+        if (r.profileActive) {
+            profileRunner.restore(r.profile, now);
+        }
+        // Commit the penalty and resume count before another reset can happen
+        checkpointSession();
+    }
+
+    /** Mirrors the running session into RTC memory (every reading, ~2 s). */
+    void checkpointSession() {
+        uint32_t now = millis();
+        ProfileRunnerState profile;
+        bool profileRunning = profileRunner.running();
+        if (profileRunning) profile = profileRunner.save(now);
+        retainSession(retainedSession, now - sessionStartTime, targetTemp->getVal<float>(),
+                      sessionResumes, profileRunning ? &profile : nullptr);
+    }
+
+    /** Journals the running session, if any. Safe to call when none is. */
+    void endSession(SessionEndReason reason) {
+        profileRunner.stop();
+        clearRetainedSession(retainedSession);
+        if (sessionStats.active()) {
+            sessionJournal.add(sessionStats.finish(millis(), reason));
+        }
+        if (energyMeter.unsavedMs(millis()) > 0 || heatupModelDirty) {
+            saveEnergy(millis());
+        }
     }
 
     void setHeaterState(bool on) {
+        energyMeter.update(millis(), on);
         heaterActive = on;
         digitalWrite(PIN_RELAY, on ? HIGH : LOW);
         digitalWrite(PIN_STATUS_LED, on ? HIGH : LOW);
@@ -181,94 +452,289 @@ struct SaunaThermostat : Service::Thermostat {
 // REST API Handlers (port 8080)
 // =============================================================================
 
+/**
+ * Sends a JSON response. Every response carries X-Sensor-Phase so load tests
+ * can correlate latency with the DS18B20 conversion window.
+ */
+void sendJson(int code, const char* body) {
+    httpServer.sendHeader("X-Sensor-Phase",
+        thermostat->conversionRequested ? "converting" : "idle");
+    httpServer.send(code, "application/json", body);
+    lastHttpResponseMs = millis();
+}
+
+/**
+ * Sends a CBOR response with the same X-Sensor-Phase header as sendJson().
+ * send_P() takes an explicit length, so zero bytes in the body go out intact.
+ */
+void sendCbor(int code, const uint8_t* body, size_t len) {
+    httpServer.sendHeader("X-Sensor-Phase",
+        thermostat->conversionRequested ? "converting" : "idle");
+    httpServer.send_P(code, CBOR_CONTENT_TYPE, reinterpret_cast<const char*>(body), len);
+    lastHttpResponseMs = millis();
+}
+
+/** Whether the client asked for CBOR (Accept: application/cbor). Errors stay JSON. */
+bool wantsCbor() {
+    return httpServer.header("Accept").indexOf(CBOR_CONTENT_TYPE) >= 0;
+}
+
+/** The status document from the thermostat, profile runner and probe vote. */
+StatusReport statusReport() {
+    StatusReport s;
+    s.currentC = thermostat->currentTemp->getVal<float>();
+    s.targetC = thermostat->targetTemp->getVal<float>();
+    s.heating = thermostat->heaterActive;
+    s.firmware = FIRMWARE_VERSION;
+    if (profileRunner.running()) {
+        uint32_t now = millis();
+        s.profileRunning = true;
+        s.segment = profileRunner.segment();
+        s.segments = profileRunner.segmentCount();
+        s.phase = profileRunner.phase();
+        s.segmentRemainingS = profileRunner.segmentRemainingMs(now) / 1000;
+        s.remainingS = profileRunner.remainingMs(now) / 1000;
+    }
+    s.probeCount = sensorVote.probeCount();
+    for (uint8_t i = 0; i < s.probeCount; ++i) {
+        s.probes[i].c = sensorVote.reading(i);
+        s.probes[i].dev = sensorVote.deviation(i);
+        s.probes[i].state = sensorVote.state(i);
+    }
+    return s;
+}
+
+/** Renders the GET /status body — shared by every endpoint that returns status. */
+void formatStatusJson(char* json, size_t len) {
+    formatStatusJson(statusReport(), json, len);
+}
+
+/** Sends the status document as CBOR or JSON, whichever the client accepts. */
+void sendStatus(int code) {
+    if (wantsCbor()) {
+        uint8_t cbor[STATUS_CBOR_SIZE];
+        sendCbor(code, cbor, encodeStatusCbor(statusReport(), cbor, sizeof(cbor)));
+        return;
+    }
+    char json[STATUS_JSON_SIZE];
+    formatStatusJson(json, sizeof(json));
+    sendJson(code, json);
+}
+
+/** Acknowledges a single-field command: {"ok":true}, or its CBOR form. */
+void sendOk() {
+    if (wantsCbor()) {
+        uint8_t cbor[8];
+        sendCbor(200, cbor, encodeOkCbor(cbor, sizeof(cbor)));
+        return;
+    }
+    sendJson(200, "{\"ok\":true}");
+}
+
+/** Whether the request body is CBOR (Content-Type: application/cbor). */
+bool isCborBody() {
+    return httpServer.header("Content-Type").indexOf(CBOR_CONTENT_TYPE) >= 0;
+}
+
+/**
+ * Body of the current /heater, /target or /session request, bytes as sent.
+ * arg("plain") is built with String(char*) and would stop at the first zero
+ * byte — e.g. CBOR state 0 (0x00) or 80.0 as a half float (f9 55 00).
+ */
+struct CommandBody {
+    char data[COMMAND_BODY_MAX + 1];   // Room to terminate a JSON body
+    size_t len;
+    bool overflow;
+};
+CommandBody commandBody = {{0}, 0, false};
+
+void clearCommandBody() {
+    commandBody.data[0] = '\0';
+    commandBody.len = 0;
+    commandBody.overflow = false;
+}
+
+/**
+ * Raw-body callback for the command routes. With an upload callback the
+ * WebServer streams any non-form body here (canRaw) instead of filling
+ * arg("plain").
+ */
+void collectCommandBody() {
+    HTTPRaw& raw = httpServer.raw();
+    if (raw.status == RAW_START || raw.status == RAW_ABORTED) {
+        clearCommandBody();
+    } else if (raw.status == RAW_WRITE) {
+        if (raw.currentSize > COMMAND_BODY_MAX - commandBody.len) {
+            commandBody.overflow = true;
+            return;
+        }
+        memcpy(commandBody.data + commandBody.len, raw.buf, raw.currentSize);
+        commandBody.len += raw.currentSize;
+        commandBody.data[commandBody.len] = '\0';
+    }
+}
+
+/** Runs a command route, then drops its body so no later request can see it. */
+WebServer::THandlerFunction withCommandBody(WebServer::THandlerFunction handler) {
+    return [handler]() {
+        handler();
+        clearCommandBody();
+    };
+}
+
+/**
+ * Refuses a body that is neither JSON nor CBOR with 415, and one too large
+ * to buffer with 413. Returns false after sending the error.
+ */
+bool checkCommandBody() {
+    if (!isCborBody() && httpServer.header("Content-Type").indexOf("application/json") < 0) {
+        sendJson(415, "{\"error\":\"Content-Type must be application/json or application/cbor\"}");
+        return false;
+    }
+    if (commandBody.overflow) {
+        sendJson(413, "{\"error\":\"request body too large\"}");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Decodes and validates a CBOR command body, keeping only the fields the
+ * route takes (as coapCommand() does). Returns false after sending the error.
+ */
+bool readCborCommand(SessionCommand& cmd, bool wantState, bool wantTemperature) {
+    SessionCommandResult result = parseSessionCommandCbor(
+        reinterpret_cast<const uint8_t*>(commandBody.data), commandBody.len, cmd);
+    if (!wantState) cmd.hasState = false;
+    if (!wantTemperature) cmd.hasTemperature = false;
+    if (result == SessionCommandResult::Ok && !cmd.hasState && !cmd.hasTemperature) {
+        result = SessionCommandResult::NoFields;
+    }
+    if (result == SessionCommandResult::Ok) {
+        result = validateSessionCommand(cmd, thermostat->sensorFault);
+    }
+    if (result == SessionCommandResult::NoFields && wantState != wantTemperature) {
+        sendJson(400, wantState ? "{\"error\":\"missing 'state' field\"}"
+                                : "{\"error\":\"missing 'temperature' field\"}");
+        return false;
+    }
+    if (result != SessionCommandResult::Ok) {
+        sendJson(sessionCommandHttpStatus(result), sessionCommandError(result));
+        return false;
+    }
+    return true;
+}
+
 void handleGetStatus() {
-    char json[128];
-    snprintf(json, sizeof(json),
-        "{\"current_temp\":%.1f,\"target_temp\":%.1f,\"heating\":%s,\"firmware\":\"%s\"}",
-        thermostat->currentTemp->getVal<float>(),
-        thermostat->targetTemp->getVal<float>(),
-        thermostat->heaterActive ? "true" : "false",
-        FIRMWARE_VERSION);
-    httpServer.send(200, "application/json", json);
+    sendStatus(200);
+}
+
+/**
+ * Applies a validated heater state from a REST command path.
+ * Never calls setHeaterState(true) — HEAT only sets targetState and
+ * loop() engages the relay through the safety pipeline.
+ */
+void applyHeaterCommand(int state) {
+    ecoPlan.cancel();  // Any manual heater command replaces a pending eco start
+    if (state == 0) {
+        thermostat->setHeaterState(false);
+        thermostat->targetState->setVal(0);
+        thermostat->endSession(SessionEndReason::User);
+    } else {
+        if (thermostat->targetState->getVal() != 1) {
+            thermostat->startSession();
+        }
+        thermostat->targetState->setVal(1);
+    }
+}
+
+/**
+ * Applies a validated session command — shared by POST /session, the CBOR
+ * bodies of /heater and /target, and the CoAP endpoint. Runs in one pass on the loop task, so neither HomeKit nor
+ * a /status poll can observe a partial update. Target first, so the first
+ * control pass after HEAT already sees the new setpoint.
+ */
+void applySessionCommand(const SessionCommand& cmd) {
+    if (cmd.hasTemperature) {
+        profileRunner.stop();
+        thermostat->targetTemp->setVal(cmd.temperature);
+    }
+    if (cmd.hasState) {
+        applyHeaterCommand(cmd.state);
+    }
 }
 
 void handlePostHeater() {
-    if (httpServer.header("Content-Type").indexOf("application/json") < 0) {
-        httpServer.send(415, "application/json",
-            "{\"error\":\"Content-Type must be application/json\"}");
+    if (!checkCommandBody()) return;
+    if (isCborBody()) {
+        SessionCommand cmd;
+        if (!readCborCommand(cmd, true, false)) return;
+        applySessionCommand(cmd);
+        sendOk();
         return;
     }
 
-    String body = httpServer.arg("plain");
+    String body = commandBody.data;
 
     // Parse "state" from JSON body (manual — avoids ArduinoJson dep)
     int idx = body.indexOf("\"state\"");
     if (idx < 0) {
-        httpServer.send(400, "application/json", "{\"error\":\"missing 'state' field\"}");
+        sendJson(400, "{\"error\":\"missing 'state' field\"}");
         return;
     }
     int colon = body.indexOf(':', idx);
     if (colon < 0) {
-        httpServer.send(400, "application/json", "{\"error\":\"malformed JSON\"}");
+        sendJson(400, "{\"error\":\"malformed JSON\"}");
         return;
     }
 
     int state;
     if (!parseIntValue(body.substring(colon + 1).c_str(), state)) {
-        httpServer.send(400, "application/json", "{\"error\":\"invalid state, must be 0 or 1\"}");
+        sendJson(400, "{\"error\":\"invalid state, must be 0 or 1\"}");
         return;
     }
 
     if (!isValidHeaterState(state)) {
-        httpServer.send(400, "application/json", "{\"error\":\"invalid state, must be 0 or 1\"}");
+        sendJson(400, "{\"error\":\"invalid state, must be 0 or 1\"}");
         return;
     }
 
     if (state == 1 && !canAcceptHeatCommand(thermostat->sensorFault)) {
-        httpServer.send(503, "application/json",
-            "{\"error\":\"sensor fault active, cannot enable heater\"}");
+        sendJson(503, "{\"error\":\"sensor fault active, cannot enable heater\"}");
         return;
     }
 
-    if (state == 0) {
-        thermostat->setHeaterState(false);
-        thermostat->targetState->setVal(0);
-    } else {
-        // Set target state to HEAT — loop() engages relay through safety checks.
-        // Never call setHeaterState(true) directly from a command path.
-        if (thermostat->targetState->getVal() != 1) {
-            thermostat->startSession();
-        }
-        thermostat->targetState->setVal(1);
-    }
-
-    httpServer.send(200, "application/json", "{\"ok\":true}");
+    applyHeaterCommand(state);
+    sendOk();
 }
 
 void handlePostTarget() {
-    if (httpServer.header("Content-Type").indexOf("application/json") < 0) {
-        httpServer.send(415, "application/json",
-            "{\"error\":\"Content-Type must be application/json\"}");
+    if (!checkCommandBody()) return;
+    if (isCborBody()) {
+        SessionCommand cmd;
+        if (!readCborCommand(cmd, false, true)) return;
+        applySessionCommand(cmd);
+        sendOk();
         return;
     }
 
-    String body = httpServer.arg("plain");
+    String body = commandBody.data;
 
     // Parse "temperature" from JSON body
     int idx = body.indexOf("\"temperature\"");
     if (idx < 0) {
-        httpServer.send(400, "application/json", "{\"error\":\"missing 'temperature' field\"}");
+        sendJson(400, "{\"error\":\"missing 'temperature' field\"}");
         return;
     }
     int colon = body.indexOf(':', idx);
     if (colon < 0) {
-        httpServer.send(400, "application/json", "{\"error\":\"malformed JSON\"}");
+        sendJson(400, "{\"error\":\"malformed JSON\"}");
         return;
     }
 
     float temperature;
     if (!parseFloatValue(body.substring(colon + 1).c_str(), temperature)) {
-        httpServer.send(400, "application/json", "{\"error\":\"invalid temperature value\"}");
+        sendJson(400, "{\"error\":\"invalid temperature value\"}");
         return;
     }
 
@@ -277,32 +743,734 @@ void handlePostTarget() {
         snprintf(err, sizeof(err),
             "{\"error\":\"temperature must be between %.0f and %.0f\"}",
             TARGET_TEMP_MIN, TARGET_TEMP_MAX);
-        httpServer.send(400, "application/json", err);
+        sendJson(400, err);
         return;
     }
 
+    profileRunner.stop();  // A manual setpoint takes over from the profile
     thermostat->targetTemp->setVal(temperature);
-    httpServer.send(200, "application/json", "{\"ok\":true}");
+    sendOk();
+}
+
+void handlePostSession() {
+    if (!checkCommandBody()) return;
+
+    // Validate every field before touching any state — all or nothing
+    SessionCommand cmd;
+    if (isCborBody()) {
+        if (!readCborCommand(cmd, true, true)) return;
+    } else {
+        String body = commandBody.data;
+        SessionCommandResult result = parseSessionCommand(body.c_str(), cmd);
+        if (result == SessionCommandResult::Ok) {
+            result = validateSessionCommand(cmd, thermostat->sensorFault);
+        }
+        if (result != SessionCommandResult::Ok) {
+            sendJson(sessionCommandHttpStatus(result), sessionCommandError(result));
+            return;
+        }
+    }
+
+    applySessionCommand(cmd);
+    sendStatus(200);
+}
+
+/**
+ * POST /profile — starts a ramp/soak profile and turns the heater on
+ * (HEAT, through the same path as POST /heater). The setpoint starts at
+ * the current temperature and follows the profile from the next reading.
+ * A profile started inside a running session must fit the time it has
+ * left: the session limit is never reset.
+ */
+void handlePostProfile() {
+    if (httpServer.header("Content-Type").indexOf("application/json") < 0) {
+        sendJson(415, "{\"error\":\"Content-Type must be application/json\"}");
+        return;
+    }
+
+    String body = httpServer.arg("plain");
+
+    TempProfile profile;
+    ProfileResult result = parseProfileCommand(body.c_str(), profile);
+    float startC = profileStartSetpoint(thermostat->currentTemp->getVal<float>());
+    if (result == ProfileResult::Ok) {
+        uint32_t available = SESSION_MAX_MS;
+        if (thermostat->targetState->getVal() == 1) {
+            uint32_t elapsed = millis() - thermostat->sessionStartTime;
+            available = elapsed < SESSION_MAX_MS ? SESSION_MAX_MS - elapsed : 0;
+        }
+        result = validateProfileStart(profile, startC, available, thermostat->sensorFault);
+    }
+    if (result != ProfileResult::Ok) {
+        sendJson(profileHttpStatus(result), profileError(result));
+        return;
+    }
+
+    thermostat->targetTemp->setVal(startC);
+    applyHeaterCommand(1);
+    profileRunner.start(profile, millis(), startC);
+    sendStatus(200);
+}
+
+void handleGetDiag() {
+    // Reading resets the maxima, so each read covers the interval since the last
+    uint32_t now = millis();
+    const SchedulerWakeStats& wake = scheduler.wakeStats();
+    // Control jobs only — the network job (highest id) is always due within 20 ms
+    uint32_t nextControlMs = scheduler.msUntilNext(now, LOOP_MAX_SLEEP_MS, JOB_NETWORK);
+    char json[768];
+    size_t len = snprintf(json, sizeof(json),
+        "{\"uptime_ms\":%u,\"loop_passes\":%u,\"loop_gap_max_us\":%u,"
+        "\"conversion_pending\":%s,\"log_pending\":%u,"
+        "\"next_control_deadline_ms\":%u,\"sleeps\":%u,\"slept_ms\":%u,\"idle_pct\":%.1f,"
+        "\"early_wakes\":%u,\"late_wakes\":%u,"
+        "\"http_admitted\":%u,\"http_rejected\":%u,\"network_deferrals\":%u,"
+        "\"coap_requests\":%u,\"coap_observers\":%u,\"coap_observers_dropped\":%u,\"jobs\":{",
+        static_cast<unsigned>(now),
+        static_cast<unsigned>(loopPassCount),
+        static_cast<unsigned>(maxLoopBusyUs),
+        thermostat->conversionRequested ? "true" : "false",
+        static_cast<unsigned>(eventLog.pending()),
+        static_cast<unsigned>(nextControlMs),
+        static_cast<unsigned>(wake.sleeps),
+        static_cast<unsigned>(wake.sleptMs),
+        now > 0 ? 100.0 * wake.sleptMs / now : 0.0,
+        static_cast<unsigned>(wake.earlyWakes),
+        static_cast<unsigned>(wake.lateWakes),
+        static_cast<unsigned>(rateLimiter.admitted()),
+        static_cast<unsigned>(rateLimiter.rejected()),
+        static_cast<unsigned>(networkDeferrals),
+        static_cast<unsigned>(coapRequests),
+        static_cast<unsigned>(coapObservers.count()),
+        static_cast<unsigned>(coapObservers.dropped()));
+    for (uint8_t job = 0; job < JOB_COUNT && len < sizeof(json); ++job) {
+        const SchedulerJobStats& st = scheduler.stats(job);
+        len += snprintf(json + len, sizeof(json) - len,
+            "%s\"%s\":{\"runs\":%u,\"late_max_ms\":%u,\"overruns\":%u}",
+            job ? "," : "", JOB_NAMES[job], static_cast<unsigned>(st.runs),
+            static_cast<unsigned>(st.maxLatenessMs), static_cast<unsigned>(st.overruns));
+    }
+    if (len < sizeof(json)) snprintf(json + len, sizeof(json) - len, "}}");
+    maxLoopBusyUs = 0;
+    scheduler.resetMaxima();
+    sendJson(200, json);
+}
+
+void handleGetSessions() {
+    // Newest first; the session in progress (if any) leads with "end": null
+    static char json[3072];
+    char item[320];
+    uint32_t now = millis();
+    size_t len = snprintf(json, sizeof(json), "{\"uptime_ms\":%u,\"total\":%u,\"sessions\":[",
+                          static_cast<unsigned>(now), static_cast<unsigned>(sessionJournal.total()));
+    bool first = true;
+    if (sessionStats.active()) {
+        formatSessionJson(sessionStats.snapshot(now), sessionJournal.total(), true, item, sizeof(item),
+                          HEATER_POWER_W);
+        len += snprintf(json + len, sizeof(json) - len, "%s", item);
+        first = false;
+    }
+    SessionRecord record;
+    uint32_t id;
+    for (uint8_t i = 0; sessionJournal.newest(i, record, id) && len < sizeof(json); ++i) {
+        formatSessionJson(record, id, false, item, sizeof(item), HEATER_POWER_W);
+        len += snprintf(json + len, sizeof(json) - len, "%s%s", first ? "" : ",", item);
+        first = false;
+    }
+    if (len < sizeof(json)) snprintf(json + len, sizeof(json) - len, "]}");
+    sendJson(200, json);
+}
+
+/** The pending eco start, or null. start_in_s is re-estimated from the current temperature. */
+void formatEcoJson(char* json, size_t len) {
+    if (!ecoPlan.active()) {
+        snprintf(json, len, "null");
+        return;
+    }
+    uint32_t now = millis();
+    float current = thermostat->currentTemp->getVal<float>();
+    snprintf(json, len, "{\"target\":%.1f,\"ready_in_s\":%u,\"start_in_s\":%u}",
+             ecoPlan.target(),
+             static_cast<unsigned>(ecoPlan.readyInMs(now) / 1000),
+             static_cast<unsigned>(ecoPlan.startInMs(now, current, heatupModel) / 1000));
+}
+
+/**
+ * POST /eco — be at a temperature in ready_in_min minutes with the least
+ * energy. Nothing heats now: the conversion job starts an ordinary session
+ * once the predicted heat-up (plus margin) reaches the ready time.
+ */
+void handlePostEco() {
+    if (httpServer.header("Content-Type").indexOf("application/json") < 0) {
+        sendJson(415, "{\"error\":\"Content-Type must be application/json\"}");
+        return;
+    }
+
+    String body = httpServer.arg("plain");
+
+    EcoCommand cmd;
+    EcoResult result = parseEcoCommand(body.c_str(), cmd);
+    if (result == EcoResult::Ok) {
+        result = validateEcoStart(cmd, heatupModel, thermostat->currentTemp->getVal<float>(),
+                                  thermostat->targetState->getVal() == 1, thermostat->sensorFault);
+    }
+    if (result != EcoResult::Ok) {
+        sendJson(ecoHttpStatus(result), ecoError(result));
+        return;
+    }
+
+    ecoPlan.schedule(millis(), static_cast<uint32_t>(cmd.readyInMin) * 60000UL, cmd.temperature);
+    char json[96];
+    formatEcoJson(json, sizeof(json));
+    sendJson(200, json);
+}
+
+void handleGetEnergy() {
+    uint32_t now = millis();
+    uint64_t onMs = energyMeter.lifetimeOnMs(now);
+    char session[16] = "null";
+    if (sessionStats.active()) {
+        snprintf(session, sizeof(session), "%.3f",
+                 energyKWh(sessionStats.snapshot(now).heaterOnMs, HEATER_POWER_W));
+    }
+    // Heat-up from here to the current target, as the eco planner predicts it
+    char heatup[16] = "null";
+    uint32_t heatupMs = heatupModel.heatupMs(thermostat->currentTemp->getVal<float>(),
+                                             thermostat->targetTemp->getVal<float>());
+    if (heatupMs != ECO_UNREACHABLE) {
+        snprintf(heatup, sizeof(heatup), "%.1f", heatupMs / 60000.0);
+    }
+    char eco[96];
+    formatEcoJson(eco, sizeof(eco));
+
+    char json[384];
+    snprintf(json, sizeof(json),
+        "{\"heater_power_w\":%.0f,\"lifetime_kwh\":%.3f,\"lifetime_heater_on_s\":%u,"
+        "\"session_kwh\":%s,\"model\":{\"fitted\":%s,\"windows\":%.0f,"
+        "\"rate_at_60_c_per_min\":%.2f,\"loss_per_min\":%.4f,\"heatup_to_target_min\":%s},"
+        "\"eco\":%s}",
+        HEATER_POWER_W, energyKWh(onMs, HEATER_POWER_W), static_cast<unsigned>(onMs / 1000),
+        session,
+        heatupModel.fitted() ? "true" : "false",
+        heatupModel.fit().w,
+        heatupModel.rateAt(ECO_FIT_CENTER_C),
+        heatupModel.lossPerMin(),
+        heatup,
+        eco);
+    sendJson(200, json);
+}
+
+void handleGetLogs() {
+    // ?since=<seq> returns entries with seq >= since; omit to get everything retained
+    uint32_t since = eventLog.oldestSeq();
+    if (httpServer.hasArg("since")) {
+        int requested;
+        if (!parseIntValue(httpServer.arg("since").c_str(), requested) || requested < 0) {
+            sendJson(400, "{\"error\":\"invalid since value\"}");
+            return;
+        }
+        // A cursor ahead of the log means the device restarted — replay from oldest
+        if (static_cast<uint32_t>(requested) > since &&
+            static_cast<uint32_t>(requested) <= eventLog.nextSeq()) {
+            since = static_cast<uint32_t>(requested);
+        }
+    }
+
+    static char json[2048];
+    size_t len = 0;
+    uint32_t next = since;
+    const uint32_t head = eventLog.nextSeq();
+    LogEntry entry;
+    char item[192];
+
+    len += snprintf(json + len, sizeof(json) - len, "{\"entries\":[");
+    for (uint32_t seq = since, count = 0;
+         seq < head && count < LOG_HTTP_MAX_ENTRIES && eventLog.read(seq, entry);
+         ++seq, ++count) {
+        int n = formatLogJson(entry, item, sizeof(item));
+        // Leave room for the separator and the closing object
+        if (n < 0 || static_cast<size_t>(n) >= sizeof(item) || len + n + 64 >= sizeof(json)) break;
+        len += snprintf(json + len, sizeof(json) - len, "%s%s", count ? "," : "", item);
+        next = seq + 1;
+    }
+    snprintf(json + len, sizeof(json) - len, "],\"next\":%u,\"dropped\":%u}",
+             static_cast<unsigned>(next), static_cast<unsigned>(eventLog.dropped()));
+    sendJson(200, json);
+}
+
+// =============================================================================
+// Delta OTA (POST /ota/delta — multipart upload of a tools/mkdelta.py patch)
+// =============================================================================
+
+/** Running app partition, read in place as the patch's COPY source. */
+struct RunningPartitionSource : DeltaSource {
+    const esp_partition_t* partition = nullptr;
+    uint32_t size() const override { return partition ? partition->size : 0; }
+    bool read(uint32_t offset, uint8_t* buf, size_t len) override {
+        return partition && esp_partition_read(partition, offset, buf, len) == ESP_OK;
+    }
+};
+
+/** Inactive OTA partition, written sequentially through the OTA API. */
+struct OtaPartitionSink : DeltaSink {
+    esp_ota_handle_t handle = 0;
+    bool write(const uint8_t* buf, size_t len) override {
+        return esp_ota_write(handle, buf, len) == ESP_OK;
+    }
+};
+
+RunningPartitionSource deltaSource;
+OtaPartitionSink deltaSink;
+DeltaPatchApplier deltaApplier(deltaSource, deltaSink);
+
+struct DeltaOtaUpload {
+    const esp_partition_t* target = nullptr;
+    bool open = false;       // esp_ota_begin() succeeded and not yet ended/aborted
+    bool complete = false;   // Image rebuilt, hash verified, esp_ota_end() passed
+    int httpStatus = 0;      // Non-zero once the upload has been rejected
+    char error[96] = "";
+};
+DeltaOtaUpload deltaOta;
+
+void rejectDeltaOta(int status, const char* message) {
+    if (deltaOta.open) {
+        esp_ota_abort(deltaSink.handle);
+        deltaOta.open = false;
+    }
+    if (deltaOta.httpStatus == 0) {
+        deltaOta.httpStatus = status;
+        snprintf(deltaOta.error, sizeof(deltaOta.error), "{\"error\":\"%s\"}", message);
+    }
+}
+
+/** Maps applier failures to HTTP: bad patches are the client's fault, I/O is ours. */
+int deltaResultHttpStatus(DeltaResult r) {
+    return (r == DeltaResult::SourceReadError || r == DeltaResult::SinkWriteError) ? 500 : 400;
+}
+
+void handleDeltaOtaUpload() {
+    HTTPUpload& upload = httpServer.upload();
+    // Uploads over a weak link can outlast the 30 s watchdog — feed it per chunk
+    esp_task_wdt_reset();
+
+    if (upload.status == UPLOAD_FILE_START) {
+        deltaOta = DeltaOtaUpload();
+        if (httpServer.header("X-OTA-Password") != OTA_PASSWORD) {
+            rejectDeltaOta(401, "invalid OTA password");
+            return;
+        }
+        // loop() does not run while handleClient() streams the upload, so the
+        // safety pipeline would be suspended for the whole transfer
+        if (thermostat->targetState->getVal() == 1) {
+            rejectDeltaOta(409, "session active, turn heater off before updating");
+            return;
+        }
+        deltaSource.partition = esp_ota_get_running_partition();
+        deltaOta.target = esp_ota_get_next_update_partition(nullptr);
+        if (!deltaSource.partition || !deltaOta.target) {
+            rejectDeltaOta(503, "no OTA partition available");
+            return;
+        }
+        if (esp_ota_begin(deltaOta.target, OTA_SIZE_UNKNOWN, &deltaSink.handle) != ESP_OK) {
+            rejectDeltaOta(500, "OTA begin failed");
+            return;
+        }
+        deltaOta.open = true;
+        deltaApplier.reset();
+    } else if (upload.status == UPLOAD_FILE_WRITE) {
+        if (!deltaOta.open) return;
+        DeltaResult r = deltaApplier.feed(upload.buf, upload.currentSize);
+        if (r != DeltaResult::NeedMore && r != DeltaResult::Done) {
+            rejectDeltaOta(deltaResultHttpStatus(r), deltaResultName(r));
+        }
+    } else if (upload.status == UPLOAD_FILE_END) {
+        if (!deltaOta.open) return;
+        DeltaResult r = deltaApplier.finish();
+        if (r != DeltaResult::Done) {
+            rejectDeltaOta(deltaResultHttpStatus(r), deltaResultName(r));
+            return;
+        }
+        deltaOta.open = false;
+        if (esp_ota_end(deltaSink.handle) != ESP_OK) {
+            rejectDeltaOta(500, "image validation failed");
+            return;
+        }
+        deltaOta.complete = true;
+    } else if (upload.status == UPLOAD_FILE_ABORTED) {
+        rejectDeltaOta(400, "upload aborted");
+    }
+}
+
+void handlePostDeltaOta() {
+    if (deltaOta.httpStatus != 0) {
+        sendJson(deltaOta.httpStatus, deltaOta.error);
+        return;
+    }
+    if (!deltaOta.complete) {
+        sendJson(400, "{\"error\":\"missing patch upload\"}");
+        return;
+    }
+    if (esp_ota_set_boot_partition(deltaOta.target) != ESP_OK) {
+        sendJson(500, "{\"error\":\"cannot switch boot partition\"}");
+        return;
+    }
+    char json[96];
+    snprintf(json, sizeof(json), "{\"ok\":true,\"bytes\":%u,\"rebooting\":true}",
+             static_cast<unsigned>(deltaApplier.written()));
+    sendJson(200, json);
+    delay(500);  // let the response reach the client
+    ESP.restart();
+}
+
+// =============================================================================
+// Log Drain (low-priority task — the only Serial writer for event log entries)
+// =============================================================================
+
+void logDrainTask(void *) {
+    LogEntry entry;
+    char line[160];
+    uint32_t reportedDrops = 0;
+    for (;;) {
+        while (eventLog.pop(entry)) {
+            formatLogLine(entry, line, sizeof(line));
+            Serial.println(line);
+        }
+        uint32_t dropped = eventLog.dropped();
+        if (dropped != reportedDrops) {
+            Serial.printf("LOG: %u entries dropped (ring full)\n",
+                          static_cast<unsigned>(dropped - reportedDrops));
+            reportedDrops = dropped;
+        }
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+    }
+}
+
+// =============================================================================
+// CoAP Endpoint (RFC 7252 over UDP 5683)
+// =============================================================================
+//
+//   GET  status   (Observe)  same JSON as GET /status
+//   PUT  heater              {"state":0|1}          — as POST /heater
+//   PUT  target              {"temperature":85.0}   — as POST /target
+//   PUT  session             both fields            — as POST /session
+//
+// Commands go through parseSessionCommand()/validateSessionCommand() and
+// applySessionCommand(), so the validation and canAcceptHeatCommand() gate
+// are the REST ones. Datagrams are served from the network job, at most
+// COAP_DATAGRAMS_PER_POLL per pass, and share the per-client rate limit,
+// which never refuses a valid heater OFF.
+
+void coapSend(uint32_t ip, uint16_t port, const CoapMessage& msg) {
+    uint8_t out[COAP_MAX_DATAGRAM];
+    size_t len = encodeCoap(msg, out, sizeof(out));
+    if (len == 0) return;
+    coapSocket.beginPacket(IPAddress(ip), port);
+    coapSocket.write(out, len);
+    coapSocket.endPacket();
+}
+
+void coapReply(uint32_t ip, uint16_t port, const CoapMessage& req, uint8_t code,
+               const char* json) {
+    CoapMessage resp = coapResponseTo(req, code, coapMessageId++);
+    if (json) {
+        resp.contentFormat = COAP_FORMAT_JSON;
+        resp.payload = reinterpret_cast<const uint8_t*>(json);
+        resp.payloadLen = strlen(json);
+    }
+    coapSend(ip, port, resp);
+}
+
+/**
+ * Parses and validates a CoAP command payload with the REST rules, keeping
+ * only the fields the resource takes.
+ */
+SessionCommandResult coapParseCommand(const CoapMessage& req, bool wantState,
+                                      bool wantTemperature, SessionCommand& cmd) {
+    char body[128];
+    if (req.payloadLen >= sizeof(body)) return SessionCommandResult::MalformedJson;
+    memcpy(body, req.payload, req.payloadLen);
+    body[req.payloadLen] = '\0';
+
+    SessionCommandResult result = parseSessionCommand(body, cmd);
+    if (!wantState) cmd.hasState = false;
+    if (!wantTemperature) cmd.hasTemperature = false;
+    if (result == SessionCommandResult::Ok && !cmd.hasState && !cmd.hasTemperature) {
+        result = SessionCommandResult::NoFields;
+    }
+    if (result == SessionCommandResult::Ok) {
+        result = validateSessionCommand(cmd, thermostat->sensorFault);
+    }
+    return result;
+}
+
+/** Whether a request is a valid heater OFF — admitted even when rate limited. */
+bool coapIsHeaterOff(const CoapMessage& req) {
+    if (req.code != COAP_PUT && req.code != COAP_POST) return false;
+    if (req.contentFormat != COAP_FORMAT_NONE && req.contentFormat != COAP_FORMAT_JSON) return false;
+    bool session = strcmp(req.path, "session") == 0;
+    if (!session && strcmp(req.path, "heater") != 0) return false;
+    SessionCommand cmd;
+    return coapParseCommand(req, true, session, cmd) == SessionCommandResult::Ok &&
+           isHeaterOffCommand(cmd);
+}
+
+/** heater, target and session: wantState/wantTemperature pick the fields the resource takes. */
+void coapCommand(uint32_t ip, uint16_t port, const CoapMessage& req,
+                 bool wantState, bool wantTemperature) {
+    if (req.code != COAP_PUT && req.code != COAP_POST) {
+        coapReply(ip, port, req, COAP_METHOD_NOT_ALLOWED, nullptr);
+        return;
+    }
+    // Content-Format may be omitted; anything other than JSON is refused as by REST
+    if (req.contentFormat != COAP_FORMAT_NONE && req.contentFormat != COAP_FORMAT_JSON) {
+        coapReply(ip, port, req, COAP_UNSUPPORTED_FORMAT,
+                  "{\"error\":\"Content-Format must be application/json\"}");
+        return;
+    }
+    SessionCommand cmd;
+    SessionCommandResult result = coapParseCommand(req, wantState, wantTemperature, cmd);
+    if (result != SessionCommandResult::Ok) {
+        coapReply(ip, port, req, coapCodeForHttpStatus(sessionCommandHttpStatus(result)),
+                  sessionCommandError(result));
+        return;
+    }
+
+    applySessionCommand(cmd);
+    char json[STATUS_JSON_SIZE];
+    formatStatusJson(json, sizeof(json));
+    coapReply(ip, port, req, COAP_CHANGED, json);
+}
+
+void coapStatus(uint32_t ip, uint16_t port, const CoapMessage& req, uint32_t now) {
+    if (req.code != COAP_GET) {
+        coapReply(ip, port, req, COAP_METHOD_NOT_ALLOWED, nullptr);
+        return;
+    }
+    if (req.accept != COAP_FORMAT_NONE && req.accept != COAP_FORMAT_JSON) {
+        coapReply(ip, port, req, coapCode(4, 6), nullptr);   // 4.06 Not Acceptable
+        return;
+    }
+    char json[STATUS_JSON_SIZE];
+    formatStatusJson(json, sizeof(json));
+    CoapMessage resp = coapResponseTo(req, COAP_CONTENT, coapMessageId++);
+    if (req.hasObserve && req.observe == 0) {
+        // A full table answers without Observe — the client sees it was not registered
+        if (coapObservers.add(ip, port, req.token, req.tokenLen, now)) {
+            resp.hasObserve = true;
+            resp.observe = coapObservers.nextSequence();
+        }
+    } else if (req.hasObserve && req.observe == 1) {
+        coapObservers.remove(ip, port);
+    }
+    resp.contentFormat = COAP_FORMAT_JSON;
+    resp.payload = reinterpret_cast<const uint8_t*>(json);
+    resp.payloadLen = strlen(json);
+    coapSend(ip, port, resp);
+}
+
+void coapHandle(uint32_t ip, uint16_t port, const uint8_t* buf, size_t len, uint32_t now) {
+    CoapMessage req;
+    CoapParseResult parsed = parseCoap(buf, len, req);
+    bool con = len >= 4 && req.type == CoapType::Confirmable;
+    if (parsed == CoapParseResult::TooShort || parsed == CoapParseResult::BadVersion) {
+        return;   // Not CoAP we can answer
+    }
+    if (req.type == CoapType::Acknowledgement || req.type == CoapType::Reset) {
+        coapObservers.acknowledge(ip, port, req.messageId, req.type == CoapType::Reset);
+        return;
+    }
+    if (parsed == CoapParseResult::BadTokenLength || parsed == CoapParseResult::BadOption ||
+        req.code == COAP_EMPTY || (req.code >> 5) != 0) {
+        // Format error, CoAP ping or a stray response: RST a CON, ignore a NON
+        if (con) coapSend(ip, port, coapReset(req.messageId));
+        return;
+    }
+
+    ++coapRequests;
+    lastHttpResponseMs = now;
+    bool off = parsed == CoapParseResult::Ok && coapIsHeaterOff(req);
+    AdmissionDecision decision = rateLimiter.admit(ip, now, off);
+    if (!decision.admitted) {
+        CoapMessage resp = coapResponseTo(req, COAP_SERVICE_UNAVAILABLE, coapMessageId++);
+        resp.hasMaxAge = true;   // Max-Age on 5.03 is CoAP's Retry-After
+        resp.maxAge = decision.retryAfterSec;
+        coapSend(ip, port, resp);
+        return;
+    }
+    if (parsed == CoapParseResult::UnknownCriticalOption) {
+        coapReply(ip, port, req, COAP_BAD_OPTION, nullptr);
+        return;
+    }
+    if (parsed == CoapParseResult::PathTooLong) {
+        coapReply(ip, port, req, COAP_NOT_FOUND, nullptr);
+        return;
+    }
+
+    if (strcmp(req.path, "status") == 0) {
+        coapStatus(ip, port, req, now);
+    } else if (strcmp(req.path, "heater") == 0) {
+        coapCommand(ip, port, req, true, false);
+    } else if (strcmp(req.path, "target") == 0) {
+        coapCommand(ip, port, req, false, true);
+    } else if (strcmp(req.path, "session") == 0) {
+        coapCommand(ip, port, req, true, true);
+    } else {
+        coapReply(ip, port, req, COAP_NOT_FOUND, nullptr);
+    }
+}
+
+/** What observers are notified about — the remaining-time counters are left out. */
+uint64_t coapObservedKey() {
+    uint64_t key = static_cast<uint16_t>(toDeciC(thermostat->currentTemp->getVal<float>()));
+    key = key << 16 | static_cast<uint16_t>(toDeciC(thermostat->targetTemp->getVal<float>()));
+    key = key << 1 | (thermostat->heaterActive ? 1 : 0);
+    key = key << 8 | (profileRunner.running() ? profileRunner.segment() + 1u : 0u);
+    key = key << 8 | static_cast<uint8_t>(profileRunner.phase());
+    return key;
+}
+
+/** Pushes status to observers on any change, and every COAP_NOTIFY_REFRESH_MS regardless. */
+void coapNotify(uint32_t now) {
+    if (coapObservers.count() == 0) return;
+    uint64_t key = coapObservedKey();
+    if (key == coapNotifiedKey && now - coapNotifiedMs < COAP_NOTIFY_REFRESH_MS) return;
+    coapNotifiedKey = key;
+    coapNotifiedMs = now;
+
+    char json[STATUS_JSON_SIZE];
+    formatStatusJson(json, sizeof(json));
+    uint32_t sequence = coapObservers.nextSequence();
+    for (uint8_t i = 0; i < coapObservers.capacity(); ++i) {
+        if (!coapObservers.at(i).used) continue;
+        uint16_t mid = coapMessageId++;
+        CoapNotifyKind kind = coapObservers.beginNotify(i, now, mid);
+        if (kind == CoapNotifyKind::Dropped) continue;
+        const CoapObserver& o = coapObservers.at(i);
+        CoapMessage msg;
+        msg.type = kind == CoapNotifyKind::Confirmable ? CoapType::Confirmable
+                                                       : CoapType::NonConfirmable;
+        msg.code = COAP_CONTENT;
+        msg.messageId = mid;
+        msg.tokenLen = o.tokenLen;
+        memcpy(msg.token, o.token, o.tokenLen);
+        msg.hasObserve = true;
+        msg.observe = sequence;
+        msg.contentFormat = COAP_FORMAT_JSON;
+        msg.payload = reinterpret_cast<const uint8_t*>(json);
+        msg.payloadLen = strlen(json);
+        coapSend(o.ip, o.port, msg);
+    }
+}
+
+/** Network job: serve queued datagrams, then notify observers. */
+void coapPoll(uint32_t now) {
+    if (!coapStarted) return;
+    uint8_t buf[COAP_MAX_DATAGRAM];
+    for (uint8_t i = 0; i < COAP_DATAGRAMS_PER_POLL; ++i) {
+        int size = coapSocket.parsePacket();
+        if (size <= 0) break;
+        int len = coapSocket.read(buf, sizeof(buf));
+        if (len <= 0) continue;
+        coapHandle(static_cast<uint32_t>(coapSocket.remoteIP()), coapSocket.remotePort(),
+                   buf, static_cast<size_t>(len), now);
+    }
+    coapNotify(now);
 }
 
 // =============================================================================
 // HTTP Server Startup (called by HomeSpan once WiFi connects)
 // =============================================================================
 
+/**
+ * Whether the request body is a valid heater OFF command. Parsed before
+ * admission, so the rate limit can let it through.
+ */
+bool isHeaterOffRequest() {
+    if (commandBody.overflow) return false;
+    SessionCommand cmd;
+    SessionCommandResult result;
+    if (isCborBody()) {
+        result = parseSessionCommandCbor(
+            reinterpret_cast<const uint8_t*>(commandBody.data), commandBody.len, cmd);
+    } else if (httpServer.header("Content-Type").indexOf("application/json") >= 0) {
+        result = parseSessionCommand(commandBody.data, cmd);
+    } else {
+        return false;
+    }
+    if (result == SessionCommandResult::Ok) {
+        result = validateSessionCommand(cmd, thermostat->sensorFault);
+    }
+    return result == SessionCommandResult::Ok && isHeaterOffCommand(cmd);
+}
+
+/**
+ * Wraps a route handler with the per-client rate limit. Over-limit requests
+ * get 429 + Retry-After without running the handler. On routes that take a
+ * heater state (offExempt), a valid OFF is admitted regardless and not charged.
+ */
+WebServer::THandlerFunction rateLimited(WebServer::THandlerFunction handler,
+                                        bool offExempt = false) {
+    return [handler, offExempt]() {
+        uint32_t ip = static_cast<uint32_t>(httpServer.client().remoteIP());
+        bool off = offExempt && isHeaterOffRequest();
+        AdmissionDecision decision = rateLimiter.admit(ip, millis(), off);
+        if (!decision.admitted) {
+            httpServer.sendHeader("Retry-After", String(decision.retryAfterSec));
+            sendJson(429, "{\"error\":\"rate limit exceeded\"}");
+            return;
+        }
+        handler();
+    };
+}
+
 void startHttpServer() {
-    httpServer.on("/status", HTTP_GET, handleGetStatus);
-    httpServer.on("/heater", HTTP_POST, handlePostHeater);
-    httpServer.on("/target", HTTP_POST, handlePostTarget);
-    const char* headerKeys[] = {"Content-Type"};
-    httpServer.collectHeaders(headerKeys, 1);
+    httpServer.on("/status", HTTP_GET, rateLimited(handleGetStatus));
+    // Command bodies arrive through collectCommandBody(), binary-safe for CBOR
+    httpServer.on("/heater", HTTP_POST, withCommandBody(rateLimited(handlePostHeater, true)),
+                  collectCommandBody);
+    httpServer.on("/target", HTTP_POST, withCommandBody(rateLimited(handlePostTarget)),
+                  collectCommandBody);
+    httpServer.on("/session", HTTP_POST, withCommandBody(rateLimited(handlePostSession, true)),
+                  collectCommandBody);
+    httpServer.on("/profile", HTTP_POST, rateLimited(handlePostProfile));
+    httpServer.on("/eco", HTTP_POST, rateLimited(handlePostEco));
+    httpServer.on("/energy", HTTP_GET, rateLimited(handleGetEnergy));
+    httpServer.on("/logs", HTTP_GET, rateLimited(handleGetLogs));
+    httpServer.on("/sessions", HTTP_GET, rateLimited(handleGetSessions));
+    httpServer.on("/diag", HTTP_GET, rateLimited(handleGetDiag));
+    // Not rate limited: the upload callback streams before any handler runs,
+    // and the endpoint is password-protected and refused during sessions
+    httpServer.on("/ota/delta", HTTP_POST, handlePostDeltaOta, handleDeltaOtaUpload);
+    const char* headerKeys[] = {"Content-Type", "Accept", "X-OTA-Password"};
+    httpServer.collectHeaders(headerKeys, 3);
     httpServer.begin();
     Serial.println("REST API listening on port 8080.");
+
+    coapStarted = coapSocket.begin(COAP_PORT) == 1;
+    coapMessageId = static_cast<uint16_t>(micros());   // RFC 7252: randomise the first id
+    Serial.printf("CoAP %s on UDP port %u.\n", coapStarted ? "listening" : "FAILED to bind",
+                  static_cast<unsigned>(COAP_PORT));
 }
 
 // =============================================================================
 // Setup & Loop
 // =============================================================================
 
+/** Maps the ESP-IDF reset reason onto the causes decideResume() knows. */
+ResetCause resetCause(esp_reset_reason_t reason) {
+    switch (reason) {
+        case ESP_RST_POWERON:  return ResetCause::PowerOn;
+        case ESP_RST_BROWNOUT: return ResetCause::Brownout;
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:      return ResetCause::Watchdog;
+        case ESP_RST_PANIC:    return ResetCause::Panic;
+        case ESP_RST_SW:       return ResetCause::Software;
+        case ESP_RST_EXT:      return ResetCause::External;
+        default:               return ResetCause::Unknown;
+    }
+}
+
 void setup() {
     Serial.begin(115200);
     delay(1000);
@@ -331,6 +1499,23 @@ void setup() {
     }
 
     tempSensor.setWaitForConversion(false);  // Non-blocking reads
+    if (sensorCount > VOTE_MAX_PROBES) {
+        Serial.printf("Voting over the first %u probes\n", static_cast<unsigned>(VOTE_MAX_PROBES));
+    }
+    uint8_t probeCount = static_cast<uint8_t>(sensorCount > VOTE_MAX_PROBES ? VOTE_MAX_PROBES : sensorCount);
+    for (uint8_t i = 0; i < probeCount; ++i) {
+        // An all-zero address matches no device and reads as disconnected
+        if (!tempSensor.getAddress(probeAddresses[i], i)) {
+            memset(probeAddresses[i], 0, sizeof(DeviceAddress));
+            Serial.printf("Probe %u: no address, reads as disconnected\n", static_cast<unsigned>(i));
+        }
+    }
+    sensorVote.begin(probeCount);
+
+    // Event log drain — core 0, lowest priority above idle, so Serial output
+    // never competes with the loop task (core 1) that makes safety decisions
+    xTaskCreatePinnedToCore(logDrainTask, "logDrain", 3072, nullptr,
+                            tskIDLE_PRIORITY + 1, nullptr, 0);
 
     // Initialize HomeSpan — start HTTP server once WiFi connects
     homeSpan.setWifiCallback(startHttpServer);
@@ -354,10 +1539,110 @@ void setup() {
     // Hardware watchdog — resets ESP32 if loop() stalls for 30s
     esp_task_wdt_init(30, true);
     esp_task_wdt_add(NULL);
+
+    // Lifetime energy and the learned heat-up model survive reboots in NVS
+    energyStore.begin(ENERGY_NVS_NAMESPACE, false);
+    energyMeter.restore(energyStore.getULong64("on_ms", 0));
+    HeatupFit fit;
+    if (energyStore.getBytesLength("fit") == sizeof(fit) &&
+        energyStore.getBytes("fit", &fit, sizeof(fit)) == sizeof(fit)) {
+        heatupModel.restore(fit);
+    }
+    Serial.printf("Energy: %.1f kWh lifetime, heat-up model %s\n",
+                  energyKWh(energyMeter.lifetimeOnMs(millis()), HEATER_POWER_W),
+                  heatupModel.fitted() ? "learned" : "default");
+
+    // Pick up a session a brownout, watchdog or panic interrupted
+    // (copied out first — resuming writes a fresh checkpoint over it)
+    RetainedSession retained = retainedSession;
+    ResumeDecision resume = decideResume(resetCause(esp_reset_reason()), retained);
+    switch (resume) {
+        case ResumeDecision::Resume:
+            thermostat->resumeSession(retained);
+            logEvent(LogLevel::Safety, LogMsg::SessionResumed,
+                     static_cast<float>(resumedElapsedMs(retained) / 1000),
+                     static_cast<float>(retained.resumes + 1));
+            break;
+        case ResumeDecision::Corrupt:
+            logEvent(LogLevel::Safety, LogMsg::ResumeCorrupt);
+            break;
+        case ResumeDecision::TooManyResumes:
+            logEvent(LogLevel::Safety, LogMsg::ResumeTooMany, static_cast<float>(retained.resumes));
+            break;
+        case ResumeDecision::LimitReached:
+            logEvent(LogLevel::Safety, LogMsg::ResumeLimitReached);
+            break;
+        case ResumeDecision::PowerOn:
+        case ResumeDecision::NoSession:
+            break;
+    }
+    if (resume != ResumeDecision::Resume) {
+        clearRetainedSession(retainedSession);
+    }
+    Serial.printf("Reset: session %s\n", resumeDecisionName(resume));
+
+    // Safety jobs may run at most SAFETY_JOB_BUDGET_MS late before it is logged
+    scheduler.setBudget(JOB_CONVERSION_READ, SAFETY_JOB_BUDGET_MS);
+    scheduler.setBudget(JOB_SESSION_EXPIRY, SAFETY_JOB_BUDGET_MS);
+    uint32_t now = millis();
+    scheduler.arm(JOB_CONVERSION_REQUEST, now);
+    scheduler.arm(JOB_NETWORK, now);
 }
 
+void runJob(uint8_t job, uint32_t now) {
+    switch (job) {
+        case JOB_CONVERSION_READ:    thermostat->readConversion(); break;
+        case JOB_SESSION_EXPIRY:     thermostat->checkSessionExpiry(now); break;
+        case JOB_CONVERSION_REQUEST: thermostat->requestConversion(now); break;
+        case JOB_NETWORK: {
+            // Budget spent: leave connections in the TCP backlog until it refills
+            uint32_t waitMs = networkBudget.msUntil(now, 1);
+            if (waitMs > 0) {
+                ++networkDeferrals;
+                scheduler.arm(JOB_NETWORK, now + waitMs);
+                break;
+            }
+            uint32_t startUs = micros();
+            homeSpan.poll();
+            httpServer.handleClient();
+            coapPoll(now);
+            uint32_t after = millis();
+            // Cap the debt so one stalled client cannot defer HomeKit for more than ~1 s
+            uint32_t usedUs = micros() - startUs;
+            if (usedUs > NETWORK_SHARE_US_PER_SEC) usedUs = NETWORK_SHARE_US_PER_SEC;
+            networkBudget.charge(after, static_cast<int32_t>(usedUs));
+            bool active = after - lastHttpResponseMs < NETWORK_ACTIVE_WINDOW_MS;
+            scheduler.arm(JOB_NETWORK, after + (active ? NETWORK_POLL_ACTIVE_MS : NETWORK_POLL_IDLE_MS));
+            break;
+        }
+    }
+    if (scheduler.lastRunOverran(job)) {
+        logEvent(LogLevel::Warn, LogMsg::SchedulerOverrun, job,
+                 static_cast<float>(scheduler.stats(job).lastLatenessMs));
+    }
+}
+
+/**
+ * Runs every due job (safety first), then yields the core until the
+ * earliest deadline. vTaskDelay lets the idle task clock-gate the CPU;
+ * the loop never sleeps past an armed deadline or LOOP_MAX_SLEEP_MS.
+ */
 void loop() {
     esp_task_wdt_reset();
-    homeSpan.poll();
-    httpServer.handleClient();
+
+    uint32_t startUs = micros();
+    uint32_t now = millis();
+    for (int job = scheduler.takeDue(now); job != scheduler.NONE; job = scheduler.takeDue(now)) {
+        runJob(static_cast<uint8_t>(job), now);
+        now = millis();
+    }
+    uint32_t busyUs = micros() - startUs;
+    if (busyUs > maxLoopBusyUs) maxLoopBusyUs = busyUs;
+    ++loopPassCount;
+
+    uint32_t sleepMs = scheduler.msUntilNext(now, LOOP_MAX_SLEEP_MS);
+    if (sleepMs > 0) {
+        vTaskDelay(pdMS_TO_TICKS(sleepMs));
+        scheduler.recordSleep(sleepMs, millis() - now);
+    }
 }
@@ -0,0 +1,181 @@
+/**
+ * Unit tests for admission_control.h — runs on the host via PlatformIO native env.
+ *
+ * Covers token bucket refill and overdraw, per-client limiting, Retry-After
+ * computation, client-table eviction and the exemption for heater OFF.
+ */
+
+#include <unity.h>
+#include "admission_control.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+constexpr uint32_t IP_A = 0x3201A8C0;   // 192.168.1.50
+constexpr uint32_t IP_B = 0x3301A8C0;
+constexpr uint32_t IP_C = 0x3401A8C0;
+
+// =============================================================================
+// Token Bucket
+// =============================================================================
+
+void test_bucket_starts_full(void) {
+    TokenBucket b(5000, 1000);
+    TEST_ASSERT_EQUAL_INT32(5000, b.level(0));
+}
+
+void test_bucket_take_until_empty(void) {
+    TokenBucket b(3, 1);
+    TEST_ASSERT_TRUE(b.tryTake(0, 1));
+    TEST_ASSERT_TRUE(b.tryTake(0, 1));
+    TEST_ASSERT_TRUE(b.tryTake(0, 1));
+    TEST_ASSERT_FALSE(b.tryTake(0, 1));
+    TEST_ASSERT_EQUAL_INT32(0, b.level(0));
+}
+
+void test_bucket_refills_at_rate(void) {
+    TokenBucket b(10000, 2000);   // 2000 units/s
+    b.tryTake(0, 10000);
+    TEST_ASSERT_EQUAL_INT32(1000, b.level(500));
+    TEST_ASSERT_EQUAL_INT32(2000, b.level(1000));
+}
+
+void test_bucket_caps_at_capacity(void) {
+    TokenBucket b(100, 1000);
+    b.tryTake(0, 50);
+    TEST_ASSERT_EQUAL_INT32(100, b.level(60000));
+}
+
+void test_bucket_slow_rate_not_rounded_away(void) {
+    // 1 unit/s polled every 100 ms must still refill
+    TokenBucket b(1, 1);
+    b.tryTake(0, 1);
+    uint32_t now = 0;
+    for (int i = 0; i < 9; ++i) {
+        now += 100;
+        TEST_ASSERT_EQUAL_INT32(0, b.level(now));
+    }
+    TEST_ASSERT_EQUAL_INT32(1, b.level(now + 100));
+}
+
+void test_bucket_charge_overdraws(void) {
+    TokenBucket b(50000, 500000);   // 50 ms budget, 50% share, in µs
+    b.charge(0, 80000);
+    TEST_ASSERT_EQUAL_INT32(-30000, b.level(0));
+    TEST_ASSERT_EQUAL_UINT32(61, b.msUntil(0, 1));   // 30001 µs at 500 µs/ms
+    TEST_ASSERT_EQUAL_UINT32(0, b.msUntil(61, 1));
+}
+
+void test_bucket_ms_until_zero_rate(void) {
+    TokenBucket b(1, 0);
+    b.tryTake(0, 1);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, b.msUntil(0, 1));
+}
+
+void test_bucket_across_millis_wrap(void) {
+    TokenBucket b(10, 1000, 0xFFFFFF00u);
+    b.tryTake(0xFFFFFF00u, 10);
+    TEST_ASSERT_EQUAL_INT32(5, b.level(0xFFFFFF05u));
+    TEST_ASSERT_EQUAL_INT32(10, b.level(0x00000010u));
+}
+
+// =============================================================================
+// Client Rate Limiter
+// =============================================================================
+
+void test_limiter_allows_burst_then_rejects(void) {
+    ClientRateLimiter<4> lim(5, 1);
+    for (int i = 0; i < 5; ++i) TEST_ASSERT_TRUE(lim.admit(IP_A, 0).admitted);
+    AdmissionDecision d = lim.admit(IP_A, 0);
+    TEST_ASSERT_FALSE(d.admitted);
+    TEST_ASSERT_EQUAL_UINT32(1, d.retryAfterSec);
+    TEST_ASSERT_EQUAL_UINT32(5, lim.admitted());
+    TEST_ASSERT_EQUAL_UINT32(1, lim.rejected());
+}
+
+void test_limiter_sustained_rate(void) {
+    // 2 req/s sustained: one request every 500 ms is always admitted
+    ClientRateLimiter<4> lim(1, 2);
+    for (uint32_t t = 0; t < 10000; t += 500) {
+        TEST_ASSERT_TRUE(lim.admit(IP_A, t).admitted);
+    }
+    TEST_ASSERT_FALSE(lim.admit(IP_A, 9600).admitted);
+}
+
+void test_limiter_retry_after_rounds_up(void) {
+    ClientRateLimiter<4> lim(1, 1);
+    lim.admit(IP_A, 0);
+    AdmissionDecision d = lim.admit(IP_A, 1);
+    TEST_ASSERT_FALSE(d.admitted);
+    TEST_ASSERT_EQUAL_UINT32(1, d.retryAfterSec);   // 999 ms → 1 s
+    TEST_ASSERT_TRUE(lim.admit(IP_A, 1000).admitted);
+}
+
+void test_limiter_clients_independent(void) {
+    ClientRateLimiter<4> lim(1, 1);
+    TEST_ASSERT_TRUE(lim.admit(IP_A, 0).admitted);
+    TEST_ASSERT_FALSE(lim.admit(IP_A, 0).admitted);
+    TEST_ASSERT_TRUE(lim.admit(IP_B, 0).admitted);
+    TEST_ASSERT_EQUAL_UINT8(2, lim.clients());
+}
+
+void test_limiter_evicts_least_recently_seen(void) {
+    ClientRateLimiter<2> lim(1, 1);
+    lim.admit(IP_A, 0);
+    lim.admit(IP_B, 100);
+    lim.admit(IP_A, 200);     // A is now the most recent
+    lim.admit(IP_C, 300);     // Evicts B
+    TEST_ASSERT_EQUAL_UINT32(1, lim.evictions());
+    TEST_ASSERT_EQUAL_UINT8(2, lim.clients());
+    // A kept its (empty) bucket; B comes back fresh
+    TEST_ASSERT_FALSE(lim.admit(IP_A, 300).admitted);
+    TEST_ASSERT_TRUE(lim.admit(IP_B, 300).admitted);
+}
+
+void test_limiter_exempt_admitted_when_empty(void) {
+    // Heater OFF gets through an empty bucket and does not drain it further
+    ClientRateLimiter<4> lim(2, 1);
+    lim.admit(IP_A, 0);
+    lim.admit(IP_A, 0);
+    TEST_ASSERT_FALSE(lim.admit(IP_A, 0).admitted);
+    for (int i = 0; i < 10; ++i) TEST_ASSERT_TRUE(lim.admit(IP_A, 0, true).admitted);
+    TEST_ASSERT_FALSE(lim.admit(IP_A, 500).admitted);
+    TEST_ASSERT_TRUE(lim.admit(IP_A, 1000).admitted);
+}
+
+void test_limiter_flood_from_one_client_bounded(void) {
+    // 1000 requests in 1 s from one IP — only burst + rate get through
+    ClientRateLimiter<8> lim(20, 10);
+    uint32_t ok = 0;
+    for (uint32_t i = 0; i < 1000; ++i) ok += lim.admit(IP_A, i).admitted ? 1 : 0;
+    TEST_ASSERT_TRUE(ok >= 29 && ok <= 30);
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Token bucket
+    RUN_TEST(test_bucket_starts_full);
+    RUN_TEST(test_bucket_take_until_empty);
+    RUN_TEST(test_bucket_refills_at_rate);
+    RUN_TEST(test_bucket_caps_at_capacity);
+    RUN_TEST(test_bucket_slow_rate_not_rounded_away);
+    RUN_TEST(test_bucket_charge_overdraws);
+    RUN_TEST(test_bucket_ms_until_zero_rate);
+    RUN_TEST(test_bucket_across_millis_wrap);
+
+    // Client rate limiter
+    RUN_TEST(test_limiter_allows_burst_then_rejects);
+    RUN_TEST(test_limiter_sustained_rate);
+    RUN_TEST(test_limiter_retry_after_rounds_up);
+    RUN_TEST(test_limiter_clients_independent);
+    RUN_TEST(test_limiter_evicts_least_recently_seen);
+    RUN_TEST(test_limiter_exempt_admitted_when_empty);
+    RUN_TEST(test_limiter_flood_from_one_client_bounded);
+
+    return UNITY_END();
+}
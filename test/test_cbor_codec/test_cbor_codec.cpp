@@ -0,0 +1,486 @@
+/**
+ * Unit tests for cbor_codec.h — runs on the host via PlatformIO native env.
+ *
+ * Covers the writer's shortest-form heads and floats, the status document
+ * against its JSON twin (status_report.h), command decoding with the same
+ * validation as the JSON path, malformed input, and a benchmark of encode
+ * and decode cost and payload size against JSON.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "cbor_codec.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/** Encodes a single number and decodes it back. */
+static float roundTrip(float f, size_t& len) {
+    uint8_t buf[8];
+    CborWriter w(buf, sizeof(buf));
+    w.number(f);
+    len = w.length();
+    CborReader r(buf, len);
+    uint8_t major, info;
+    uint64_t arg;
+    float out = -999.0f;
+    if (r.readHead(major, info, arg)) cborNumber(major, info, arg, out);
+    return out;
+}
+
+/** Top-level number for key in an encoded status map, or -999 if absent or not a number. */
+static float statusNumber(const uint8_t* buf, size_t len, const char* key) {
+    CborReader r(buf, len);
+    uint8_t major, info;
+    uint64_t pairs;
+    if (!r.readHead(major, info, pairs) || major != 5) return -999.0f;
+    for (uint64_t i = 0; i < pairs; ++i) {
+        const char* k;
+        size_t n;
+        if (!r.readText(k, n)) return -999.0f;
+        if (n == std::strlen(key) && std::memcmp(k, key, n) == 0) {
+            uint64_t arg;
+            float out;
+            if (!r.readHead(major, info, arg) || !cborNumber(major, info, arg, out)) return -999.0f;
+            return out;
+        }
+        if (!r.skip()) return -999.0f;
+    }
+    return -999.0f;
+}
+
+static StatusReport sampleStatus(void) {
+    StatusReport s;
+    s.currentC = 72.4f;
+    s.targetC = 80.0f;
+    s.heating = true;
+    s.firmware = "1.0.0";
+    s.probeCount = 1;
+    s.probes[0].c = 72.4f;
+    return s;
+}
+
+/** The busiest document: a profile running and three probes, one missing. */
+static StatusReport worstStatus(void) {
+    StatusReport s = sampleStatus();
+    s.currentC = 104.3f;
+    s.profileRunning = true;
+    s.segment = 7;
+    s.segments = 8;
+    s.phase = ProfilePhase::Settle;
+    s.segmentRemainingS = 3600;
+    s.remainingS = 3600;
+    s.probeCount = 3;
+    s.probes[0].c = 104.3f;
+    s.probes[0].dev = 0.1f;
+    s.probes[1].c = 104.4f;
+    s.probes[1].dev = 0.1f;
+    s.probes[2].c = SENSOR_DISCONNECTED_C;
+    s.probes[2].state = ProbeState::Disagree;
+    s.probes[2].dev = 112.7f;
+    return s;
+}
+
+static const uint8_t STATE_KEY[] = {0x65, 's', 't', 'a', 't', 'e'};
+static const uint8_t TEMP_KEY[] = {0x6B, 't', 'e', 'm', 'p', 'e', 'r', 'a', 't', 'u', 'r', 'e'};
+
+/** A one-entry map {key: value bytes}. */
+static size_t oneField(uint8_t* out, const uint8_t* key, size_t keyLen,
+                       const uint8_t* value, size_t valueLen) {
+    out[0] = 0xA1;
+    std::memcpy(out + 1, key, keyLen);
+    std::memcpy(out + 1 + keyLen, value, valueLen);
+    return 1 + keyLen + valueLen;
+}
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+void test_integer_heads_shortest_form(void) {
+    uint8_t buf[32];
+    CborWriter w(buf, sizeof(buf));
+    w.unsignedInt(23);
+    w.unsignedInt(24);
+    w.unsignedInt(256);
+    w.unsignedInt(65536);
+    const uint8_t expected[] = {0x17, 0x18, 0x18, 0x19, 0x01, 0x00, 0x1A, 0x00, 0x01, 0x00, 0x00};
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), w.length());
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, sizeof(expected));
+}
+
+void test_simple_values(void) {
+    uint8_t buf[4];
+    CborWriter w(buf, sizeof(buf));
+    w.boolean(false);
+    w.boolean(true);
+    w.null();
+    const uint8_t expected[] = {0xF4, 0xF5, 0xF6};
+    TEST_ASSERT_EQUAL_UINT32(3, w.length());
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, 3);
+}
+
+void test_float_uses_half_when_exact(void) {
+    size_t len;
+    TEST_ASSERT_EQUAL_FLOAT(72.5f, roundTrip(72.5f, len));
+    TEST_ASSERT_EQUAL_UINT32(3, len);
+    TEST_ASSERT_EQUAL_FLOAT(72.4f, roundTrip(72.4f, len));
+    TEST_ASSERT_EQUAL_UINT32(5, len);
+    TEST_ASSERT_EQUAL_FLOAT(-127.0f, roundTrip(-127.0f, len));
+    TEST_ASSERT_EQUAL_UINT32(3, len);
+    TEST_ASSERT_EQUAL_FLOAT(5.9604645e-8f, roundTrip(5.9604645e-8f, len));   // Smallest half subnormal
+    TEST_ASSERT_EQUAL_UINT32(3, len);
+    TEST_ASSERT_TRUE(std::isnan(roundTrip(NAN, len)));
+}
+
+void test_every_tenth_round_trips(void) {
+    for (int t = -1270; t <= 1270; ++t) {
+        size_t len;
+        float c = cbor_detail::tenths(t / 10.0f);
+        TEST_ASSERT_EQUAL_FLOAT(c, roundTrip(c, len));
+    }
+}
+
+void test_overflow_reports_zero_length(void) {
+    uint8_t buf[4];
+    CborWriter w(buf, sizeof(buf));
+    w.text("status");
+    TEST_ASSERT_FALSE(w.ok());
+    TEST_ASSERT_EQUAL_UINT32(0, w.length());
+}
+
+// =============================================================================
+// Status
+// =============================================================================
+
+void test_status_begins_with_fixed_schema(void) {
+    uint8_t buf[STATUS_CBOR_SIZE];
+    size_t len = encodeStatusCbor(sampleStatus(), buf, sizeof(buf));
+    TEST_ASSERT_TRUE(len > 0);
+    // Map of 6, then the text key "current_temp"
+    const uint8_t head[] = {0xA6, 0x6C, 'c', 'u', 'r', 'r', 'e', 'n', 't', '_', 't', 'e', 'm', 'p'};
+    TEST_ASSERT_EQUAL_MEMORY(head, buf, sizeof(head));
+    CborReader r(buf, len);
+    TEST_ASSERT_TRUE(r.skip());
+    TEST_ASSERT_TRUE(r.atEnd());
+}
+
+void test_status_numbers_match_json(void) {
+    StatusReport s = sampleStatus();
+    s.currentC = 68.37f;     // JSON shows 68.4
+    s.targetC = 85.5f;
+    uint8_t buf[STATUS_CBOR_SIZE];
+    size_t len = encodeStatusCbor(s, buf, sizeof(buf));
+    char json[STATUS_JSON_SIZE];
+    TEST_ASSERT_TRUE(formatStatusJson(s, json, sizeof(json)) > 0);
+
+    const char* cur = std::strstr(json, "\"current_temp\":") + std::strlen("\"current_temp\":");
+    const char* tgt = std::strstr(json, "\"target_temp\":") + std::strlen("\"target_temp\":");
+    TEST_ASSERT_EQUAL_FLOAT(std::strtof(cur, nullptr), statusNumber(buf, len, "current_temp"));
+    TEST_ASSERT_EQUAL_FLOAT(std::strtof(tgt, nullptr), statusNumber(buf, len, "target_temp"));
+}
+
+void test_worst_case_status_fits(void) {
+    StatusReport s = worstStatus();
+    uint8_t buf[STATUS_CBOR_SIZE];
+    size_t len = encodeStatusCbor(s, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(len > 0);
+    char json[STATUS_JSON_SIZE];
+    size_t jsonLen = formatStatusJson(s, json, sizeof(json));
+    TEST_ASSERT_TRUE(jsonLen > 0);
+    TEST_ASSERT_TRUE(len < jsonLen);
+    TEST_ASSERT_NOT_NULL(std::strstr(json, "{\"c\":null,\"dev\":112.7,\"state\":\"disagree\"}"));
+}
+
+void test_ok_acknowledgement(void) {
+    uint8_t buf[8];
+    const uint8_t expected[] = {0xA1, 0x62, 'o', 'k', 0xF5};
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), encodeOkCbor(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, sizeof(expected));
+}
+
+// =============================================================================
+// Commands
+// =============================================================================
+
+void test_parse_state_integer_and_boolean(void) {
+    uint8_t body[16];
+    const uint8_t one[] = {0x01};
+    const uint8_t off[] = {0xF4};
+    SessionCommand cmd;
+    size_t len = oneField(body, STATE_KEY, sizeof(STATE_KEY), one, sizeof(one));
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, cmd) == SessionCommandResult::Ok);
+    TEST_ASSERT_TRUE(cmd.hasState);
+    TEST_ASSERT_EQUAL_INT(1, cmd.state);
+
+    SessionCommand cmd2;
+    len = oneField(body, STATE_KEY, sizeof(STATE_KEY), off, sizeof(off));
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, cmd2) == SessionCommandResult::Ok);
+    TEST_ASSERT_EQUAL_INT(0, cmd2.state);
+    TEST_ASSERT_FALSE(cmd2.hasTemperature);
+}
+
+void test_parse_temperature_any_number(void) {
+    uint8_t body[24];
+    const uint8_t whole[] = {0x18, 85};                                       // 85
+    const uint8_t half[] = {0xF9, 0x55, 0x58};                               // 85.5
+    const uint8_t single[] = {0xFA, 0x42, 0xAA, 0x99, 0x9A};                 // 85.3
+    const uint8_t dbl[] = {0xFB, 0x40, 0x55, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00};  // 85.0
+    const uint8_t* values[] = {whole, half, single, dbl};
+    const size_t sizes[] = {sizeof(whole), sizeof(half), sizeof(single), sizeof(dbl)};
+    const float expected[] = {85.0f, 85.5f, 85.3f, 85.0f};
+    for (int i = 0; i < 4; ++i) {
+        SessionCommand cmd;
+        size_t len = oneField(body, TEMP_KEY, sizeof(TEMP_KEY), values[i], sizes[i]);
+        TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, cmd) == SessionCommandResult::Ok);
+        TEST_ASSERT_TRUE(cmd.hasTemperature);
+        TEST_ASSERT_EQUAL_FLOAT(expected[i], cmd.temperature);
+    }
+}
+
+void test_parse_both_fields_skipping_unknown(void) {
+    // {"client": {"name": "panel", "ids": [1, 2]}, "state": true, "temperature": 90}
+    const uint8_t body[] = {
+        0xA3,
+        0x66, 'c', 'l', 'i', 'e', 'n', 't',
+        0xA2, 0x64, 'n', 'a', 'm', 'e', 0x65, 'p', 'a', 'n', 'e', 'l',
+              0x63, 'i', 'd', 's', 0x82, 0x01, 0x02,
+        0x65, 's', 't', 'a', 't', 'e', 0xF5,
+        0x6B, 't', 'e', 'm', 'p', 'e', 'r', 'a', 't', 'u', 'r', 'e', 0x18, 90,
+    };
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, sizeof(body), cmd) == SessionCommandResult::Ok);
+    TEST_ASSERT_EQUAL_INT(1, cmd.state);
+    TEST_ASSERT_EQUAL_FLOAT(90.0f, cmd.temperature);
+}
+
+void test_parse_no_fields(void) {
+    const uint8_t empty[] = {0xA0};
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(empty, sizeof(empty), cmd) == SessionCommandResult::NoFields);
+}
+
+void test_parse_wrong_types(void) {
+    uint8_t body[24];
+    const uint8_t text[] = {0x61, '1'};
+    SessionCommand cmd;
+    size_t len = oneField(body, STATE_KEY, sizeof(STATE_KEY), text, sizeof(text));
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, cmd) == SessionCommandResult::InvalidState);
+
+    const uint8_t half[] = {0xF9, 0x3C, 0x00};    // 1.0 — JSON rejects "1.0" for state too
+    SessionCommand cmd2;
+    len = oneField(body, STATE_KEY, sizeof(STATE_KEY), half, sizeof(half));
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, cmd2) == SessionCommandResult::InvalidState);
+
+    const uint8_t yes[] = {0xF5};
+    SessionCommand cmd3;
+    len = oneField(body, TEMP_KEY, sizeof(TEMP_KEY), yes, sizeof(yes));
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, cmd3) == SessionCommandResult::InvalidTemperature);
+}
+
+void test_parse_malformed(void) {
+    const uint8_t notMap[] = {0x81, 0x01};
+    const uint8_t truncated[] = {0xA1, 0x65, 's', 't', 'a'};
+    const uint8_t trailing[] = {0xA1, 0x65, 's', 't', 'a', 't', 'e', 0x01, 0x00};
+    const uint8_t indefinite[] = {0xBF, 0x65, 's', 't', 'a', 't', 'e', 0x01, 0xFF};
+    const uint8_t intKey[] = {0xA1, 0x01, 0x01};
+    const uint8_t duplicate[] = {0xA2, 0x65, 's', 't', 'a', 't', 'e', 0x01,
+                                       0x65, 's', 't', 'a', 't', 'e', 0x00};
+    const uint8_t hugeText[] = {0xA1, 0x7A, 0xFF, 0xFF, 0xFF, 0xFF};
+    const uint8_t* bodies[] = {notMap, truncated, trailing, indefinite, intKey, duplicate, hugeText};
+    const size_t sizes[] = {sizeof(notMap), sizeof(truncated), sizeof(trailing), sizeof(indefinite),
+                            sizeof(intKey), sizeof(duplicate), sizeof(hugeText)};
+    for (int i = 0; i < 7; ++i) {
+        SessionCommand cmd;
+        TEST_ASSERT_TRUE(parseSessionCommandCbor(bodies[i], sizes[i], cmd) ==
+                         SessionCommandResult::MalformedCbor);
+    }
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(nullptr, 0, cmd) == SessionCommandResult::MalformedCbor);
+}
+
+void test_deep_nesting_rejected(void) {
+    // {"x": [[[[[[[[[[1]]]]]]]]]]} — deeper than CBOR_MAX_DEPTH
+    uint8_t body[32] = {0xA1, 0x61, 'x'};
+    size_t len = 3;
+    for (int i = 0; i < 10; ++i) body[len++] = 0x81;
+    body[len++] = 0x01;
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, cmd) == SessionCommandResult::MalformedCbor);
+}
+
+void test_validation_matches_json(void) {
+    // Same rules as the JSON body, applied by the shared validator
+    uint8_t body[24];
+    const uint8_t two[] = {0x02};
+    const uint8_t hot[] = {0x18, 101};
+    const uint8_t on[] = {0xF5};
+    SessionCommand a, b, c;
+    size_t len = oneField(body, STATE_KEY, sizeof(STATE_KEY), two, sizeof(two));
+    parseSessionCommandCbor(body, len, a);
+    TEST_ASSERT_TRUE(validateSessionCommand(a, false) == SessionCommandResult::InvalidState);
+
+    len = oneField(body, TEMP_KEY, sizeof(TEMP_KEY), hot, sizeof(hot));
+    parseSessionCommandCbor(body, len, b);
+    TEST_ASSERT_TRUE(validateSessionCommand(b, false) == SessionCommandResult::TemperatureOutOfRange);
+
+    len = oneField(body, STATE_KEY, sizeof(STATE_KEY), on, sizeof(on));
+    parseSessionCommandCbor(body, len, c);
+    TEST_ASSERT_TRUE(validateSessionCommand(c, true) == SessionCommandResult::SensorFault);
+}
+
+void test_zero_bytes_decode(void) {
+    // Integer state 0 and whole-degree half floats contain 0x00 bytes; the
+    // firmware reads bodies raw, so these must decode like any other
+    const uint8_t off[] = {0xA1, 0x65, 's', 't', 'a', 't', 'e', 0x00};
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(off, sizeof(off), cmd) == SessionCommandResult::Ok);
+    TEST_ASSERT_TRUE(validateSessionCommand(cmd, true) == SessionCommandResult::Ok);
+    TEST_ASSERT_TRUE(isHeaterOffCommand(cmd));
+
+    const uint8_t half64[] = {0xF9, 0x54, 0x00};
+    const uint8_t half80[] = {0xF9, 0x55, 0x00};
+    uint8_t body[24];
+    SessionCommand a, b;
+    size_t len = oneField(body, TEMP_KEY, sizeof(TEMP_KEY), half64, sizeof(half64));
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, a) == SessionCommandResult::Ok);
+    TEST_ASSERT_EQUAL_FLOAT(64.0f, a.temperature);
+    len = oneField(body, TEMP_KEY, sizeof(TEMP_KEY), half80, sizeof(half80));
+    TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, b) == SessionCommandResult::Ok);
+    TEST_ASSERT_EQUAL_FLOAT(80.0f, b.temperature);
+}
+
+void test_status_target_posts_back(void) {
+    // A client can send back the target_temp it read from /status unchanged
+    const float targets[] = {64.0f, 80.0f, 85.5f, 72.4f};
+    for (int i = 0; i < 4; ++i) {
+        StatusReport s = sampleStatus();
+        s.targetC = targets[i];
+        uint8_t status[STATUS_CBOR_SIZE];
+        size_t statusLen = encodeStatusCbor(s, status, sizeof(status));
+
+        // Copy the encoded target_temp value into {"temperature": <value>}
+        CborReader r(status, statusLen);
+        uint8_t major, info;
+        uint64_t pairs;
+        TEST_ASSERT_TRUE(r.readHead(major, info, pairs));
+        const uint8_t* value = nullptr;
+        size_t valueLen = 0;
+        for (uint64_t p = 0; p < pairs; ++p) {
+            const char* k;
+            size_t n;
+            TEST_ASSERT_TRUE(r.readText(k, n));
+            size_t before = statusLen - r.remaining();
+            TEST_ASSERT_TRUE(r.skip());
+            if (n == 11 && std::memcmp(k, "target_temp", n) == 0) {
+                value = status + before;
+                valueLen = statusLen - r.remaining() - before;
+            }
+        }
+        TEST_ASSERT_NOT_NULL(value);
+
+        uint8_t body[32];
+        size_t len = oneField(body, TEMP_KEY, sizeof(TEMP_KEY), value, valueLen);
+        SessionCommand cmd;
+        TEST_ASSERT_TRUE(parseSessionCommandCbor(body, len, cmd) == SessionCommandResult::Ok);
+        TEST_ASSERT_TRUE(validateSessionCommand(cmd, false) == SessionCommandResult::Ok);
+        TEST_ASSERT_EQUAL_FLOAT(targets[i], cmd.temperature);
+    }
+}
+
+// =============================================================================
+// Benchmark
+// =============================================================================
+
+static volatile size_t benchSink = 0;
+
+template <typename F>
+static double nsPerOp(F fn, int iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn(i);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+void test_benchmark_against_json(void) {
+    const int N = 20000;
+    StatusReport s = worstStatus();
+    char json[STATUS_JSON_SIZE];
+    uint8_t cbor[STATUS_CBOR_SIZE];
+    size_t jsonLen = formatStatusJson(s, json, sizeof(json));
+    size_t cborLen = encodeStatusCbor(s, cbor, sizeof(cbor));
+
+    // Vary the temperature so neither path can cache its output
+    double jsonEncode = nsPerOp([&](int i) {
+        s.currentC = 60.0f + (i % 400) / 10.0f;
+        benchSink = benchSink + formatStatusJson(s, json, sizeof(json));
+    }, N);
+    double cborEncode = nsPerOp([&](int i) {
+        s.currentC = 60.0f + (i % 400) / 10.0f;
+        benchSink = benchSink + encodeStatusCbor(s, cbor, sizeof(cbor));
+    }, N);
+
+    const char* jsonCmd = "{\"state\":1,\"temperature\":85.5}";
+    const uint8_t cborCmd[] = {0xA2, 0x65, 's', 't', 'a', 't', 'e', 0xF5,
+                               0x6B, 't', 'e', 'm', 'p', 'e', 'r', 'a', 't', 'u', 'r', 'e',
+                               0xF9, 0x55, 0x58};
+    double jsonDecode = nsPerOp([&](int) {
+        SessionCommand cmd;
+        benchSink = benchSink + static_cast<size_t>(parseSessionCommand(jsonCmd, cmd)) + cmd.state;
+    }, N);
+    double cborDecode = nsPerOp([&](int) {
+        SessionCommand cmd;
+        benchSink = benchSink +
+            static_cast<size_t>(parseSessionCommandCbor(cborCmd, sizeof(cborCmd), cmd)) + cmd.state;
+    }, N);
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "status:  JSON %u B %.0f ns, CBOR %u B %.0f ns",
+                  static_cast<unsigned>(jsonLen), jsonEncode, static_cast<unsigned>(cborLen), cborEncode);
+    TEST_MESSAGE(line);
+    std::snprintf(line, sizeof(line), "command: JSON %u B %.0f ns, CBOR %u B %.0f ns",
+                  static_cast<unsigned>(std::strlen(jsonCmd)), jsonDecode,
+                  static_cast<unsigned>(sizeof(cborCmd)), cborDecode);
+    TEST_MESSAGE(line);
+
+    // Timings depend on the host and its load, so they are reported, not asserted
+    TEST_ASSERT_TRUE(cborLen < jsonLen);
+    TEST_ASSERT_TRUE(sizeof(cborCmd) < std::strlen(jsonCmd));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Writer
+    RUN_TEST(test_integer_heads_shortest_form);
+    RUN_TEST(test_simple_values);
+    RUN_TEST(test_float_uses_half_when_exact);
+    RUN_TEST(test_every_tenth_round_trips);
+    RUN_TEST(test_overflow_reports_zero_length);
+
+    // Status
+    RUN_TEST(test_status_begins_with_fixed_schema);
+    RUN_TEST(test_status_numbers_match_json);
+    RUN_TEST(test_worst_case_status_fits);
+    RUN_TEST(test_ok_acknowledgement);
+
+    // Commands
+    RUN_TEST(test_parse_state_integer_and_boolean);
+    RUN_TEST(test_parse_temperature_any_number);
+    RUN_TEST(test_parse_both_fields_skipping_unknown);
+    RUN_TEST(test_parse_no_fields);
+    RUN_TEST(test_parse_wrong_types);
+    RUN_TEST(test_parse_malformed);
+    RUN_TEST(test_deep_nesting_rejected);
+    RUN_TEST(test_validation_matches_json);
+    RUN_TEST(test_zero_bytes_decode);
+    RUN_TEST(test_status_target_posts_back);
+
+    // Benchmark
+    RUN_TEST(test_benchmark_against_json);
+
+    return UNITY_END();
+}
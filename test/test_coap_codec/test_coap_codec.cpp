@@ -0,0 +1,323 @@
+/**
+ * Unit tests for coap_codec.h — runs on the host via PlatformIO native env.
+ *
+ * Covers decoding hand-built datagrams (extended option deltas, unknown
+ * critical options, malformed headers), encode/decode round trips, response
+ * skeletons, and the Observe registry's liveness probes and drops.
+ */
+
+#include <unity.h>
+#include <cstring>
+#include "coap_codec.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+constexpr uint32_t IP = 0xC0A80132;   // 192.168.1.50
+
+// =============================================================================
+// Parsing
+// =============================================================================
+
+void test_parse_get_with_path(void) {
+    // CON GET, mid 0x1234, token 0xAB, Uri-Path "sauna" / "status"
+    const uint8_t d[] = {0x41, 0x01, 0x12, 0x34, 0xAB,
+                         0xB5, 's', 'a', 'u', 'n', 'a',
+                         0x06, 's', 't', 'a', 't', 'u', 's'};
+    CoapMessage m;
+    TEST_ASSERT_TRUE(parseCoap(d, sizeof(d), m) == CoapParseResult::Ok);
+    TEST_ASSERT_TRUE(m.type == CoapType::Confirmable);
+    TEST_ASSERT_EQUAL_UINT8(COAP_GET, m.code);
+    TEST_ASSERT_EQUAL_UINT16(0x1234, m.messageId);
+    TEST_ASSERT_EQUAL_UINT8(1, m.tokenLen);
+    TEST_ASSERT_EQUAL_HEX8(0xAB, m.token[0]);
+    TEST_ASSERT_EQUAL_STRING("sauna/status", m.path);
+    TEST_ASSERT_NULL(m.payload);
+}
+
+void test_parse_extended_delta_and_length(void) {
+    // Uri-Path of 14 bytes (length nibble 13 + 1), then an elective option
+    // 300 (delta 289 = nibble 14 + 0x0014), then a payload
+    uint8_t d[40] = {0x50, 0x02, 0x00, 0x07, 0xBD, 0x01};
+    size_t n = 6;
+    std::memcpy(d + n, "abcdefghijklmn", 14);
+    n += 14;
+    d[n++] = 0xE0;
+    d[n++] = 0x00;
+    d[n++] = 0x14;
+    d[n++] = 0xFF;
+    d[n++] = '{';
+    d[n++] = '}';
+    CoapMessage m;
+    TEST_ASSERT_TRUE(parseCoap(d, n, m) == CoapParseResult::Ok);
+    TEST_ASSERT_TRUE(m.type == CoapType::NonConfirmable);
+    TEST_ASSERT_EQUAL_STRING("abcdefghijklmn", m.path);
+    TEST_ASSERT_EQUAL_UINT32(2, m.payloadLen);
+    TEST_ASSERT_EQUAL_MEMORY("{}", m.payload, 2);
+}
+
+void test_parse_options(void) {
+    // Observe 0, Uri-Path "status", Content-Format 50, Max-Age 60, Accept 50
+    const uint8_t d[] = {0x40, 0x01, 0x00, 0x01,
+                         0x60,
+                         0x56, 's', 't', 'a', 't', 'u', 's',
+                         0x11, 50,
+                         0x21, 60,
+                         0x31, 50};
+    CoapMessage m;
+    TEST_ASSERT_TRUE(parseCoap(d, sizeof(d), m) == CoapParseResult::Ok);
+    TEST_ASSERT_TRUE(m.hasObserve);
+    TEST_ASSERT_EQUAL_UINT32(0, m.observe);
+    TEST_ASSERT_EQUAL_UINT16(COAP_FORMAT_JSON, m.contentFormat);
+    TEST_ASSERT_TRUE(m.hasMaxAge);
+    TEST_ASSERT_EQUAL_UINT32(60, m.maxAge);
+    TEST_ASSERT_EQUAL_UINT16(COAP_FORMAT_JSON, m.accept);
+}
+
+void test_unknown_options(void) {
+    CoapMessage m;
+    // Option 9 (odd, critical) — well formed, but must be refused
+    const uint8_t critical[] = {0x40, 0x01, 0x00, 0x01, 0x90};
+    TEST_ASSERT_TRUE(parseCoap(critical, sizeof(critical), m) == CoapParseResult::UnknownCriticalOption);
+    TEST_ASSERT_EQUAL_UINT16(1, m.messageId);
+    // Option 10 (even, elective) — silently skipped
+    const uint8_t elective[] = {0x40, 0x01, 0x00, 0x01, 0xA2, 0x01, 0x02};
+    TEST_ASSERT_TRUE(parseCoap(elective, sizeof(elective), m) == CoapParseResult::Ok);
+}
+
+void test_parse_rejects_malformed(void) {
+    CoapMessage m;
+    const uint8_t shortHdr[] = {0x40, 0x01, 0x00};
+    TEST_ASSERT_TRUE(parseCoap(shortHdr, sizeof(shortHdr), m) == CoapParseResult::TooShort);
+    const uint8_t version2[] = {0x80, 0x01, 0x00, 0x01};
+    TEST_ASSERT_TRUE(parseCoap(version2, sizeof(version2), m) == CoapParseResult::BadVersion);
+    const uint8_t token9[] = {0x49, 0x01, 0x00, 0x01, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    TEST_ASSERT_TRUE(parseCoap(token9, sizeof(token9), m) == CoapParseResult::BadTokenLength);
+    const uint8_t tokenCut[] = {0x44, 0x01, 0x00, 0x01, 1, 2};
+    TEST_ASSERT_TRUE(parseCoap(tokenCut, sizeof(tokenCut), m) == CoapParseResult::TooShort);
+    const uint8_t valueCut[] = {0x40, 0x01, 0x00, 0x01, 0xB6, 's'};
+    TEST_ASSERT_TRUE(parseCoap(valueCut, sizeof(valueCut), m) == CoapParseResult::BadOption);
+    const uint8_t extCut[] = {0x40, 0x01, 0x00, 0x01, 0xE0, 0x00};
+    TEST_ASSERT_TRUE(parseCoap(extCut, sizeof(extCut), m) == CoapParseResult::BadOption);
+    const uint8_t reserved[] = {0x40, 0x01, 0x00, 0x01, 0xF0};
+    TEST_ASSERT_TRUE(parseCoap(reserved, sizeof(reserved), m) == CoapParseResult::BadOption);
+    const uint8_t emptyPayload[] = {0x40, 0x02, 0x00, 0x01, 0xFF};
+    TEST_ASSERT_TRUE(parseCoap(emptyPayload, sizeof(emptyPayload), m) == CoapParseResult::BadOption);
+}
+
+void test_path_too_long(void) {
+    uint8_t d[64] = {0x40, 0x01, 0x00, 0x01, 0xBD, 0x14};   // 33-byte segment
+    std::memset(d + 6, 'a', 33);
+    CoapMessage m;
+    TEST_ASSERT_TRUE(parseCoap(d, 6 + 33, m) == CoapParseResult::PathTooLong);
+    d[5] = 0x13;                                            // 32 bytes fits exactly
+    TEST_ASSERT_TRUE(parseCoap(d, 6 + 32, m) == CoapParseResult::Ok);
+    TEST_ASSERT_EQUAL_UINT32(COAP_MAX_PATH, std::strlen(m.path));
+}
+
+// =============================================================================
+// Encoding
+// =============================================================================
+
+void test_round_trip(void) {
+    const char body[] = "{\"current_temp\":80.5}";
+    CoapMessage out;
+    out.type = CoapType::NonConfirmable;
+    out.code = COAP_CONTENT;
+    out.messageId = 0xBEEF;
+    out.tokenLen = 4;
+    std::memcpy(out.token, "\x01\x02\x03\x04", 4);
+    out.hasObserve = true;
+    out.observe = 0x012345;
+    std::strcpy(out.path, "status");
+    out.contentFormat = COAP_FORMAT_JSON;
+    out.hasMaxAge = true;
+    out.maxAge = 300;
+    out.payload = reinterpret_cast<const uint8_t*>(body);
+    out.payloadLen = std::strlen(body);
+
+    uint8_t buf[COAP_MAX_DATAGRAM];
+    size_t n = encodeCoap(out, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(n > 0);
+
+    CoapMessage in;
+    TEST_ASSERT_TRUE(parseCoap(buf, n, in) == CoapParseResult::Ok);
+    TEST_ASSERT_TRUE(in.type == CoapType::NonConfirmable);
+    TEST_ASSERT_EQUAL_UINT8(COAP_CONTENT, in.code);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, in.messageId);
+    TEST_ASSERT_EQUAL_MEMORY(out.token, in.token, 4);
+    TEST_ASSERT_EQUAL_UINT32(0x012345, in.observe);
+    TEST_ASSERT_EQUAL_STRING("status", in.path);
+    TEST_ASSERT_EQUAL_UINT16(COAP_FORMAT_JSON, in.contentFormat);
+    TEST_ASSERT_EQUAL_UINT32(300, in.maxAge);
+    TEST_ASSERT_EQUAL_UINT32(out.payloadLen, in.payloadLen);
+    TEST_ASSERT_EQUAL_MEMORY(body, in.payload, in.payloadLen);
+}
+
+void test_zero_valued_options_are_empty(void) {
+    // RFC 7252 §3.2: uint 0 is sent as a zero-length value
+    CoapMessage out;
+    out.hasObserve = true;
+    out.observe = 0;
+    out.contentFormat = COAP_FORMAT_TEXT;
+    uint8_t buf[16];
+    size_t n = encodeCoap(out, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(6, n);
+    TEST_ASSERT_EQUAL_HEX8(0x60, buf[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x60, buf[5]);
+}
+
+void test_encode_does_not_overflow(void) {
+    const char body[] = "0123456789";
+    CoapMessage out;
+    out.code = COAP_CONTENT;
+    out.payload = reinterpret_cast<const uint8_t*>(body);
+    out.payloadLen = 10;
+    uint8_t buf[15];
+    TEST_ASSERT_EQUAL_UINT32(15, encodeCoap(out, buf, 15));
+    TEST_ASSERT_EQUAL_UINT32(0, encodeCoap(out, buf, 14));
+    TEST_ASSERT_EQUAL_UINT32(0, encodeCoap(out, buf, 3));
+}
+
+void test_response_to_con_and_non(void) {
+    CoapMessage req;
+    req.type = CoapType::Confirmable;
+    req.messageId = 77;
+    req.tokenLen = 2;
+    req.token[0] = 0xCA;
+    req.token[1] = 0xFE;
+    CoapMessage ack = coapResponseTo(req, COAP_CONTENT, 900);
+    TEST_ASSERT_TRUE(ack.type == CoapType::Acknowledgement);
+    TEST_ASSERT_EQUAL_UINT16(77, ack.messageId);
+    TEST_ASSERT_EQUAL_UINT8(2, ack.tokenLen);
+    TEST_ASSERT_EQUAL_MEMORY(req.token, ack.token, 2);
+
+    req.type = CoapType::NonConfirmable;
+    CoapMessage non = coapResponseTo(req, COAP_CONTENT, 900);
+    TEST_ASSERT_TRUE(non.type == CoapType::NonConfirmable);
+    TEST_ASSERT_EQUAL_UINT16(900, non.messageId);
+
+    CoapMessage rst = coapReset(77);
+    uint8_t buf[8];
+    TEST_ASSERT_EQUAL_UINT32(4, encodeCoap(rst, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(0x70, buf[0]);
+}
+
+void test_http_status_mapping(void) {
+    TEST_ASSERT_EQUAL_UINT8(COAP_CHANGED, coapCodeForHttpStatus(200));
+    TEST_ASSERT_EQUAL_UINT8(COAP_BAD_REQUEST, coapCodeForHttpStatus(400));
+    TEST_ASSERT_EQUAL_UINT8(COAP_UNSUPPORTED_FORMAT, coapCodeForHttpStatus(415));
+    TEST_ASSERT_EQUAL_UINT8(COAP_SERVICE_UNAVAILABLE, coapCodeForHttpStatus(429));
+    TEST_ASSERT_EQUAL_UINT8(COAP_SERVICE_UNAVAILABLE, coapCodeForHttpStatus(503));
+    TEST_ASSERT_EQUAL_UINT8(coapCode(5, 0), coapCodeForHttpStatus(500));
+}
+
+// =============================================================================
+// Observe Registry
+// =============================================================================
+
+static const uint8_t TOKEN_A[] = {1, 2, 3};
+static const uint8_t TOKEN_B[] = {9};
+
+void test_observers_add_replace_full(void) {
+    CoapObservers<2> obs;
+    TEST_ASSERT_TRUE(obs.add(IP, 5000, TOKEN_A, 3, 0));
+    TEST_ASSERT_TRUE(obs.add(IP, 5000, TOKEN_B, 1, 0));   // Same endpoint: new token
+    TEST_ASSERT_EQUAL_UINT8(1, obs.count());
+    TEST_ASSERT_EQUAL_UINT8(1, obs.at(0).tokenLen);
+    TEST_ASSERT_EQUAL_HEX8(9, obs.at(0).token[0]);
+    TEST_ASSERT_TRUE(obs.add(IP, 5001, TOKEN_A, 3, 0));
+    TEST_ASSERT_FALSE(obs.add(IP + 1, 5000, TOKEN_A, 3, 0));
+    TEST_ASSERT_TRUE(obs.remove(IP, 5000));
+    TEST_ASSERT_FALSE(obs.remove(IP, 5000));
+    TEST_ASSERT_TRUE(obs.add(IP + 1, 5000, TOKEN_A, 3, 0));
+    TEST_ASSERT_EQUAL_UINT8(2, obs.count());
+}
+
+void test_reset_deregisters(void) {
+    CoapObservers<2> obs;
+    obs.add(IP, 5000, TOKEN_A, 3, 0);
+    obs.acknowledge(IP, 5001, 10, true);                   // Other endpoint
+    TEST_ASSERT_EQUAL_UINT8(1, obs.count());
+    obs.acknowledge(IP, 5000, 10, true);
+    TEST_ASSERT_EQUAL_UINT8(0, obs.count());
+}
+
+void test_con_probe_every_interval(void) {
+    CoapObservers<1> obs;
+    obs.add(IP, 5000, TOKEN_A, 3, 1000);
+    TEST_ASSERT_TRUE(obs.beginNotify(0, 1000 + COAP_OBSERVE_CON_INTERVAL_MS - 1, 1) ==
+                     CoapNotifyKind::NonConfirmable);
+    TEST_ASSERT_TRUE(obs.beginNotify(0, 1000 + COAP_OBSERVE_CON_INTERVAL_MS, 2) ==
+                     CoapNotifyKind::Confirmable);
+    obs.acknowledge(IP, 5000, 1, false);                   // Wrong mid — still pending
+    TEST_ASSERT_TRUE(obs.at(0).conPending);
+    obs.acknowledge(IP, 5000, 2, false);
+    TEST_ASSERT_FALSE(obs.at(0).conPending);
+    TEST_ASSERT_TRUE(obs.beginNotify(0, 1000 + 2 * COAP_OBSERVE_CON_INTERVAL_MS, 3) ==
+                     CoapNotifyKind::Confirmable);
+}
+
+void test_unacked_observer_dropped(void) {
+    CoapObservers<1> obs;
+    obs.add(IP, 5000, TOKEN_A, 3, 0);
+    obs.beginNotify(0, COAP_OBSERVE_CON_INTERVAL_MS, 1);
+    TEST_ASSERT_TRUE(obs.beginNotify(0, COAP_OBSERVE_CON_INTERVAL_MS + 5000, 2) ==
+                     CoapNotifyKind::NonConfirmable);      // Still inside the interval
+    TEST_ASSERT_TRUE(obs.beginNotify(0, 2 * COAP_OBSERVE_CON_INTERVAL_MS, 3) ==
+                     CoapNotifyKind::Dropped);
+    TEST_ASSERT_EQUAL_UINT8(0, obs.count());
+    TEST_ASSERT_EQUAL_UINT32(1, obs.dropped());
+}
+
+void test_probe_interval_across_wrap(void) {
+    CoapObservers<1> obs;
+    obs.add(IP, 5000, TOKEN_A, 3, 0xFFFFFFFFu - 1000);
+    TEST_ASSERT_TRUE(obs.beginNotify(0, 5000, 1) == CoapNotifyKind::NonConfirmable);
+    TEST_ASSERT_TRUE(obs.beginNotify(0, COAP_OBSERVE_CON_INTERVAL_MS - 1001, 2) ==
+                     CoapNotifyKind::Confirmable);
+}
+
+void test_sequence_increases_and_wraps(void) {
+    CoapObservers<1> obs;
+    uint32_t a = obs.nextSequence();
+    uint32_t b = obs.nextSequence();
+    TEST_ASSERT_TRUE(b > a);
+    uint32_t last = b;
+    for (uint32_t i = 0; i < 0x1000000; ++i) last = obs.nextSequence();
+    TEST_ASSERT_TRUE(last <= 0xFFFFFF);
+    TEST_ASSERT_EQUAL_UINT32(b, last);
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Parsing
+    RUN_TEST(test_parse_get_with_path);
+    RUN_TEST(test_parse_extended_delta_and_length);
+    RUN_TEST(test_parse_options);
+    RUN_TEST(test_unknown_options);
+    RUN_TEST(test_parse_rejects_malformed);
+    RUN_TEST(test_path_too_long);
+
+    // Encoding
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_zero_valued_options_are_empty);
+    RUN_TEST(test_encode_does_not_overflow);
+    RUN_TEST(test_response_to_con_and_non);
+    RUN_TEST(test_http_status_mapping);
+
+    // Observe registry
+    RUN_TEST(test_observers_add_replace_full);
+    RUN_TEST(test_reset_deregisters);
+    RUN_TEST(test_con_probe_every_interval);
+    RUN_TEST(test_unacked_observer_dropped);
+    RUN_TEST(test_probe_interval_across_wrap);
+    RUN_TEST(test_sequence_increases_and_wraps);
+
+    return UNITY_END();
+}
@@ -0,0 +1,254 @@
+/**
+ * Unit tests for deadline_scheduler.h — runs on the host via PlatformIO native env.
+ *
+ * Drives the scheduler with a fake millis() clock: due ordering, sleep
+ * computation, lateness accounting and wraparound.
+ */
+
+#include <unity.h>
+#include "deadline_scheduler.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+constexpr uint8_t SAFETY = 0;
+constexpr uint8_t SENSOR = 1;
+constexpr uint8_t NETWORK = 2;
+
+typedef DeadlineScheduler<3> Scheduler;
+
+// =============================================================================
+// Due Jobs
+// =============================================================================
+
+void test_nothing_armed_nothing_due(void) {
+    Scheduler s;
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(0));
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(1000000));
+}
+
+void test_job_due_at_deadline_not_before(void) {
+    Scheduler s;
+    s.arm(SENSOR, 750);
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(749));
+    TEST_ASSERT_EQUAL_INT(SENSOR, s.takeDue(750));
+}
+
+void test_taken_job_is_disarmed(void) {
+    Scheduler s;
+    s.arm(SENSOR, 10);
+    TEST_ASSERT_EQUAL_INT(SENSOR, s.takeDue(20));
+    TEST_ASSERT_FALSE(s.armed(SENSOR));
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(30));
+}
+
+void test_lowest_id_runs_first_when_several_due(void) {
+    // Network armed earlier than the safety job — safety still goes first
+    Scheduler s;
+    s.arm(NETWORK, 100);
+    s.arm(SAFETY, 200);
+    s.arm(SENSOR, 150);
+    TEST_ASSERT_EQUAL_INT(SAFETY, s.takeDue(300));
+    TEST_ASSERT_EQUAL_INT(SENSOR, s.takeDue(300));
+    TEST_ASSERT_EQUAL_INT(NETWORK, s.takeDue(300));
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(300));
+}
+
+void test_rearm_replaces_deadline(void) {
+    Scheduler s;
+    s.arm(SAFETY, 1000);
+    s.arm(SAFETY, 5000);
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(1000));
+    TEST_ASSERT_EQUAL_INT(SAFETY, s.takeDue(5000));
+}
+
+void test_disarm_cancels(void) {
+    Scheduler s;
+    s.armIn(SENSOR, 100, 50);
+    s.disarm(SENSOR);
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(1000));
+}
+
+void test_out_of_range_id_ignored(void) {
+    Scheduler s;
+    s.arm(7, 0);
+    TEST_ASSERT_FALSE(s.armed(7));
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(10));
+}
+
+// =============================================================================
+// Sleep Computation
+// =============================================================================
+
+void test_sleep_until_earliest_deadline(void) {
+    Scheduler s;
+    s.arm(SAFETY, 3600000);
+    s.arm(SENSOR, 1750);
+    s.arm(NETWORK, 1020);
+    TEST_ASSERT_EQUAL_UINT32(20, s.msUntilNext(1000, 100));
+}
+
+void test_sleep_capped(void) {
+    Scheduler s;
+    s.arm(SAFETY, 3600000);
+    TEST_ASSERT_EQUAL_UINT32(100, s.msUntilNext(0, 100));
+}
+
+void test_sleep_cap_when_idle(void) {
+    Scheduler s;
+    TEST_ASSERT_EQUAL_UINT32(100, s.msUntilNext(0, 100));
+}
+
+void test_no_sleep_when_overdue(void) {
+    Scheduler s;
+    s.arm(SENSOR, 500);
+    TEST_ASSERT_EQUAL_UINT32(0, s.msUntilNext(500, 100));
+    TEST_ASSERT_EQUAL_UINT32(0, s.msUntilNext(900, 100));
+}
+
+void test_sleep_limited_to_higher_priority_jobs(void) {
+    // The frequent network job must not mask the next safety/sensor deadline
+    Scheduler s;
+    s.arm(SENSOR, 1750);
+    s.arm(NETWORK, 1020);
+    TEST_ASSERT_EQUAL_UINT32(750, s.msUntilNext(1000, 1000, NETWORK));
+    TEST_ASSERT_EQUAL_UINT32(20, s.msUntilNext(1000, 1000));
+    s.disarm(SENSOR);
+    TEST_ASSERT_EQUAL_UINT32(1000, s.msUntilNext(1000, 1000, NETWORK));
+}
+
+void test_deadline_across_millis_wrap(void) {
+    // millis() wraps after ~49.7 days — a deadline past the wrap is still future
+    Scheduler s;
+    uint32_t now = 0xFFFFFFF0u;
+    s.armIn(SENSOR, now, 0x20);
+    TEST_ASSERT_EQUAL_UINT32(0x20, s.msUntilNext(now, 100));
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(now));
+    TEST_ASSERT_EQUAL_INT(Scheduler::NONE, s.takeDue(0x0000000Fu));
+    TEST_ASSERT_EQUAL_INT(SENSOR, s.takeDue(0x00000010u));
+}
+
+// =============================================================================
+// Simulated Loop
+// =============================================================================
+
+void test_fake_clock_loop_never_oversleeps(void) {
+    // Sensor every 2000 ms (read 750 ms after request), network every 20 ms.
+    // Sleeping exactly as told, no job may ever run late.
+    Scheduler s;
+    uint32_t now = 0;
+    s.arm(SENSOR, 0);
+    s.arm(NETWORK, 0);
+    uint32_t sensorRuns = 0;
+    while (now < 60000) {
+        for (int job = s.takeDue(now); job != Scheduler::NONE; job = s.takeDue(now)) {
+            if (job == SENSOR) {
+                ++sensorRuns;
+                s.arm(SENSOR, s.deadline(SENSOR) + 2000);
+            } else if (job == NETWORK) {
+                s.armIn(NETWORK, now, 20);
+            }
+        }
+        uint32_t sleep = s.msUntilNext(now, 100);
+        TEST_ASSERT_TRUE(sleep > 0);
+        s.recordSleep(sleep, sleep);
+        now += sleep;
+    }
+    TEST_ASSERT_EQUAL_UINT32(30, sensorRuns);
+    TEST_ASSERT_EQUAL_UINT32(0, s.stats(SENSOR).maxLatenessMs);
+    TEST_ASSERT_EQUAL_UINT32(0, s.stats(NETWORK).maxLatenessMs);
+    TEST_ASSERT_EQUAL_UINT32(60000, s.wakeStats().sleptMs);
+    TEST_ASSERT_EQUAL_UINT32(0, s.wakeStats().lateWakes);
+}
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+void test_lateness_recorded(void) {
+    Scheduler s;
+    s.arm(SENSOR, 100);
+    s.takeDue(130);
+    s.arm(SENSOR, 200);
+    s.takeDue(205);
+    TEST_ASSERT_EQUAL_UINT32(2, s.stats(SENSOR).runs);
+    TEST_ASSERT_EQUAL_UINT32(5, s.stats(SENSOR).lastLatenessMs);
+    TEST_ASSERT_EQUAL_UINT32(30, s.stats(SENSOR).maxLatenessMs);
+}
+
+void test_overrun_counted_against_budget(void) {
+    Scheduler s;
+    s.setBudget(SAFETY, 100);
+    s.arm(SAFETY, 0);
+    s.takeDue(100);   // Exactly on budget — not an overrun
+    TEST_ASSERT_FALSE(s.lastRunOverran(SAFETY));
+    s.arm(SAFETY, 1000);
+    s.takeDue(1101);
+    TEST_ASSERT_TRUE(s.lastRunOverran(SAFETY));
+    TEST_ASSERT_EQUAL_UINT32(1, s.stats(SAFETY).overruns);
+}
+
+void test_best_effort_job_never_overruns(void) {
+    Scheduler s;
+    s.arm(NETWORK, 0);
+    s.takeDue(60000);
+    TEST_ASSERT_FALSE(s.lastRunOverran(NETWORK));
+    TEST_ASSERT_EQUAL_UINT32(0, s.stats(NETWORK).overruns);
+}
+
+void test_reset_maxima_keeps_counters(void) {
+    Scheduler s;
+    s.arm(SENSOR, 0);
+    s.takeDue(50);
+    s.resetMaxima();
+    TEST_ASSERT_EQUAL_UINT32(0, s.stats(SENSOR).maxLatenessMs);
+    TEST_ASSERT_EQUAL_UINT32(1, s.stats(SENSOR).runs);
+}
+
+void test_wake_stats_classify_sleeps(void) {
+    Scheduler s;
+    s.recordSleep(20, 20);
+    s.recordSleep(20, 12);
+    s.recordSleep(20, 23);
+    TEST_ASSERT_EQUAL_UINT32(3, s.wakeStats().sleeps);
+    TEST_ASSERT_EQUAL_UINT32(55, s.wakeStats().sleptMs);
+    TEST_ASSERT_EQUAL_UINT32(1, s.wakeStats().earlyWakes);
+    TEST_ASSERT_EQUAL_UINT32(1, s.wakeStats().lateWakes);
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Due jobs
+    RUN_TEST(test_nothing_armed_nothing_due);
+    RUN_TEST(test_job_due_at_deadline_not_before);
+    RUN_TEST(test_taken_job_is_disarmed);
+    RUN_TEST(test_lowest_id_runs_first_when_several_due);
+    RUN_TEST(test_rearm_replaces_deadline);
+    RUN_TEST(test_disarm_cancels);
+    RUN_TEST(test_out_of_range_id_ignored);
+
+    // Sleep computation
+    RUN_TEST(test_sleep_until_earliest_deadline);
+    RUN_TEST(test_sleep_capped);
+    RUN_TEST(test_sleep_cap_when_idle);
+    RUN_TEST(test_no_sleep_when_overdue);
+    RUN_TEST(test_sleep_limited_to_higher_priority_jobs);
+    RUN_TEST(test_deadline_across_millis_wrap);
+
+    // Simulated loop
+    RUN_TEST(test_fake_clock_loop_never_oversleeps);
+
+    // Statistics
+    RUN_TEST(test_lateness_recorded);
+    RUN_TEST(test_overrun_counted_against_budget);
+    RUN_TEST(test_best_effort_job_never_overruns);
+    RUN_TEST(test_reset_maxima_keeps_counters);
+    RUN_TEST(test_wake_stats_classify_sleeps);
+
+    return UNITY_END();
+}
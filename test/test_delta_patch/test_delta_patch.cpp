@@ -0,0 +1,337 @@
+/**
+ * Unit tests for delta_patch.h and sha256.h — runs on the host via
+ * PlatformIO native env.
+ *
+ * OTA partitions are stood in for by temporary files: the source is read
+ * with random access, the target is written sequentially, exactly as the
+ * ESP32 partition API is used.
+ */
+
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "delta_patch.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+// =============================================================================
+// File-backed partitions
+// =============================================================================
+
+struct FileSource : DeltaSource {
+    std::FILE* f;
+    uint32_t bytes;
+    explicit FileSource(const Bytes& image) : f(std::tmpfile()), bytes(static_cast<uint32_t>(image.size())) {
+        std::fwrite(image.data(), 1, image.size(), f);
+        std::fflush(f);
+    }
+    ~FileSource() { std::fclose(f); }
+    uint32_t size() const override { return bytes; }
+    bool read(uint32_t offset, uint8_t* buf, size_t len) override {
+        return std::fseek(f, static_cast<long>(offset), SEEK_SET) == 0 &&
+               std::fread(buf, 1, len, f) == len;
+    }
+};
+
+struct FileSink : DeltaSink {
+    std::FILE* f;
+    size_t maxWrite = 0;
+    FileSink() : f(std::tmpfile()) {}
+    ~FileSink() { std::fclose(f); }
+    bool write(const uint8_t* buf, size_t len) override {
+        if (len > maxWrite) maxWrite = len;
+        return std::fwrite(buf, 1, len, f) == len;
+    }
+    Bytes contents() {
+        std::fflush(f);
+        long n = std::ftell(f);
+        Bytes out(static_cast<size_t>(n));
+        std::rewind(f);
+        if (n > 0 && std::fread(out.data(), 1, out.size(), f) != out.size()) out.clear();
+        return out;
+    }
+};
+
+// =============================================================================
+// Patch construction helpers
+// =============================================================================
+
+Bytes digestOf(const Bytes& data) {
+    Sha256 ctx;
+    sha256Init(ctx);
+    sha256Update(ctx, data.data(), data.size());
+    Bytes out(SHA256_DIGEST_SIZE);
+    sha256Final(ctx, out.data());
+    return out;
+}
+
+void putLe32(Bytes& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void putVarint(Bytes& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+Bytes header(const Bytes& source, const Bytes& target) {
+    Bytes out(DELTA_MAGIC, DELTA_MAGIC + 4);
+    putLe32(out, static_cast<uint32_t>(source.size()));
+    putLe32(out, static_cast<uint32_t>(target.size()));
+    Bytes hs = digestOf(source), ht = digestOf(target);
+    out.insert(out.end(), hs.begin(), hs.end());
+    out.insert(out.end(), ht.begin(), ht.end());
+    return out;
+}
+
+void opCopy(Bytes& patch, uint32_t offset, uint32_t length) {
+    patch.push_back(DELTA_OP_COPY);
+    putVarint(patch, offset);
+    putVarint(patch, length);
+}
+
+void opInsert(Bytes& patch, const Bytes& data) {
+    patch.push_back(DELTA_OP_INSERT);
+    putVarint(patch, static_cast<uint32_t>(data.size()));
+    patch.insert(patch.end(), data.begin(), data.end());
+}
+
+Bytes pattern(size_t n, uint8_t seed) {
+    Bytes out(n);
+    uint32_t x = seed * 2654435761u + 1;
+    for (size_t i = 0; i < n; ++i) {
+        x = x * 1103515245u + 12345u;
+        out[i] = static_cast<uint8_t>(x >> 16);
+    }
+    return out;
+}
+
+/** source = A B C, target = A X C' where C' = C with its tail moved up front. */
+struct Scenario {
+    Bytes source, target, patch;
+    Scenario() {
+        Bytes a = pattern(1000, 1), b = pattern(300, 2), c = pattern(2000, 3), x = pattern(77, 4);
+        source = a; source.insert(source.end(), b.begin(), b.end()); source.insert(source.end(), c.begin(), c.end());
+        target = a; target.insert(target.end(), x.begin(), x.end());
+        target.insert(target.end(), c.begin() + 1500, c.end());
+        target.insert(target.end(), c.begin(), c.begin() + 1500);
+
+        patch = header(source, target);
+        opCopy(patch, 0, 1000);
+        opInsert(patch, x);
+        opCopy(patch, 1300 + 1500, 500);
+        opCopy(patch, 1300, 1500);
+        patch.push_back(DELTA_OP_END);
+    }
+};
+
+DeltaResult applyInChunks(const Bytes& source, const Bytes& patch, size_t chunk, FileSink& sink) {
+    FileSource src(source);
+    DeltaPatchApplier applier(src, sink);
+    DeltaResult r = DeltaResult::NeedMore;
+    for (size_t i = 0; i < patch.size() && r == DeltaResult::NeedMore; i += chunk) {
+        size_t n = patch.size() - i < chunk ? patch.size() - i : chunk;
+        r = applier.feed(patch.data() + i, n);
+    }
+    return applier.finish();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// =============================================================================
+// SHA-256
+// =============================================================================
+
+void test_sha256_empty(void) {
+    Bytes d = digestOf(Bytes());
+    const uint8_t expected[] = {
+        0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+        0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55};
+    TEST_ASSERT_EQUAL_MEMORY(expected, d.data(), 32);
+}
+
+void test_sha256_abc(void) {
+    const char* msg = "abc";
+    Bytes d = digestOf(Bytes(msg, msg + 3));
+    const uint8_t expected[] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad};
+    TEST_ASSERT_EQUAL_MEMORY(expected, d.data(), 32);
+}
+
+void test_sha256_two_blocks_incremental(void) {
+    // 56-byte NIST vector fed one byte at a time — exercises padding into a second block
+    const char* msg = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    Sha256 ctx;
+    sha256Init(ctx);
+    for (size_t i = 0; i < std::strlen(msg); ++i) {
+        sha256Update(ctx, reinterpret_cast<const uint8_t*>(msg + i), 1);
+    }
+    uint8_t d[32];
+    sha256Final(ctx, d);
+    const uint8_t expected[] = {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1};
+    TEST_ASSERT_EQUAL_MEMORY(expected, d, 32);
+}
+
+// =============================================================================
+// Applying Patches
+// =============================================================================
+
+void test_apply_rebuilds_target(void) {
+    Scenario s;
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, s.patch, 4096, sink) == DeltaResult::Done);
+    Bytes out = sink.contents();
+    TEST_ASSERT_EQUAL_size_t(s.target.size(), out.size());
+    TEST_ASSERT_EQUAL_MEMORY(s.target.data(), out.data(), out.size());
+}
+
+void test_apply_byte_at_a_time(void) {
+    // HTTP chunk boundaries can split headers, varints and insert data anywhere
+    Scenario s;
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, s.patch, 1, sink) == DeltaResult::Done);
+    Bytes out = sink.contents();
+    TEST_ASSERT_EQUAL_MEMORY(s.target.data(), out.data(), s.target.size());
+}
+
+void test_apply_bounded_write_size(void) {
+    // A 1500-byte COPY must be streamed through the fixed buffer, not staged
+    Scenario s;
+    FileSink sink;
+    applyInChunks(s.source, s.patch, 4096, sink);
+    TEST_ASSERT_LESS_OR_EQUAL(4096, sink.maxWrite);
+    FileSink small;
+    applyInChunks(s.source, s.patch, 64, small);
+    TEST_ASSERT_LESS_OR_EQUAL(DELTA_COPY_CHUNK, small.maxWrite);
+}
+
+void test_apply_rejects_wrong_base(void) {
+    // Nothing may be written when the running image is not the patch's base
+    Scenario s;
+    Bytes otherBase = s.source;
+    otherBase[10] ^= 0xFF;
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(otherBase, s.patch, 4096, sink) == DeltaResult::SourceMismatch);
+    TEST_ASSERT_EQUAL_size_t(0, sink.contents().size());
+}
+
+void test_apply_rejects_bad_magic(void) {
+    Scenario s;
+    s.patch[0] = 'X';
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, s.patch, 4096, sink) == DeltaResult::BadHeader);
+}
+
+void test_apply_detects_corrupted_insert(void) {
+    Scenario s;
+    s.patch[DELTA_HEADER_SIZE + 8] ^= 0x01;  // inside the INSERT payload
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, s.patch, 4096, sink) == DeltaResult::HashMismatch);
+}
+
+void test_apply_detects_truncation(void) {
+    Scenario s;
+    s.patch.resize(s.patch.size() - 10);
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, s.patch, 4096, sink) == DeltaResult::Truncated);
+}
+
+void test_apply_rejects_copy_out_of_source(void) {
+    Scenario s;
+    Bytes patch = header(s.source, s.target);
+    opCopy(patch, static_cast<uint32_t>(s.source.size()) - 10, 20);
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, patch, 4096, sink) == DeltaResult::OutOfBounds);
+}
+
+void test_apply_rejects_output_past_target_size(void) {
+    Bytes source = pattern(100, 9), target = pattern(10, 8);
+    Bytes patch = header(source, target);
+    opCopy(patch, 0, 50);
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(source, patch, 4096, sink) == DeltaResult::OutOfBounds);
+}
+
+void test_apply_rejects_short_output(void) {
+    Bytes source = pattern(100, 9), target = pattern(10, 8);
+    Bytes patch = header(source, target);
+    opInsert(patch, Bytes(target.begin(), target.begin() + 5));
+    patch.push_back(DELTA_OP_END);
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(source, patch, 4096, sink) == DeltaResult::SizeMismatch);
+}
+
+void test_apply_rejects_unknown_op(void) {
+    Scenario s;
+    Bytes patch = header(s.source, s.target);
+    patch.push_back(0x7F);
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, patch, 4096, sink) == DeltaResult::BadOp);
+}
+
+void test_apply_rejects_oversized_varint(void) {
+    Scenario s;
+    Bytes patch = header(s.source, s.target);
+    patch.push_back(DELTA_OP_INSERT);
+    for (int i = 0; i < 6; ++i) patch.push_back(0xFF);
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, patch, 4096, sink) == DeltaResult::BadOp);
+}
+
+void test_apply_rejects_trailing_bytes(void) {
+    Scenario s;
+    s.patch.push_back(0x00);
+    FileSink sink;
+    TEST_ASSERT_TRUE(applyInChunks(s.source, s.patch, 4096, sink) == DeltaResult::BadOp);
+}
+
+void test_apply_reset_allows_retry(void) {
+    Scenario s;
+    FileSource src(s.source);
+    FileSink sink;
+    DeltaPatchApplier applier(src, sink);
+    applier.feed(s.patch.data(), 20);
+    applier.reset();
+    applier.feed(s.patch.data(), s.patch.size());
+    TEST_ASSERT_TRUE(applier.finish() == DeltaResult::Done);
+    TEST_ASSERT_EQUAL_UINT32(s.target.size(), applier.written());
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // SHA-256
+    RUN_TEST(test_sha256_empty);
+    RUN_TEST(test_sha256_abc);
+    RUN_TEST(test_sha256_two_blocks_incremental);
+
+    // Applying patches
+    RUN_TEST(test_apply_rebuilds_target);
+    RUN_TEST(test_apply_byte_at_a_time);
+    RUN_TEST(test_apply_bounded_write_size);
+    RUN_TEST(test_apply_rejects_wrong_base);
+    RUN_TEST(test_apply_rejects_bad_magic);
+    RUN_TEST(test_apply_detects_corrupted_insert);
+    RUN_TEST(test_apply_detects_truncation);
+    RUN_TEST(test_apply_rejects_copy_out_of_source);
+    RUN_TEST(test_apply_rejects_output_past_target_size);
+    RUN_TEST(test_apply_rejects_short_output);
+    RUN_TEST(test_apply_rejects_unknown_op);
+    RUN_TEST(test_apply_rejects_oversized_varint);
+    RUN_TEST(test_apply_rejects_trailing_bytes);
+    RUN_TEST(test_apply_reset_allows_retry);
+
+    return UNITY_END();
+}
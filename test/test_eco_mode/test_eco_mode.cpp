@@ -0,0 +1,349 @@
+/**
+ * Unit tests for eco_mode.h — runs on the host via PlatformIO native env.
+ *
+ * The heat-up model is validated against simulated traces: thermal_plant.h
+ * stands in for the room, the probe is read every 2 s at DS18B20
+ * resolution and the relay follows shouldHeaterEngage(), as on the device.
+ * Also covers the plan's start time, command parsing and validation.
+ */
+
+#include <unity.h>
+#include "eco_mode.h"
+#include "thermal_plant.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+constexpr uint32_t MIN_MS = 60000;
+constexpr uint32_t READ_MS = 2000;
+
+/** The firmware's view of a simulated sauna: 2 s readings, 1/16 °C probe. */
+struct Sim {
+    ThermalPlantParams params;
+    ThermalPlantState state;
+    uint32_t nowMs = 0;
+    bool relay = false;
+    uint64_t onMs = 0;
+
+    float read() const { return std::floor(state.sensorC * 16.0f + 0.5f) / 16.0f; }
+
+    /** One read interval with the relay as set; returns the new reading. */
+    float step() {
+        thermalPlantStep(state, params, READ_MS / 1000.0f, relay);
+        if (relay) onMs += READ_MS;
+        nowMs += READ_MS;
+        return read();
+    }
+
+    /** Thermostat control towards targetC for ms, feeding the tracker if given. */
+    void control(float targetC, uint32_t ms, HeatupTracker* tracker = nullptr,
+                 HeatupModel* model = nullptr) {
+        for (uint32_t t = 0; t < ms; t += READ_MS) {
+            bool was = relay;
+            float c = step();
+            if (tracker) tracker->observe(nowMs, c, was, *model);
+            relay = shouldHeaterEngage(c, targetC, relay);
+        }
+        relay = false;
+    }
+
+    /** Sensor time to reach targetC at full power (ECO_UNREACHABLE if not within 3 h). */
+    uint32_t measureHeatupMs(float targetC) const {
+        Sim copy = *this;
+        copy.relay = true;
+        for (uint32_t t = 0; t < 180 * MIN_MS; t += READ_MS) {
+            if (copy.read() >= targetC) return t;
+            copy.step();
+        }
+        return ECO_UNREACHABLE;
+    }
+};
+
+/** Learns from `sessions` 60-minute sessions at 80 °C, each starting from ambient. */
+static HeatupModel learn(const ThermalPlantParams& params, int sessions) {
+    HeatupModel model;
+    HeatupTracker tracker;
+    for (int i = 0; i < sessions; ++i) {
+        Sim sim;
+        sim.params = params;
+        sim.state.airC = sim.state.sensorC = params.ambientC;
+        sim.nowMs = static_cast<uint32_t>(i) * 1000u * MIN_MS;
+        sim.control(80.0f, 60 * MIN_MS, &tracker, &model);
+    }
+    return model;
+}
+
+static float relativeError(uint32_t predicted, uint32_t actual) {
+    return std::fabs(static_cast<float>(predicted) - actual) / actual;
+}
+
+// =============================================================================
+// Heat-up Model
+// =============================================================================
+
+void test_defaults_until_fitted(void) {
+    HeatupModel m;
+    TEST_ASSERT_FALSE(m.fitted());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, ECO_DEFAULT_RATE_C_PER_MIN, m.rateAt(ECO_FIT_CENTER_C));
+    // A handful of windows at one temperature cannot separate heating from loss
+    for (int i = 0; i < 20; ++i) m.addWindow(60.0f, 1.0f);
+    TEST_ASSERT_FALSE(m.fitted());
+}
+
+void test_fit_recovers_linear_rate(void) {
+    HeatupModel m;
+    for (int i = 0; i < 40; ++i) {
+        float c = 30.0f + i * 1.5f;
+        m.addWindow(c, 1.5f - 0.02f * (c - ECO_FIT_CENTER_C));
+    }
+    TEST_ASSERT_TRUE(m.fitted());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.5f, m.rateAt(60.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.1f, m.rateAt(80.0f));
+}
+
+void test_heatup_time_closed_form(void) {
+    HeatupModel m;   // Defaults: rate 1.2 °C/min at 60, loss 0.0175/min
+    float expected = std::log(m.rateAt(20.0f) / m.rateAt(80.0f)) / ECO_DEFAULT_LOSS_PER_MIN;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, expected, m.heatupMs(20.0f, 80.0f) / 60000.0f);
+    TEST_ASSERT_EQUAL_UINT32(0, m.heatupMs(85.0f, 80.0f));
+    TEST_ASSERT_EQUAL_UINT32(ECO_UNREACHABLE, m.heatupMs(20.0f, 140.0f));   // Above the ceiling
+}
+
+void test_defaults_match_default_plant(void) {
+    // Cold-start predictions must be usable before anything is learned
+    Sim sim;
+    uint32_t actual = sim.measureHeatupMs(80.0f);
+    HeatupModel m;
+    TEST_ASSERT_TRUE(relativeError(m.heatupMs(sim.read(), 80.0f), actual) < 0.10f);
+}
+
+void test_learns_a_different_sauna(void) {
+    // Smaller heater in a cold outbuilding: the defaults are far off
+    ThermalPlantParams p;
+    p.heaterPowerW = 5000.0f;
+    p.lossWPerC = 45.0f;
+    p.heatCapacityJPerC = 200000.0f;
+    p.ambientC = 5.0f;
+    HeatupModel model = learn(p, 2);
+    TEST_ASSERT_TRUE(model.fitted());
+
+    Sim sim;
+    sim.params = p;
+    sim.state.airC = sim.state.sensorC = 5.0f;
+    uint32_t actual = sim.measureHeatupMs(80.0f);
+    HeatupModel defaults;
+    TEST_ASSERT_TRUE(relativeError(defaults.heatupMs(5.0f, 80.0f), actual) > 0.15f);
+    TEST_ASSERT_TRUE(relativeError(model.heatupMs(5.0f, 80.0f), actual) < 0.05f);
+
+    // ...and from a part-warm room
+    sim.state.airC = sim.state.sensorC = 50.0f;
+    actual = sim.measureHeatupMs(85.0f);
+    TEST_ASSERT_TRUE(relativeError(model.heatupMs(50.0f, 85.0f), actual) < 0.05f);
+}
+
+void test_model_follows_change(void) {
+    // Learned in summer, then winter arrives: forgetting moves the fit over
+    ThermalPlantParams summer;
+    summer.ambientC = 25.0f;
+    ThermalPlantParams winter;
+    winter.ambientC = 0.0f;
+    HeatupModel model = learn(summer, 2);
+    HeatupTracker tracker;
+    for (int i = 0; i < 3; ++i) {
+        Sim sim;
+        sim.params = winter;
+        sim.state.airC = sim.state.sensorC = 0.0f;
+        sim.nowMs = static_cast<uint32_t>(i) * 1000u * MIN_MS;
+        sim.control(80.0f, 60 * MIN_MS, &tracker, &model);
+    }
+    Sim cold;
+    cold.params = winter;
+    cold.state.airC = cold.state.sensorC = 0.0f;
+    TEST_ASSERT_TRUE(relativeError(model.heatupMs(0.0f, 80.0f), cold.measureHeatupMs(80.0f)) < 0.05f);
+}
+
+void test_tracker_skips_probe_lag_and_cycling(void) {
+    HeatupModel model;
+    HeatupTracker tracker;
+    uint32_t t = 0;
+    // Relay closed 2 min 58 s: still settling plus less than a window
+    for (; t < ECO_FIT_SETTLE_MS + ECO_FIT_WINDOW_MS - READ_MS; t += READ_MS) {
+        TEST_ASSERT_FALSE(tracker.observe(t, 30.0f + t / 60000.0f, true, model));
+    }
+    tracker.observe(t, 30.0f, false, model);   // Opened — the window is lost
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, model.fit().w);
+    t += READ_MS;
+    for (uint32_t i = 0; i <= ECO_FIT_SETTLE_MS + ECO_FIT_WINDOW_MS; i += READ_MS, t += READ_MS) {
+        tracker.observe(t, 30.0f, true, model);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, model.fit().w);
+}
+
+void test_tracker_breaks_window_on_gap(void) {
+    HeatupModel model;
+    HeatupTracker tracker;
+    uint32_t t = 0;
+    for (; t <= ECO_FIT_SETTLE_MS; t += READ_MS) tracker.observe(t, 40.0f, true, model);
+    t += ECO_FIT_WINDOW_MS;   // Readings missing (sensor fault) for a whole window
+    TEST_ASSERT_FALSE(tracker.observe(t, 55.0f, true, model));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, model.fit().w);
+}
+
+void test_restore_rejects_garbage(void) {
+    HeatupModel learned = learn(ThermalPlantParams(), 1);
+    HeatupModel m;
+    TEST_ASSERT_TRUE(m.restore(learned.fit()));
+    TEST_ASSERT_TRUE(m.fitted());
+    TEST_ASSERT_EQUAL_UINT32(learned.heatupMs(20.0f, 80.0f), m.heatupMs(20.0f, 80.0f));
+
+    HeatupFit bad = learned.fit();
+    bad.sxy = NAN;
+    HeatupModel n;
+    TEST_ASSERT_FALSE(n.restore(bad));
+    TEST_ASSERT_FALSE(n.fitted());
+    bad = learned.fit();
+    bad.w = 1e9f;
+    TEST_ASSERT_FALSE(n.restore(bad));
+}
+
+// =============================================================================
+// Plan
+// =============================================================================
+
+void test_start_time_includes_margin(void) {
+    HeatupModel m;
+    EcoPlan plan;
+    plan.schedule(1000, 180 * MIN_MS, 80.0f);
+    uint32_t lead = ecoLeadMs(m, 20.0f, 80.0f);
+    TEST_ASSERT_EQUAL_UINT32(
+        static_cast<uint32_t>(m.heatupMs(20.0f, 80.0f) * (1.0f + ECO_LEAD_MARGIN) + ECO_LEAD_MARGIN_MS), lead);
+    TEST_ASSERT_EQUAL_UINT32(180 * MIN_MS - lead, plan.startInMs(1000, 20.0f, m));
+    TEST_ASSERT_FALSE(plan.due(1000, 20.0f, m));
+    TEST_ASSERT_TRUE(plan.due(1000 + 180 * MIN_MS - lead, 20.0f, m));
+}
+
+void test_warm_room_starts_later(void) {
+    HeatupModel m;
+    EcoPlan plan;
+    plan.schedule(0, 120 * MIN_MS, 80.0f);
+    TEST_ASSERT_TRUE(plan.startInMs(0, 60.0f, m) > plan.startInMs(0, 20.0f, m));
+    TEST_ASSERT_EQUAL_UINT32(120 * MIN_MS - ECO_LEAD_MARGIN_MS, plan.startInMs(0, 85.0f, m));
+}
+
+void test_late_plan_starts_now(void) {
+    HeatupModel m;
+    EcoPlan plan;
+    plan.schedule(0, 10 * MIN_MS, 90.0f);
+    TEST_ASSERT_TRUE(plan.due(0, 20.0f, m));
+    plan.schedule(0xFFFFFFFFu - 1000, 5 * MIN_MS, 80.0f);   // Across the millis() wrap
+    TEST_ASSERT_EQUAL_UINT32(5 * MIN_MS - 2001, plan.readyInMs(1000));
+    plan.cancel();
+    TEST_ASSERT_FALSE(plan.due(1000, 20.0f, m));
+}
+
+void test_ready_on_time_with_less_energy(void) {
+    // Arrival in 3 h. "Heat now" holds at 80 °C for over two hours; eco waits,
+    // starts from the model and must still be at temperature on arrival.
+    const uint32_t readyIn = 180 * MIN_MS;
+    HeatupModel model = learn(ThermalPlantParams(), 1);
+
+    Sim eager;
+    eager.control(80.0f, readyIn);
+
+    Sim eco;
+    EcoPlan plan;
+    plan.schedule(eco.nowMs, readyIn, 80.0f);
+    while (!plan.due(eco.nowMs, eco.read(), model)) eco.step();
+    uint32_t startedMs = eco.nowMs;
+    eco.control(80.0f, readyIn - startedMs);
+
+    TEST_ASSERT_TRUE(readyIn - startedMs <= SESSION_MAX_MS);   // Fits one session
+    TEST_ASSERT_TRUE(eco.read() >= 80.0f - TEMP_HYSTERESIS);
+    TEST_ASSERT_TRUE(eco.onMs < eager.onMs * 6 / 10);
+}
+
+void test_ready_on_time_from_cooling_room(void) {
+    // Room still at 70 °C from an earlier session and cooling while the plan waits
+    const uint32_t readyIn = 120 * MIN_MS;
+    HeatupModel model = learn(ThermalPlantParams(), 1);
+    Sim sim;
+    sim.state.airC = sim.state.sensorC = 70.0f;
+    EcoPlan plan;
+    plan.schedule(0, readyIn, 85.0f);
+    while (!plan.due(sim.nowMs, sim.read(), model)) sim.step();
+    TEST_ASSERT_TRUE(sim.read() < 70.0f);
+    sim.control(85.0f, readyIn - sim.nowMs);
+    TEST_ASSERT_TRUE(sim.read() >= 85.0f - TEMP_HYSTERESIS);
+}
+
+// =============================================================================
+// Command
+// =============================================================================
+
+void test_parse_command(void) {
+    EcoCommand cmd;
+    TEST_ASSERT_TRUE(parseEcoCommand("{\"temperature\":85.5,\"ready_in_min\":90}", cmd) == EcoResult::Ok);
+    TEST_ASSERT_EQUAL_FLOAT(85.5f, cmd.temperature);
+    TEST_ASSERT_EQUAL_INT(90, cmd.readyInMin);
+    TEST_ASSERT_TRUE(parseEcoCommand("{\"temperature\":85}", cmd) == EcoResult::MissingFields);
+    TEST_ASSERT_TRUE(parseEcoCommand("{\"ready_in_min\":5}", cmd) == EcoResult::MissingFields);
+    TEST_ASSERT_TRUE(parseEcoCommand("{\"temperature\":\"hot\",\"ready_in_min\":5}", cmd) ==
+                     EcoResult::InvalidTemperature);
+    TEST_ASSERT_TRUE(parseEcoCommand("{\"temperature\":80,\"ready_in_min\":1.5}", cmd) ==
+                     EcoResult::InvalidReadyIn);
+}
+
+void test_validate_command(void) {
+    HeatupModel m;
+    EcoCommand cmd;
+    cmd.temperature = 80.0f;
+    cmd.readyInMin = 90;
+    TEST_ASSERT_TRUE(validateEcoStart(cmd, m, 20.0f, false, false) == EcoResult::Ok);
+    TEST_ASSERT_TRUE(validateEcoStart(cmd, m, 20.0f, true, false) == EcoResult::SessionActive);
+    TEST_ASSERT_TRUE(validateEcoStart(cmd, m, 20.0f, false, true) == EcoResult::SensorFault);
+    cmd.readyInMin = 0;
+    TEST_ASSERT_TRUE(validateEcoStart(cmd, m, 20.0f, false, false) == EcoResult::InvalidReadyIn);
+    cmd.readyInMin = ECO_MAX_READY_IN_MIN + 1;
+    TEST_ASSERT_TRUE(validateEcoStart(cmd, m, 20.0f, false, false) == EcoResult::InvalidReadyIn);
+    cmd.readyInMin = 90;
+    cmd.temperature = 101.0f;
+    TEST_ASSERT_TRUE(validateEcoStart(cmd, m, 20.0f, false, false) == EcoResult::TemperatureOutOfRange);
+    // The default 7 kW room needs well over an hour from 20 °C to 100 °C
+    cmd.temperature = 100.0f;
+    TEST_ASSERT_TRUE(validateEcoStart(cmd, m, 20.0f, false, false) == EcoResult::Unreachable);
+    TEST_ASSERT_TRUE(validateEcoStart(cmd, m, 60.0f, false, false) == EcoResult::Ok);
+    TEST_ASSERT_EQUAL_INT(409, ecoHttpStatus(EcoResult::SessionActive));
+    TEST_ASSERT_EQUAL_INT(400, ecoHttpStatus(EcoResult::Unreachable));
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Heat-up model
+    RUN_TEST(test_defaults_until_fitted);
+    RUN_TEST(test_fit_recovers_linear_rate);
+    RUN_TEST(test_heatup_time_closed_form);
+    RUN_TEST(test_defaults_match_default_plant);
+    RUN_TEST(test_learns_a_different_sauna);
+    RUN_TEST(test_model_follows_change);
+    RUN_TEST(test_tracker_skips_probe_lag_and_cycling);
+    RUN_TEST(test_tracker_breaks_window_on_gap);
+    RUN_TEST(test_restore_rejects_garbage);
+
+    // Plan
+    RUN_TEST(test_start_time_includes_margin);
+    RUN_TEST(test_warm_room_starts_later);
+    RUN_TEST(test_late_plan_starts_now);
+    RUN_TEST(test_ready_on_time_with_less_energy);
+    RUN_TEST(test_ready_on_time_from_cooling_room);
+
+    // Command
+    RUN_TEST(test_parse_command);
+    RUN_TEST(test_validate_command);
+
+    return UNITY_END();
+}
@@ -0,0 +1,90 @@
+/**
+ * Unit tests for energy_meter.h — runs on the host via PlatformIO native env.
+ *
+ * Covers on-time integration across relay changes and millis() wrap, the
+ * kWh conversion, restoring a persisted total and when a save is due.
+ */
+
+#include <unity.h>
+#include "energy_meter.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+constexpr uint32_t MIN_MS = 60000;
+
+void test_counts_only_on_time(void) {
+    EnergyMeter m;
+    m.update(0, true);
+    m.update(10 * MIN_MS, false);
+    m.update(25 * MIN_MS, true);
+    TEST_ASSERT_EQUAL_UINT32(15 * MIN_MS, static_cast<uint32_t>(m.lifetimeOnMs(30 * MIN_MS)));
+    m.update(30 * MIN_MS, false);
+    TEST_ASSERT_EQUAL_UINT32(15 * MIN_MS, static_cast<uint32_t>(m.lifetimeOnMs(90 * MIN_MS)));
+}
+
+void test_repeated_state_is_harmless(void) {
+    EnergyMeter m;
+    m.update(1000, true);
+    m.update(2000, true);
+    m.update(3000, true);
+    m.update(4000, false);
+    m.update(5000, false);
+    TEST_ASSERT_EQUAL_UINT32(3000, static_cast<uint32_t>(m.lifetimeOnMs(6000)));
+}
+
+void test_kwh_conversion(void) {
+    // 7 kW for one hour
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 7.0f, static_cast<float>(energyKWh(60 * MIN_MS, 7000.0f)));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, static_cast<float>(energyKWh(0, 7000.0f)));
+}
+
+void test_across_millis_wrap(void) {
+    EnergyMeter m;
+    m.update(0xFFFFFFFFu - 999, true);
+    m.update(1000, false);
+    TEST_ASSERT_EQUAL_UINT32(2000, static_cast<uint32_t>(m.lifetimeOnMs(5000)));
+}
+
+void test_lifetime_beyond_32_bits(void) {
+    // ~1,200 heating hours — more than a uint32_t of milliseconds
+    EnergyMeter m;
+    const uint64_t persisted = 4300000000ULL;
+    m.restore(persisted);
+    m.update(0, true);
+    m.update(MIN_MS, false);
+    TEST_ASSERT_TRUE(m.lifetimeOnMs(MIN_MS) == persisted + MIN_MS);
+}
+
+void test_save_due_after_unsaved_on_time(void) {
+    EnergyMeter m;
+    m.restore(123456);
+    m.update(0, true);
+    TEST_ASSERT_FALSE(m.saveDue(ENERGY_SAVE_ON_MS - 1));
+    TEST_ASSERT_TRUE(m.saveDue(ENERGY_SAVE_ON_MS));
+    TEST_ASSERT_TRUE(m.save(ENERGY_SAVE_ON_MS) == 123456ULL + ENERGY_SAVE_ON_MS);
+    TEST_ASSERT_FALSE(m.saveDue(ENERGY_SAVE_ON_MS + 1000));
+    TEST_ASSERT_EQUAL_UINT32(1000, static_cast<uint32_t>(m.unsavedMs(ENERGY_SAVE_ON_MS + 1000)));
+    TEST_ASSERT_TRUE(m.on());   // Saving does not disturb the running interval
+    TEST_ASSERT_TRUE(m.lifetimeOnMs(ENERGY_SAVE_ON_MS + 1000) == 123456ULL + ENERGY_SAVE_ON_MS + 1000);
+}
+
+void test_idle_never_due(void) {
+    EnergyMeter m;
+    m.update(0, false);
+    TEST_ASSERT_FALSE(m.saveDue(24 * 60 * MIN_MS));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_counts_only_on_time);
+    RUN_TEST(test_repeated_state_is_harmless);
+    RUN_TEST(test_kwh_conversion);
+    RUN_TEST(test_across_millis_wrap);
+    RUN_TEST(test_lifetime_beyond_32_bits);
+    RUN_TEST(test_save_due_after_unsaved_on_time);
+    RUN_TEST(test_idle_never_due);
+
+    return UNITY_END();
+}
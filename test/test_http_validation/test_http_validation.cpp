@@ -206,6 +206,52 @@ void test_parse_float_whitespace_only(void) {
     TEST_ASSERT_FALSE(parseFloatValue("   ", out));
 }
 
+// =============================================================================
+// extractJsonField
+// =============================================================================
+
+void test_extract_field_single(void) {
+    char out[16];
+    TEST_ASSERT_TRUE(extractJsonField("{\"state\":1}", "state", out, sizeof(out)) == JsonField::Found);
+    TEST_ASSERT_EQUAL_STRING("1", out);
+}
+
+void test_extract_field_stops_at_comma(void) {
+    // Multi-field body — value must not include the following field
+    char out[16];
+    const char* body = "{\"state\": 1, \"temperature\": 85.5}";
+    TEST_ASSERT_TRUE(extractJsonField(body, "state", out, sizeof(out)) == JsonField::Found);
+    TEST_ASSERT_EQUAL_STRING(" 1", out);
+    TEST_ASSERT_TRUE(extractJsonField(body, "temperature", out, sizeof(out)) == JsonField::Found);
+    TEST_ASSERT_EQUAL_STRING(" 85.5", out);
+}
+
+void test_extract_field_missing(void) {
+    char out[16];
+    TEST_ASSERT_TRUE(extractJsonField("{\"temperature\":80}", "state", out, sizeof(out)) == JsonField::Missing);
+}
+
+void test_extract_field_ignores_key_substring(void) {
+    // "heater_state" must not satisfy a lookup for "state"
+    char out[16];
+    TEST_ASSERT_TRUE(extractJsonField("{\"heater_state\":1}", "state", out, sizeof(out)) == JsonField::Missing);
+}
+
+void test_extract_field_no_colon_is_malformed(void) {
+    char out[16];
+    TEST_ASSERT_TRUE(extractJsonField("{\"state\" 1}", "state", out, sizeof(out)) == JsonField::Malformed);
+}
+
+void test_extract_field_oversized_value_is_malformed(void) {
+    char out[4];
+    TEST_ASSERT_TRUE(extractJsonField("{\"state\":12345}", "state", out, sizeof(out)) == JsonField::Malformed);
+}
+
+void test_extract_field_null_body(void) {
+    char out[4];
+    TEST_ASSERT_TRUE(extractJsonField(nullptr, "state", out, sizeof(out)) == JsonField::Missing);
+}
+
 // =============================================================================
 // Test Runner
 // =============================================================================
@@ -259,5 +305,14 @@ int main(void) {
     RUN_TEST(test_parse_float_rejects_trailing_alpha);
     RUN_TEST(test_parse_float_whitespace_only);
 
+    // extractJsonField
+    RUN_TEST(test_extract_field_single);
+    RUN_TEST(test_extract_field_stops_at_comma);
+    RUN_TEST(test_extract_field_missing);
+    RUN_TEST(test_extract_field_ignores_key_substring);
+    RUN_TEST(test_extract_field_no_colon_is_malformed);
+    RUN_TEST(test_extract_field_oversized_value_is_malformed);
+    RUN_TEST(test_extract_field_null_body);
+
     return UNITY_END();
 }
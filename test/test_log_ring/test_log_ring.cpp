@@ -0,0 +1,196 @@
+/**
+ * Unit tests for log_ring.h — runs on the host via PlatformIO native env.
+ *
+ * Covers ring ordering, overflow accounting, history reads and formatting.
+ */
+
+#include <unity.h>
+#include <cstring>
+#include "log_ring.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// =============================================================================
+// Push / Pop
+// =============================================================================
+
+void test_ring_starts_empty(void) {
+    LogRing<4> ring;
+    LogEntry e;
+    TEST_ASSERT_FALSE(ring.pop(e));
+    TEST_ASSERT_EQUAL_UINT32(0, ring.nextSeq());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped());
+}
+
+void test_ring_pops_in_order(void) {
+    LogRing<4> ring;
+    ring.push(LogLevel::Info, 100, LogMsg::HomeKitTargetHeat);
+    ring.push(LogLevel::Safety, 200, LogMsg::SensorFault, -127.0f);
+
+    LogEntry e;
+    TEST_ASSERT_TRUE(ring.pop(e));
+    TEST_ASSERT_EQUAL_UINT32(0, e.seq);
+    TEST_ASSERT_EQUAL_UINT32(100, e.timestampMs);
+    TEST_ASSERT_TRUE(e.msg == LogMsg::HomeKitTargetHeat);
+
+    TEST_ASSERT_TRUE(ring.pop(e));
+    TEST_ASSERT_EQUAL_UINT32(1, e.seq);
+    TEST_ASSERT_TRUE(e.level == LogLevel::Safety);
+    TEST_ASSERT_EQUAL_FLOAT(-127.0f, e.args[0]);
+
+    TEST_ASSERT_FALSE(ring.pop(e));
+}
+
+void test_ring_full_drops_newest(void) {
+    // A stalled drain must never block or overwrite — new entries are counted
+    LogRing<4> ring;
+    for (uint32_t i = 0; i < 4; ++i) {
+        TEST_ASSERT_TRUE(ring.push(LogLevel::Info, i, LogMsg::HomeKitTargetTemp, 70.0f));
+    }
+    TEST_ASSERT_FALSE(ring.push(LogLevel::Info, 99, LogMsg::HomeKitTargetTemp, 71.0f));
+    TEST_ASSERT_FALSE(ring.push(LogLevel::Info, 99, LogMsg::HomeKitTargetTemp, 72.0f));
+    TEST_ASSERT_EQUAL_UINT32(2, ring.dropped());
+    TEST_ASSERT_EQUAL_UINT32(4, ring.pending());
+
+    LogEntry e;
+    TEST_ASSERT_TRUE(ring.pop(e));
+    TEST_ASSERT_EQUAL_UINT32(0, e.timestampMs);
+}
+
+void test_ring_accepts_after_drain(void) {
+    LogRing<2> ring;
+    LogEntry e;
+    for (uint32_t i = 0; i < 10; ++i) {
+        TEST_ASSERT_TRUE(ring.push(LogLevel::Info, i, LogMsg::HomeKitTargetOff));
+        TEST_ASSERT_TRUE(ring.pop(e));
+        TEST_ASSERT_EQUAL_UINT32(i, e.seq);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped());
+}
+
+// =============================================================================
+// History Reads (GET /logs)
+// =============================================================================
+
+void test_read_retains_drained_entries(void) {
+    LogRing<4> ring;
+    ring.push(LogLevel::Info, 10, LogMsg::HomeKitTargetHeat);
+    LogEntry e;
+    ring.pop(e);
+
+    TEST_ASSERT_TRUE(ring.read(0, e));
+    TEST_ASSERT_EQUAL_UINT32(10, e.timestampMs);
+}
+
+void test_read_rejects_future_seq(void) {
+    LogRing<4> ring;
+    ring.push(LogLevel::Info, 10, LogMsg::HomeKitTargetHeat);
+    LogEntry e;
+    TEST_ASSERT_FALSE(ring.read(1, e));
+}
+
+void test_read_rejects_overwritten_seq(void) {
+    LogRing<4> ring;
+    LogEntry e;
+    for (uint32_t i = 0; i < 6; ++i) {
+        ring.push(LogLevel::Info, i, LogMsg::HomeKitTargetOff);
+        ring.pop(e);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, ring.oldestSeq());
+    TEST_ASSERT_FALSE(ring.read(1, e));
+    TEST_ASSERT_TRUE(ring.read(2, e));
+    TEST_ASSERT_EQUAL_UINT32(2, e.timestampMs);
+    TEST_ASSERT_TRUE(ring.read(5, e));
+    TEST_ASSERT_EQUAL_UINT32(5, e.timestampMs);
+}
+
+// =============================================================================
+// Formatting
+// =============================================================================
+
+void test_format_message_with_arg(void) {
+    LogEntry e = {};
+    e.msg = LogMsg::SensorFault;
+    e.args[0] = -127.0f;
+    char buf[96];
+    formatLogMessage(e, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("SAFETY: Temperature sensor fault (-127.0), heater disabled", buf);
+}
+
+void test_format_line_prefix(void) {
+    LogEntry e = {};
+    e.timestampMs = 12345;
+    e.level = LogLevel::Safety;
+    e.msg = LogMsg::SessionTimeout;
+    e.args[0] = 60.0f;
+    char buf[128];
+    formatLogLine(e, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "[   12345] SAFETY SAFETY: Session time limit (60 min) reached, heater disabled", buf);
+}
+
+void test_format_json_element(void) {
+    LogEntry e = {};
+    e.seq = 7;
+    e.timestampMs = 2000;
+    e.level = LogLevel::Info;
+    e.msg = LogMsg::HomeKitTargetOff;
+    char buf[128];
+    formatLogJson(e, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"seq\":7,\"t\":2000,\"level\":\"INFO\",\"id\":2,"
+        "\"msg\":\"HomeKit: Target state set to OFF\"}", buf);
+}
+
+void test_format_truncates_safely(void) {
+    LogEntry e = {};
+    e.msg = LogMsg::OverTemperature;
+    e.args[0] = 110.0f;
+    // Size known only at run time, so the compiler does not flag the truncation
+    volatile size_t small = 8;
+    size_t len = small;
+    char buf[32];
+    std::memset(buf, 'x', sizeof(buf));
+    int n = formatLogJson(e, buf, len);
+    TEST_ASSERT_TRUE(n >= static_cast<int>(len));    // Reports the untruncated length
+    TEST_ASSERT_EQUAL('\0', buf[len - 1]);
+    TEST_ASSERT_EQUAL('x', buf[len]);                // Nothing written past len
+}
+
+void test_formats_are_json_safe(void) {
+    // formatLogJson() embeds formats verbatim — no quotes or backslashes allowed
+    for (uint8_t i = 0; i < static_cast<uint8_t>(LogMsg::Count); ++i) {
+        const char* fmt = logMessageFormat(static_cast<LogMsg>(i));
+        TEST_ASSERT_NULL(std::strchr(fmt, '"'));
+        TEST_ASSERT_NULL(std::strchr(fmt, '\\'));
+    }
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Push / pop
+    RUN_TEST(test_ring_starts_empty);
+    RUN_TEST(test_ring_pops_in_order);
+    RUN_TEST(test_ring_full_drops_newest);
+    RUN_TEST(test_ring_accepts_after_drain);
+
+    // History reads
+    RUN_TEST(test_read_retains_drained_entries);
+    RUN_TEST(test_read_rejects_future_seq);
+    RUN_TEST(test_read_rejects_overwritten_seq);
+
+    // Formatting
+    RUN_TEST(test_format_message_with_arg);
+    RUN_TEST(test_format_line_prefix);
+    RUN_TEST(test_format_json_element);
+    RUN_TEST(test_format_truncates_safely);
+    RUN_TEST(test_formats_are_json_safe);
+
+    return UNITY_END();
+}
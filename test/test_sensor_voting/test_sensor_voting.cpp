@@ -0,0 +1,327 @@
+/**
+ * Unit tests for sensor_voting.h — runs on the host via PlatformIO native env.
+ *
+ * Covers the single-probe pass-through, median and 2-out-of-3 trip voting,
+ * the worst-case detection latency of each fault class, read failures,
+ * and a probe that sticks during a simulated heat-up (thermal_plant.h).
+ */
+
+#include <unity.h>
+#include <cmath>
+#include "sensor_voting.h"
+#include "thermal_plant.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+constexpr uint32_t READ_MS = 2000;
+
+/** Feeds the same round n times; returns the last result. */
+static VoteResult feed(SensorVote& v, float a, float b, float c, int n) {
+    float r[3] = {a, b, c};
+    VoteResult res;
+    for (int i = 0; i < n; ++i) res = v.update(r);
+    return res;
+}
+
+/** Rounds until a probe is voted out or the vote fails; -1 if neither within limit. */
+static int roundsToDetect(SensorVote& v, float a, float b, float c, int limit) {
+    float r[3] = {a, b, c};
+    for (int i = 1; i <= limit; ++i) {
+        VoteResult res = v.update(r);
+        if (res.excluded >= 0 || !res.valid) return i;
+    }
+    return -1;
+}
+
+// =============================================================================
+// Single probe
+// =============================================================================
+
+void test_single_probe_passes_through(void) {
+    SensorVote v;
+    v.begin(1);
+    float r[1] = {72.5f};
+    VoteResult res = v.update(r);
+    TEST_ASSERT_TRUE(res.valid);
+    TEST_ASSERT_EQUAL_FLOAT(72.5f, res.controlC);
+    TEST_ASSERT_EQUAL_FLOAT(72.5f, res.tripC);
+    TEST_ASSERT_EQUAL_UINT8(1, v.required());
+}
+
+void test_single_probe_fault_fails_vote(void) {
+    SensorVote v;
+    v.begin(1);
+    float r[1] = {SENSOR_DISCONNECTED_C};
+    VoteResult res = v.update(r);
+    TEST_ASSERT_FALSE(res.valid);
+    TEST_ASSERT_TRUE(res.fault == VoteFault::TooFewProbes);
+    TEST_ASSERT_TRUE(v.state(0) == ProbeState::Missing);
+
+    r[0] = 40.0f;   // Recovers like the single-probe firmware
+    TEST_ASSERT_TRUE(v.update(r).valid);
+}
+
+void test_probe_count_clamped(void) {
+    SensorVote v;
+    v.begin(5);
+    TEST_ASSERT_EQUAL_UINT8(VOTE_MAX_PROBES, v.probeCount());
+    v.begin(0);
+    TEST_ASSERT_EQUAL_UINT8(1, v.probeCount());
+}
+
+// =============================================================================
+// Voting
+// =============================================================================
+
+void test_three_probes_vote_median(void) {
+    SensorVote v;
+    v.begin(3);
+    VoteResult res = feed(v, 70.0f, 71.0f, 70.5f, 1);
+    TEST_ASSERT_TRUE(res.valid);
+    TEST_ASSERT_EQUAL_FLOAT(70.5f, res.controlC);
+    TEST_ASSERT_EQUAL_FLOAT(70.5f, res.tripC);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, res.spreadC);
+}
+
+void test_one_hot_probe_cannot_trip(void) {
+    // 2-out-of-3: one probe at the limit neither trips nor steers control
+    SensorVote v;
+    v.begin(3);
+    VoteResult res = feed(v, 90.0f, TEMP_MAX_CELSIUS + 5.0f, 90.5f, 1);
+    TEST_ASSERT_TRUE(res.valid);
+    TEST_ASSERT_FALSE(isOverTemperature(res.tripC));
+    TEST_ASSERT_EQUAL_FLOAT(90.5f, res.controlC);
+
+    // Two at the limit do trip
+    res = feed(v, TEMP_MAX_CELSIUS, TEMP_MAX_CELSIUS + 1.0f, 90.5f, 1);
+    TEST_ASSERT_TRUE(isOverTemperature(res.tripC));
+}
+
+void test_two_probes_trip_on_hotter(void) {
+    SensorVote v;
+    v.begin(2);
+    VoteResult res = feed(v, TEMP_MAX_CELSIUS - 1.0f, TEMP_MAX_CELSIUS + 0.5f, 0.0f, 1);
+    TEST_ASSERT_TRUE(res.valid);
+    TEST_ASSERT_TRUE(isOverTemperature(res.tripC));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, TEMP_MAX_CELSIUS - 0.25f, res.controlC);
+}
+
+void test_single_spike_tolerated(void) {
+    SensorVote v;
+    v.begin(3);
+    feed(v, 70.0f, 70.0f, 70.0f, 5);
+    VoteResult res = feed(v, 70.0f, 85.0f, 70.0f, 1);
+    TEST_ASSERT_TRUE(res.valid);
+    TEST_ASSERT_EQUAL_INT8(-1, res.excluded);
+    TEST_ASSERT_EQUAL_FLOAT(70.0f, res.controlC);
+    res = feed(v, 70.0f, 70.0f, 70.0f, 1);
+    TEST_ASSERT_TRUE(v.state(1) == ProbeState::Ok);
+    TEST_ASSERT_EQUAL_UINT8(3, res.healthy);
+}
+
+// =============================================================================
+// Detection latency
+// =============================================================================
+
+void test_disagreeing_probe_voted_out_at_bound(void) {
+    SensorVote v;
+    v.begin(3);
+    int rounds = roundsToDetect(v, 70.0f, 70.0f, 70.0f + VOTE_DISAGREE_C + 0.1f, 100);
+    TEST_ASSERT_EQUAL_INT(VOTE_DISAGREE_READINGS, rounds);
+    TEST_ASSERT_TRUE(v.state(2) == ProbeState::Disagree);
+}
+
+void test_drifting_probe_voted_out_at_bound(void) {
+    SensorVote v;
+    v.begin(3);
+    int rounds = roundsToDetect(v, 70.0f, 70.0f + VOTE_DRIFT_C + 0.1f, 70.0f, 1000);
+    TEST_ASSERT_EQUAL_INT(VOTE_DRIFT_READINGS, rounds);
+    TEST_ASSERT_TRUE(v.state(1) == ProbeState::Drift);
+}
+
+void test_excluded_probe_reported_once_and_stays_out(void) {
+    SensorVote v;
+    v.begin(3);
+    VoteResult res = feed(v, 70.0f, 70.2f, 50.0f, VOTE_DISAGREE_READINGS);
+    TEST_ASSERT_EQUAL_INT8(2, res.excluded);
+    TEST_ASSERT_TRUE(res.valid);
+    TEST_ASSERT_EQUAL_UINT8(2, res.healthy);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 70.1f, res.controlC);
+
+    // Back in agreement — still out, and not reported again
+    res = feed(v, 70.0f, 70.2f, 70.1f, 10);
+    TEST_ASSERT_EQUAL_INT8(-1, res.excluded);
+    TEST_ASSERT_EQUAL_UINT8(2, res.healthy);
+    TEST_ASSERT_TRUE(v.state(2) == ProbeState::Disagree);
+    TEST_ASSERT_EQUAL_FLOAT(70.1f, v.reading(2));
+}
+
+void test_intermittent_drift_still_caught(void) {
+    // Off two readings in three: the leaky count still reaches confirmation
+    SensorVote v;
+    v.begin(3);
+    const float off = 70.0f + VOTE_DRIFT_C + 0.5f;
+    int rounds = 0;
+    for (int i = 0; i < 1000 && v.state(0) == ProbeState::Ok; ++i) {
+        float r[3] = {(i % 3 == 2) ? 70.0f : off, 70.0f, 70.0f};
+        v.update(r);
+        ++rounds;
+    }
+    TEST_ASSERT_TRUE(v.state(0) == ProbeState::Drift);
+    TEST_ASSERT_TRUE(rounds <= 3 * VOTE_DRIFT_READINGS);
+}
+
+void test_within_tolerance_never_flagged(void) {
+    SensorVote v;
+    v.begin(3);
+    VoteResult res = feed(v, 70.0f, 70.0f + VOTE_DRIFT_C, 70.0f - VOTE_DRIFT_C, 1000);
+    TEST_ASSERT_TRUE(res.valid);
+    TEST_ASSERT_EQUAL_UINT8(3, res.healthy);
+}
+
+void test_two_probes_disagree_fails_vote_at_bound(void) {
+    SensorVote v;
+    v.begin(2);
+    int rounds = roundsToDetect(v, 70.0f, 70.0f + VOTE_DISAGREE_C + 0.1f, 0.0f, 100);
+    TEST_ASSERT_EQUAL_INT(VOTE_DISAGREE_READINGS, rounds);
+    VoteResult res = feed(v, 70.0f, 74.0f, 0.0f, 1);
+    TEST_ASSERT_TRUE(res.fault == VoteFault::Disagreement);
+    // Neither can be blamed, so neither is voted out
+    TEST_ASSERT_TRUE(v.state(0) == ProbeState::Ok);
+    TEST_ASSERT_TRUE(v.state(1) == ProbeState::Ok);
+
+    // Agreement restores the vote (the session it ended stays ended)
+    res = feed(v, 70.0f, 70.2f, 0.0f, 1);
+    TEST_ASSERT_TRUE(res.valid);
+}
+
+void test_two_outliers_have_no_majority(void) {
+    SensorVote v;
+    v.begin(3);
+    int rounds = roundsToDetect(v, 60.0f, 70.0f, 80.0f, 100);
+    TEST_ASSERT_EQUAL_INT(VOTE_DISAGREE_READINGS, rounds);
+    VoteResult res = feed(v, 60.0f, 70.0f, 80.0f, 1);
+    TEST_ASSERT_TRUE(res.fault == VoteFault::Disagreement);
+    TEST_ASSERT_TRUE(v.state(0) == ProbeState::Ok);
+    TEST_ASSERT_TRUE(v.state(2) == ProbeState::Ok);
+}
+
+// =============================================================================
+// Read failures
+// =============================================================================
+
+void test_missing_probe_rejoins(void) {
+    SensorVote v;
+    v.begin(3);
+    VoteResult res = feed(v, 70.0f, SENSOR_DISCONNECTED_C, 70.4f, 1);
+    TEST_ASSERT_TRUE(res.valid);
+    TEST_ASSERT_EQUAL_UINT8(2, res.healthy);
+    TEST_ASSERT_TRUE(v.state(1) == ProbeState::Missing);
+    res = feed(v, 70.0f, 70.2f, 70.4f, 1);
+    TEST_ASSERT_EQUAL_UINT8(3, res.healthy);
+    TEST_ASSERT_TRUE(v.state(1) == ProbeState::Ok);
+}
+
+void test_nan_reading_is_missing(void) {
+    SensorVote v;
+    v.begin(2);
+    VoteResult res = feed(v, NAN, 70.0f, 0.0f, 1);
+    TEST_ASSERT_FALSE(res.valid);
+    TEST_ASSERT_TRUE(res.fault == VoteFault::TooFewProbes);
+}
+
+void test_two_probes_need_both(void) {
+    // One probe left cannot be cross-checked
+    SensorVote v;
+    v.begin(2);
+    VoteResult res = feed(v, 70.0f, SENSOR_DISCONNECTED_C, 0.0f, 1);
+    TEST_ASSERT_FALSE(res.valid);
+    TEST_ASSERT_EQUAL_UINT8(1, res.healthy);
+}
+
+void test_last_probe_after_exclusion_not_trusted(void) {
+    SensorVote v;
+    v.begin(3);
+    feed(v, 70.0f, 70.0f, 40.0f, VOTE_DISAGREE_READINGS);
+    TEST_ASSERT_TRUE(v.state(2) == ProbeState::Disagree);
+    VoteResult res = feed(v, 70.0f, SENSOR_DISCONNECTED_C, 70.0f, 1);
+    TEST_ASSERT_FALSE(res.valid);
+    TEST_ASSERT_TRUE(res.fault == VoteFault::TooFewProbes);
+}
+
+// =============================================================================
+// Simulated heat-up
+// =============================================================================
+
+void test_stuck_probe_during_heatup(void) {
+    // Probe 2 freezes 5 min into a full-power heat-up. It is voted out within
+    // the drift bound of first being VOTE_DRIFT_C off, and the control value
+    // follows the good probes throughout.
+    ThermalPlantParams params;
+    ThermalPlantState state;
+    SensorVote v;
+    v.begin(3);
+    const uint32_t stuckAtMs = 5 * 60000;
+    float stuckC = 0.0f;
+    int32_t offSinceMs = -1;
+    int32_t detectedMs = -1;
+    float worstControlError = 0.0f;
+
+    for (uint32_t t = 0; t < 30 * 60000 && detectedMs < 0; t += READ_MS) {
+        thermalPlantStep(state, params, READ_MS / 1000.0f, true);
+        float good = std::floor(state.sensorC * 16.0f + 0.5f) / 16.0f;
+        if (t == stuckAtMs) stuckC = good;
+        float probe2 = t >= stuckAtMs ? stuckC : good;
+        if (offSinceMs < 0 && std::fabs(probe2 - good) > VOTE_DRIFT_C) {
+            offSinceMs = static_cast<int32_t>(t);
+        }
+
+        float r[3] = {good, good + 0.25f, probe2};
+        VoteResult res = v.update(r);
+        TEST_ASSERT_TRUE(res.valid);
+        float err = std::fabs(res.controlC - good);
+        if (err > worstControlError) worstControlError = err;
+        if (res.excluded == 2) detectedMs = static_cast<int32_t>(t);
+    }
+
+    TEST_ASSERT_TRUE(offSinceMs >= 0);
+    TEST_ASSERT_TRUE(detectedMs >= 0);
+    TEST_ASSERT_TRUE(detectedMs - offSinceMs <= static_cast<int32_t>((VOTE_DRIFT_READINGS - 1) * READ_MS));
+    TEST_ASSERT_TRUE(worstControlError <= 0.25f);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Single probe
+    RUN_TEST(test_single_probe_passes_through);
+    RUN_TEST(test_single_probe_fault_fails_vote);
+    RUN_TEST(test_probe_count_clamped);
+
+    // Voting
+    RUN_TEST(test_three_probes_vote_median);
+    RUN_TEST(test_one_hot_probe_cannot_trip);
+    RUN_TEST(test_two_probes_trip_on_hotter);
+    RUN_TEST(test_single_spike_tolerated);
+
+    // Detection latency
+    RUN_TEST(test_disagreeing_probe_voted_out_at_bound);
+    RUN_TEST(test_drifting_probe_voted_out_at_bound);
+    RUN_TEST(test_excluded_probe_reported_once_and_stays_out);
+    RUN_TEST(test_intermittent_drift_still_caught);
+    RUN_TEST(test_within_tolerance_never_flagged);
+    RUN_TEST(test_two_probes_disagree_fails_vote_at_bound);
+    RUN_TEST(test_two_outliers_have_no_majority);
+
+    // Read failures
+    RUN_TEST(test_missing_probe_rejoins);
+    RUN_TEST(test_nan_reading_is_missing);
+    RUN_TEST(test_two_probes_need_both);
+    RUN_TEST(test_last_probe_after_exclusion_not_trusted);
+
+    // Simulated heat-up
+    RUN_TEST(test_stuck_probe_during_heatup);
+
+    return UNITY_END();
+}
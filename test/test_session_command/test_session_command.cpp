@@ -0,0 +1,166 @@
+/**
+ * Unit tests for session_command.h — runs on the host via PlatformIO native env.
+ *
+ * Covers all-or-nothing parsing and validation for POST /session.
+ */
+
+#include <unity.h>
+#include "session_command.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// =============================================================================
+// Parsing
+// =============================================================================
+
+void test_parse_state_and_temperature(void) {
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommand("{\"state\":1,\"temperature\":85.5}", cmd)
+                     == SessionCommandResult::Ok);
+    TEST_ASSERT_TRUE(cmd.hasState);
+    TEST_ASSERT_EQUAL_INT(1, cmd.state);
+    TEST_ASSERT_TRUE(cmd.hasTemperature);
+    TEST_ASSERT_EQUAL_FLOAT(85.5f, cmd.temperature);
+}
+
+void test_parse_field_order_independent(void) {
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommand("{ \"temperature\": 70 , \"state\": 0 }", cmd)
+                     == SessionCommandResult::Ok);
+    TEST_ASSERT_EQUAL_INT(0, cmd.state);
+    TEST_ASSERT_EQUAL_FLOAT(70.0f, cmd.temperature);
+}
+
+void test_parse_state_only(void) {
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommand("{\"state\":1}", cmd) == SessionCommandResult::Ok);
+    TEST_ASSERT_TRUE(cmd.hasState);
+    TEST_ASSERT_FALSE(cmd.hasTemperature);
+}
+
+void test_parse_temperature_only(void) {
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommand("{\"temperature\":60}", cmd) == SessionCommandResult::Ok);
+    TEST_ASSERT_FALSE(cmd.hasState);
+    TEST_ASSERT_TRUE(cmd.hasTemperature);
+}
+
+void test_parse_empty_object(void) {
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommand("{}", cmd) == SessionCommandResult::NoFields);
+}
+
+void test_parse_non_numeric_state(void) {
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommand("{\"state\":\"on\",\"temperature\":80}", cmd)
+                     == SessionCommandResult::InvalidState);
+}
+
+void test_parse_non_numeric_temperature(void) {
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommand("{\"state\":1,\"temperature\":hot}", cmd)
+                     == SessionCommandResult::InvalidTemperature);
+}
+
+void test_parse_missing_colon(void) {
+    SessionCommand cmd;
+    TEST_ASSERT_TRUE(parseSessionCommand("{\"state\" 1}", cmd) == SessionCommandResult::MalformedJson);
+}
+
+// =============================================================================
+// Validation (all-or-nothing)
+// =============================================================================
+
+void test_validate_accepts_valid_batch(void) {
+    SessionCommand cmd;
+    parseSessionCommand("{\"state\":1,\"temperature\":80}", cmd);
+    TEST_ASSERT_TRUE(validateSessionCommand(cmd, false) == SessionCommandResult::Ok);
+}
+
+void test_validate_rejects_whole_batch_on_bad_temperature(void) {
+    // Valid state must not be applied when the temperature is out of range
+    SessionCommand cmd;
+    parseSessionCommand("{\"state\":1,\"temperature\":120}", cmd);
+    TEST_ASSERT_TRUE(validateSessionCommand(cmd, false) == SessionCommandResult::TemperatureOutOfRange);
+}
+
+void test_validate_rejects_whole_batch_on_bad_state(void) {
+    SessionCommand cmd;
+    parseSessionCommand("{\"state\":2,\"temperature\":80}", cmd);
+    TEST_ASSERT_TRUE(validateSessionCommand(cmd, false) == SessionCommandResult::InvalidState);
+}
+
+void test_validate_heat_blocked_on_sensor_fault(void) {
+    SessionCommand cmd;
+    parseSessionCommand("{\"state\":1,\"temperature\":80}", cmd);
+    TEST_ASSERT_TRUE(validateSessionCommand(cmd, true) == SessionCommandResult::SensorFault);
+}
+
+void test_validate_off_allowed_on_sensor_fault(void) {
+    // Turning OFF is always accepted
+    SessionCommand cmd;
+    parseSessionCommand("{\"state\":0,\"temperature\":80}", cmd);
+    TEST_ASSERT_TRUE(validateSessionCommand(cmd, true) == SessionCommandResult::Ok);
+}
+
+void test_validate_temperature_only_on_sensor_fault(void) {
+    SessionCommand cmd;
+    parseSessionCommand("{\"temperature\":80}", cmd);
+    TEST_ASSERT_TRUE(validateSessionCommand(cmd, true) == SessionCommandResult::Ok);
+}
+
+void test_off_command_recognised(void) {
+    SessionCommand off, offWithTarget, heat, target;
+    parseSessionCommand("{\"state\":0}", off);
+    parseSessionCommand("{\"state\":0,\"temperature\":80}", offWithTarget);
+    parseSessionCommand("{\"state\":1}", heat);
+    parseSessionCommand("{\"temperature\":80}", target);
+    TEST_ASSERT_TRUE(isHeaterOffCommand(off));
+    TEST_ASSERT_TRUE(isHeaterOffCommand(offWithTarget));
+    TEST_ASSERT_FALSE(isHeaterOffCommand(heat));
+    TEST_ASSERT_FALSE(isHeaterOffCommand(target));
+}
+
+// =============================================================================
+// HTTP Mapping
+// =============================================================================
+
+void test_http_status_codes(void) {
+    TEST_ASSERT_EQUAL_INT(200, sessionCommandHttpStatus(SessionCommandResult::Ok));
+    TEST_ASSERT_EQUAL_INT(400, sessionCommandHttpStatus(SessionCommandResult::InvalidState));
+    TEST_ASSERT_EQUAL_INT(400, sessionCommandHttpStatus(SessionCommandResult::TemperatureOutOfRange));
+    TEST_ASSERT_EQUAL_INT(503, sessionCommandHttpStatus(SessionCommandResult::SensorFault));
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Parsing
+    RUN_TEST(test_parse_state_and_temperature);
+    RUN_TEST(test_parse_field_order_independent);
+    RUN_TEST(test_parse_state_only);
+    RUN_TEST(test_parse_temperature_only);
+    RUN_TEST(test_parse_empty_object);
+    RUN_TEST(test_parse_non_numeric_state);
+    RUN_TEST(test_parse_non_numeric_temperature);
+    RUN_TEST(test_parse_missing_colon);
+
+    // Validation
+    RUN_TEST(test_validate_accepts_valid_batch);
+    RUN_TEST(test_validate_rejects_whole_batch_on_bad_temperature);
+    RUN_TEST(test_validate_rejects_whole_batch_on_bad_state);
+    RUN_TEST(test_validate_heat_blocked_on_sensor_fault);
+    RUN_TEST(test_validate_off_allowed_on_sensor_fault);
+    RUN_TEST(test_validate_temperature_only_on_sensor_fault);
+    RUN_TEST(test_off_command_recognised);
+
+    // HTTP mapping
+    RUN_TEST(test_http_status_codes);
+
+    return UNITY_END();
+}
@@ -0,0 +1,187 @@
+/**
+ * Unit tests for session_resume.h — runs on the host via PlatformIO native env.
+ *
+ * Covers the checkpoint checksum, the resume decision for each reset cause,
+ * elapsed-time accounting across resets (a crash loop must still hit the
+ * session limit) and carrying a profile's position across a reset.
+ */
+
+#include <unity.h>
+#include <cstring>
+#include "session_resume.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+constexpr uint32_t MIN_MS = 60000;
+
+static RetainedSession checkpoint(uint32_t elapsedMs, uint8_t resumes = 0) {
+    RetainedSession r = RetainedSession();
+    retainSession(r, elapsedMs, 80.0f, resumes, nullptr);
+    return r;
+}
+
+// =============================================================================
+// Checkpoint
+// =============================================================================
+
+void test_checkpoint_valid(void) {
+    RetainedSession r = checkpoint(10 * MIN_MS);
+    TEST_ASSERT_EQUAL_UINT32(RETAINED_SESSION_MAGIC, r.magic);
+    TEST_ASSERT_EQUAL_UINT32(retainedSessionChecksum(r), r.checksum);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Brownout, r) == ResumeDecision::Resume);
+}
+
+void test_any_flipped_bit_detected(void) {
+    RetainedSession r = checkpoint(10 * MIN_MS);
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(&r);
+    for (size_t i = 0; i < offsetof(RetainedSession, checksum); ++i) {
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            bytes[i] ^= static_cast<uint8_t>(1u << bit);
+            ResumeDecision d = decideResume(ResetCause::Watchdog, r);
+            TEST_ASSERT_TRUE(d != ResumeDecision::Resume);
+            bytes[i] ^= static_cast<uint8_t>(1u << bit);
+        }
+    }
+}
+
+void test_uninitialised_memory_not_resumed(void) {
+    RetainedSession r;
+    std::memset(static_cast<void*>(&r), 0xA5, sizeof(r));   // RTC memory after a cold boot
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Panic, r) == ResumeDecision::NoSession);
+}
+
+void test_cleared_checkpoint_not_resumed(void) {
+    RetainedSession r = checkpoint(MIN_MS);
+    clearRetainedSession(r);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Software, r) == ResumeDecision::NoSession);
+}
+
+// =============================================================================
+// Decision
+// =============================================================================
+
+void test_power_on_never_resumes(void) {
+    RetainedSession r = checkpoint(MIN_MS);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::PowerOn, r) == ResumeDecision::PowerOn);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Unknown, r) == ResumeDecision::PowerOn);
+}
+
+void test_every_reset_cause_resumes(void) {
+    RetainedSession r = checkpoint(MIN_MS);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Brownout, r) == ResumeDecision::Resume);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Watchdog, r) == ResumeDecision::Resume);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Panic, r) == ResumeDecision::Resume);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Software, r) == ResumeDecision::Resume);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::External, r) == ResumeDecision::Resume);
+}
+
+void test_invalid_target_rejected(void) {
+    RetainedSession r = RetainedSession();
+    retainSession(r, MIN_MS, 120.0f, 0, nullptr);   // Checksum fine, value not
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Panic, r) == ResumeDecision::Corrupt);
+}
+
+void test_elapsed_includes_penalty(void) {
+    RetainedSession r = checkpoint(20 * MIN_MS);
+    TEST_ASSERT_EQUAL_UINT32(20 * MIN_MS + SESSION_RESUME_PENALTY_MS, resumedElapsedMs(r));
+    r = checkpoint(UINT32_MAX - 1);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, resumedElapsedMs(r));
+}
+
+void test_limit_reached_near_session_end(void) {
+    RetainedSession r = checkpoint(SESSION_MAX_MS - SESSION_RESUME_PENALTY_MS);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Brownout, r) == ResumeDecision::LimitReached);
+    r = checkpoint(SESSION_MAX_MS - SESSION_RESUME_PENALTY_MS - 1);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Brownout, r) == ResumeDecision::Resume);
+}
+
+void test_resume_count_capped(void) {
+    RetainedSession r = checkpoint(MIN_MS, SESSION_MAX_RESUMES - 1);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Watchdog, r) == ResumeDecision::Resume);
+    r = checkpoint(MIN_MS, SESSION_MAX_RESUMES);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Watchdog, r) == ResumeDecision::TooManyResumes);
+}
+
+void test_crash_loop_cannot_extend_session(void) {
+    // Resets 1 s after every resume: the session ends by count, and the
+    // session time credited never goes backwards
+    RetainedSession r = checkpoint(30 * MIN_MS);
+    uint32_t elapsed = r.elapsedMs;
+    int resumed = 0;
+    while (decideResume(ResetCause::Brownout, r) == ResumeDecision::Resume) {
+        uint32_t restored = resumedElapsedMs(r);
+        TEST_ASSERT_TRUE(restored > elapsed);
+        elapsed = restored + 1000;
+        retainSession(r, elapsed, r.targetC, static_cast<uint8_t>(r.resumes + 1), nullptr);
+        ++resumed;
+    }
+    TEST_ASSERT_EQUAL_INT(SESSION_MAX_RESUMES, resumed);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Brownout, r) == ResumeDecision::TooManyResumes);
+}
+
+// =============================================================================
+// Profile Position
+// =============================================================================
+
+void test_profile_position_carried_across_reset(void) {
+    TempProfile p;
+    parseProfile("2:80:10;0:70:5", p);
+    ProfileRunner before;
+    before.start(p, 0, 60.0f);
+    before.update(4 * MIN_MS, 65.0f);                  // Ramp at 68 °C
+
+    RetainedSession r = RetainedSession();
+    ProfileRunnerState st = before.save(4 * MIN_MS);
+    retainSession(r, 4 * MIN_MS, before.setpoint(), 0, &st);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Panic, r) == ResumeDecision::Resume);
+
+    // After the reset millis() restarts near zero
+    ProfileRunner after;
+    after.restore(r.profile, 1500);
+    TEST_ASSERT_TRUE(after.phase() == ProfilePhase::Ramp);
+    TEST_ASSERT_EQUAL_UINT32(before.remainingMs(4 * MIN_MS), after.remainingMs(1500));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 70.0f, after.update(1500 + MIN_MS, 66.0f));
+}
+
+void test_bad_profile_position_rejected(void) {
+    TempProfile p;
+    parseProfile("0:80:10", p);
+    ProfileRunner runner;
+    runner.start(p, 0, 40.0f);
+    ProfileRunnerState st = runner.save(0);
+    st.segment = 1;                                    // Past the last segment
+
+    RetainedSession r = RetainedSession();
+    retainSession(r, MIN_MS, 80.0f, 0, &st);
+    TEST_ASSERT_TRUE(decideResume(ResetCause::Panic, r) == ResumeDecision::Corrupt);
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Checkpoint
+    RUN_TEST(test_checkpoint_valid);
+    RUN_TEST(test_any_flipped_bit_detected);
+    RUN_TEST(test_uninitialised_memory_not_resumed);
+    RUN_TEST(test_cleared_checkpoint_not_resumed);
+
+    // Decision
+    RUN_TEST(test_power_on_never_resumes);
+    RUN_TEST(test_every_reset_cause_resumes);
+    RUN_TEST(test_invalid_target_rejected);
+    RUN_TEST(test_elapsed_includes_penalty);
+    RUN_TEST(test_limit_reached_near_session_end);
+    RUN_TEST(test_resume_count_capped);
+    RUN_TEST(test_crash_loop_cannot_extend_session);
+
+    // Profile position
+    RUN_TEST(test_profile_position_carried_across_reset);
+    RUN_TEST(test_bad_profile_position_rejected);
+
+    return UNITY_END();
+}
@@ -0,0 +1,276 @@
+/**
+ * Unit tests for session_stats.h — runs on the host via PlatformIO native env.
+ *
+ * Covers incremental aggregates, sample-and-hold timing, the journal ring
+ * and JSON rendering.
+ */
+
+#include <unity.h>
+#include <cstring>
+#include "session_stats.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// =============================================================================
+// Aggregates
+// =============================================================================
+
+void test_inactive_until_started(void) {
+    SessionAggregator agg;
+    TEST_ASSERT_FALSE(agg.active());
+    agg.addSample(1000, 50.0f, 80.0f, true);   // Ignored
+    agg.start(2000, 80.0f);
+    TEST_ASSERT_TRUE(agg.active());
+    TEST_ASSERT_EQUAL_UINT16(0, agg.snapshot(2000).samples);
+}
+
+void test_min_max_mean(void) {
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    agg.addSample(2000, 30.0f, 80.0f, true);
+    agg.addSample(4000, 50.0f, 80.0f, true);
+    agg.addSample(6000, 40.0f, 80.0f, true);
+    SessionRecord r = agg.finish(8000, SessionEndReason::User);
+    TEST_ASSERT_EQUAL_INT16(300, r.minDeciC);
+    TEST_ASSERT_EQUAL_INT16(500, r.maxDeciC);
+    TEST_ASSERT_EQUAL_INT16(400, r.meanDeciC);
+    TEST_ASSERT_EQUAL_UINT16(3, r.samples);
+    TEST_ASSERT_EQUAL_UINT32(0, r.startMs);
+    TEST_ASSERT_EQUAL_UINT32(8000, r.endMs);
+    TEST_ASSERT_FALSE(agg.active());
+}
+
+void test_mean_stable_over_long_session(void) {
+    // 60 min at one reading per 2 s, alternating 79/81 — mean must stay 80.0
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    for (uint32_t i = 1; i <= 1800; ++i) {
+        agg.addSample(i * 2000, (i & 1) ? 79.0f : 81.0f, 80.0f, false);
+    }
+    SessionRecord r = agg.snapshot(3600000);
+    TEST_ASSERT_EQUAL_INT16(800, r.meanDeciC);
+    TEST_ASSERT_EQUAL_UINT16(1800, r.samples);
+}
+
+void test_time_to_target_uses_band(void) {
+    // Reached once within 2 °C below target, not at the exact target
+    SessionAggregator agg;
+    agg.start(1000, 80.0f);
+    agg.addSample(3000, 70.0f, 80.0f, true);
+    agg.addSample(5000, 77.9f, 80.0f, true);
+    agg.addSample(7000, 78.0f, 80.0f, true);
+    agg.addSample(9000, 80.5f, 80.0f, false);
+    TEST_ASSERT_EQUAL_UINT32(6000, agg.snapshot(9000).timeToTargetMs);
+}
+
+void test_time_to_target_not_reached(void) {
+    SessionAggregator agg;
+    agg.start(0, 90.0f);
+    agg.addSample(2000, 60.0f, 90.0f, true);
+    TEST_ASSERT_EQUAL_UINT32(SESSION_TARGET_NOT_REACHED, agg.snapshot(4000).timeToTargetMs);
+}
+
+void test_in_band_time_sample_and_hold(void) {
+    // Each sample's in-band state holds until the next sample
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    agg.addSample(2000, 79.0f, 80.0f, false);   // in band  [2000, 4000)
+    agg.addSample(4000, 83.0f, 80.0f, false);   // out      [4000, 6000)
+    agg.addSample(6000, 81.5f, 80.0f, false);   // in band  [6000, 10000)
+    SessionRecord r = agg.finish(10000, SessionEndReason::Timeout);
+    TEST_ASSERT_EQUAL_UINT32(6000, r.inBandMs);
+}
+
+void test_in_band_follows_target_change(void) {
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    agg.addSample(2000, 80.0f, 80.0f, false);   // in band
+    agg.addSample(4000, 80.0f, 90.0f, true);    // target raised — now out
+    SessionRecord r = agg.finish(6000, SessionEndReason::User);
+    TEST_ASSERT_EQUAL_UINT32(2000, r.inBandMs);
+    TEST_ASSERT_EQUAL_INT16(900, r.targetDeciC);
+}
+
+void test_heater_duty(void) {
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    agg.addSample(0, 40.0f, 80.0f, true);       // on  [0, 3000)
+    agg.addSample(3000, 81.0f, 80.0f, false);   // off [3000, 4000)
+    agg.addSample(4000, 77.0f, 80.0f, true);    // on  [4000, 5000)
+    SessionRecord r = agg.finish(5000, SessionEndReason::User);
+    TEST_ASSERT_EQUAL_UINT32(4000, r.heaterOnMs);
+}
+
+void test_time_before_first_sample_not_credited(void) {
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    agg.addSample(2750, 79.5f, 80.0f, true);
+    SessionRecord r = agg.finish(4750, SessionEndReason::User);
+    TEST_ASSERT_EQUAL_UINT32(2000, r.heaterOnMs);
+    TEST_ASSERT_EQUAL_UINT32(2000, r.inBandMs);
+}
+
+void test_end_reason_recorded(void) {
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    TEST_ASSERT_TRUE(agg.finish(1, SessionEndReason::OverTemperature).reason ==
+                     SessionEndReason::OverTemperature);
+    TEST_ASSERT_EQUAL_STRING("over_temp", sessionEndReasonName(SessionEndReason::OverTemperature));
+    TEST_ASSERT_EQUAL_STRING("fault", sessionEndReasonName(SessionEndReason::SensorFault));
+    TEST_ASSERT_EQUAL_STRING("timeout", sessionEndReasonName(SessionEndReason::Timeout));
+    TEST_ASSERT_EQUAL_STRING("user", sessionEndReasonName(SessionEndReason::User));
+}
+
+void test_restart_discards_previous(void) {
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    agg.addSample(2000, 100.0f, 80.0f, true);
+    agg.start(10000, 70.0f);
+    agg.addSample(12000, 50.0f, 70.0f, true);
+    SessionRecord r = agg.snapshot(14000);
+    TEST_ASSERT_EQUAL_INT16(500, r.maxDeciC);
+    TEST_ASSERT_EQUAL_UINT32(2000, r.heaterOnMs);
+    TEST_ASSERT_EQUAL_UINT32(10000, r.startMs);
+}
+
+void test_elapsed_across_millis_wrap(void) {
+    SessionAggregator agg;
+    agg.start(0xFFFFF000u, 80.0f);
+    agg.addSample(0xFFFFF800u, 60.0f, 80.0f, true);
+    SessionRecord r = agg.finish(0x00000800u, SessionEndReason::User);
+    TEST_ASSERT_EQUAL_UINT32(0x1000, r.heaterOnMs);
+}
+
+// =============================================================================
+// Journal
+// =============================================================================
+
+static SessionRecord recordStartingAt(uint32_t startMs) {
+    SessionAggregator agg;
+    agg.start(startMs, 80.0f);
+    return agg.finish(startMs + 1000, SessionEndReason::User);
+}
+
+void test_journal_newest_first(void) {
+    SessionJournal<4> j;
+    j.add(recordStartingAt(100));
+    j.add(recordStartingAt(200));
+    SessionRecord r;
+    uint32_t id;
+    TEST_ASSERT_EQUAL_UINT8(2, j.count());
+    TEST_ASSERT_TRUE(j.newest(0, r, id));
+    TEST_ASSERT_EQUAL_UINT32(200, r.startMs);
+    TEST_ASSERT_EQUAL_UINT32(1, id);
+    TEST_ASSERT_TRUE(j.newest(1, r, id));
+    TEST_ASSERT_EQUAL_UINT32(100, r.startMs);
+    TEST_ASSERT_EQUAL_UINT32(0, id);
+    TEST_ASSERT_FALSE(j.newest(2, r, id));
+}
+
+void test_journal_keeps_last_n(void) {
+    SessionJournal<4> j;
+    for (uint32_t i = 0; i < 10; ++i) j.add(recordStartingAt(i * 1000));
+    TEST_ASSERT_EQUAL_UINT8(4, j.count());
+    TEST_ASSERT_EQUAL_UINT32(10, j.total());
+    SessionRecord r;
+    uint32_t id;
+    TEST_ASSERT_TRUE(j.newest(3, r, id));
+    TEST_ASSERT_EQUAL_UINT32(6, id);
+    TEST_ASSERT_EQUAL_UINT32(6000, r.startMs);
+}
+
+void test_record_is_compact(void) {
+    TEST_ASSERT_TRUE(sizeof(SessionRecord) <= 32);
+}
+
+// =============================================================================
+// JSON
+// =============================================================================
+
+void test_json_finished_session(void) {
+    SessionAggregator agg;
+    agg.start(1000, 80.0f);
+    agg.addSample(3000, 79.0f, 80.0f, true);
+    SessionRecord r = agg.finish(5000, SessionEndReason::Timeout);
+    char buf[288];
+    int n = formatSessionJson(r, 7, false, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(n > 0 && static_cast<size_t>(n) < sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"id\":7,\"start_ms\":1000,\"end_ms\":5000,\"duration_s\":4,\"target\":80.0,"
+        "\"time_to_target_s\":2,\"min\":79.0,\"max\":79.0,\"mean\":79.0,"
+        "\"in_band_s\":2,\"duty_pct\":50.0,\"samples\":1,\"end\":\"timeout\"}", buf);
+}
+
+void test_json_in_progress_without_samples(void) {
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    char buf[288];
+    formatSessionJson(agg.snapshot(1000), 0, true, buf, sizeof(buf));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"time_to_target_s\":null"));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"min\":null,\"max\":null,\"mean\":null"));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"end\":null}"));
+}
+
+void test_json_energy(void) {
+    SessionAggregator agg;
+    agg.start(0, 80.0f);
+    agg.addSample(0, 60.0f, 80.0f, true);
+    SessionRecord r = agg.finish(30 * 60000, SessionEndReason::User);   // 30 min at 7 kW
+    char buf[320];
+    formatSessionJson(r, 0, false, buf, sizeof(buf), 7000.0f);
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"duty_pct\":100.0,\"energy_kwh\":3.500,\"samples\":1,"));
+}
+
+void test_json_worst_case_fits_buffer(void) {
+    SessionRecord r;
+    r.startMs = 0xFFFFFFFFu;
+    r.endMs = 0xFFFFFFFEu;
+    r.timeToTargetMs = 0xFFFFFFFEu;
+    r.inBandMs = 0xFFFFFFFFu;
+    r.heaterOnMs = 0xFFFFFFFFu;
+    r.targetDeciC = r.minDeciC = r.maxDeciC = r.meanDeciC = -32768;
+    r.samples = 65535;
+    r.reason = SessionEndReason::OverTemperature;
+    char buf[288];
+    int n = formatSessionJson(r, 0xFFFFFFFFu, false, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(n > 0 && static_cast<size_t>(n) < sizeof(buf));
+    char withEnergy[320];
+    n = formatSessionJson(r, 0xFFFFFFFFu, false, withEnergy, sizeof(withEnergy), 30000.0f);
+    TEST_ASSERT_TRUE(n > 0 && static_cast<size_t>(n) < sizeof(withEnergy));
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Aggregates
+    RUN_TEST(test_inactive_until_started);
+    RUN_TEST(test_min_max_mean);
+    RUN_TEST(test_mean_stable_over_long_session);
+    RUN_TEST(test_time_to_target_uses_band);
+    RUN_TEST(test_time_to_target_not_reached);
+    RUN_TEST(test_in_band_time_sample_and_hold);
+    RUN_TEST(test_in_band_follows_target_change);
+    RUN_TEST(test_heater_duty);
+    RUN_TEST(test_time_before_first_sample_not_credited);
+    RUN_TEST(test_end_reason_recorded);
+    RUN_TEST(test_restart_discards_previous);
+    RUN_TEST(test_elapsed_across_millis_wrap);
+
+    // Journal
+    RUN_TEST(test_journal_newest_first);
+    RUN_TEST(test_journal_keeps_last_n);
+    RUN_TEST(test_record_is_compact);
+
+    // JSON
+    RUN_TEST(test_json_finished_session);
+    RUN_TEST(test_json_in_progress_without_samples);
+    RUN_TEST(test_json_energy);
+    RUN_TEST(test_json_worst_case_fits_buffer);
+
+    return UNITY_END();
+}
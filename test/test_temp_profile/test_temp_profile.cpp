@@ -0,0 +1,225 @@
+/**
+ * Unit tests for temp_profile.h — runs on the host via PlatformIO native env.
+ *
+ * Covers parsing and range checks, planned duration against the session
+ * limit, and the runner driven by a fake clock: ramps, settle waits, holds,
+ * segment transitions and remaining-time reporting.
+ */
+
+#include <unity.h>
+#include "temp_profile.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+constexpr uint32_t MIN_MS = 60000;
+
+/** Parses a profile the test knows is valid (parsing is covered separately). */
+static TempProfile parsed(const char* text) {
+    TempProfile p;
+    parseProfile(text, p);
+    return p;
+}
+
+// =============================================================================
+// Parsing
+// =============================================================================
+
+void test_parse_segments(void) {
+    TempProfile p = parsed("0:80:15;1.5:90:10; 0:75:20;");
+    TEST_ASSERT_EQUAL_UINT8(3, p.count);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, p.segments[1].rateCPerMin);
+    TEST_ASSERT_EQUAL_FLOAT(90.0f, p.segments[1].holdC);
+    TEST_ASSERT_EQUAL_UINT16(20, p.segments[2].holdMin);
+}
+
+void test_parse_rejects_malformed(void) {
+    TempProfile p;
+    TEST_ASSERT_TRUE(parseProfile("", p) == ProfileResult::Empty);
+    TEST_ASSERT_TRUE(parseProfile("80:15", p) == ProfileResult::Malformed);
+    TEST_ASSERT_TRUE(parseProfile("0:80:15,1:90:10", p) == ProfileResult::Malformed);
+    TEST_ASSERT_TRUE(parseProfile("0:80:abc", p) == ProfileResult::Malformed);
+    TEST_ASSERT_TRUE(parseProfile("0:80:15;;", p) == ProfileResult::Malformed);
+}
+
+void test_parse_rejects_out_of_range(void) {
+    TempProfile p;
+    TEST_ASSERT_TRUE(parseProfile("0:101:5", p) == ProfileResult::TemperatureOutOfRange);
+    TEST_ASSERT_TRUE(parseProfile("0:39.9:5", p) == ProfileResult::TemperatureOutOfRange);
+    TEST_ASSERT_TRUE(parseProfile("0:nan:5", p) == ProfileResult::TemperatureOutOfRange);
+    TEST_ASSERT_TRUE(parseProfile("11:80:5", p) == ProfileResult::RateOutOfRange);
+    TEST_ASSERT_TRUE(parseProfile("-1:80:5", p) == ProfileResult::RateOutOfRange);
+    TEST_ASSERT_TRUE(parseProfile("0:80:61", p) == ProfileResult::HoldTooLong);
+    TEST_ASSERT_TRUE(parseProfile("0:80:-1", p) == ProfileResult::HoldTooLong);
+}
+
+void test_parse_too_many_segments(void) {
+    TempProfile p;
+    TEST_ASSERT_TRUE(parseProfile("0:80:1;0:80:1;0:80:1;0:80:1;0:80:1;0:80:1;0:80:1;0:80:1", p) ==
+                     ProfileResult::Ok);
+    TEST_ASSERT_TRUE(parseProfile("0:80:1;0:80:1;0:80:1;0:80:1;0:80:1;0:80:1;0:80:1;0:80:1;0:80:1", p) ==
+                     ProfileResult::TooManySegments);
+}
+
+void test_parse_command_body(void) {
+    TempProfile p;
+    TEST_ASSERT_TRUE(parseProfileCommand("{\"profile\": \"0:80:15;2:90:10\"}", p) == ProfileResult::Ok);
+    TEST_ASSERT_EQUAL_UINT8(2, p.count);
+    TEST_ASSERT_TRUE(parseProfileCommand("{\"profile\":0}", p) == ProfileResult::MalformedJson);
+    TEST_ASSERT_TRUE(parseProfileCommand("{\"state\":1}", p) == ProfileResult::Empty);
+    TEST_ASSERT_EQUAL_INT(400, profileHttpStatus(ProfileResult::Malformed));
+    TEST_ASSERT_EQUAL_INT(503, profileHttpStatus(ProfileResult::SensorFault));
+}
+
+// =============================================================================
+// Validation
+// =============================================================================
+
+void test_planned_duration_includes_ramps(void) {
+    // 40 → 80 at 2 °C/min = 20 min, hold 15; 80 → 70 at 1 °C/min = 10 min, hold 5
+    TempProfile p = parsed("2:80:15;1:70:5");
+    TEST_ASSERT_EQUAL_UINT32(50 * MIN_MS, profilePlannedMs(p, 40.0f));
+}
+
+void test_validate_session_limit(void) {
+    TempProfile p = parsed("1:80:30");   // 40 → 80 = 40 min ramp + 30 min hold
+    TEST_ASSERT_TRUE(validateProfileStart(p, 40.0f, SESSION_MAX_MS, false) == ProfileResult::TooLong);
+    TEST_ASSERT_TRUE(validateProfileStart(p, 60.0f, SESSION_MAX_MS, false) == ProfileResult::Ok);
+    // Inside a running session only the time left counts
+    TEST_ASSERT_TRUE(validateProfileStart(p, 60.0f, 45 * MIN_MS, false) == ProfileResult::TooLong);
+}
+
+void test_validate_sensor_fault(void) {
+    TempProfile p = parsed("0:80:10");
+    TEST_ASSERT_TRUE(validateProfileStart(p, 40.0f, SESSION_MAX_MS, true) == ProfileResult::SensorFault);
+}
+
+void test_start_setpoint_clamped(void) {
+    TEST_ASSERT_EQUAL_FLOAT(40.0f, profileStartSetpoint(21.0f));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, profileStartSetpoint(104.0f));
+    TEST_ASSERT_EQUAL_FLOAT(40.0f, profileStartSetpoint(-127.0f));
+    TEST_ASSERT_EQUAL_FLOAT(63.5f, profileStartSetpoint(63.5f));
+}
+
+// =============================================================================
+// Runner
+// =============================================================================
+
+void test_ramp_interpolates_setpoint(void) {
+    ProfileRunner r;
+    r.start(parsed("2:80:10"), 1000, 60.0f);
+    TEST_ASSERT_TRUE(r.phase() == ProfilePhase::Ramp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 60.0f, r.update(1000, 60.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 65.0f, r.update(1000 + 150000, 62.0f));   // 2.5 min
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 80.0f, r.update(1000 + 10 * MIN_MS, 75.0f));
+    TEST_ASSERT_TRUE(r.phase() == ProfilePhase::Settle);
+}
+
+void test_step_segment_sets_hold_immediately(void) {
+    ProfileRunner r;
+    r.start(parsed("0:85:10"), 0, 40.0f);
+    TEST_ASSERT_EQUAL_FLOAT(85.0f, r.update(0, 30.0f));
+}
+
+void test_hold_waits_for_room_to_settle(void) {
+    ProfileRunner r;
+    r.start(parsed("0:80:10"), 0, 40.0f);
+    r.update(0, 30.0f);
+    r.update(20 * MIN_MS, 77.9f);   // Still below the band — soak has not begun
+    TEST_ASSERT_TRUE(r.phase() == ProfilePhase::Settle);
+    TEST_ASSERT_EQUAL_UINT32(10 * MIN_MS, r.remainingMs(20 * MIN_MS));
+    r.update(25 * MIN_MS, 78.0f);
+    TEST_ASSERT_TRUE(r.phase() == ProfilePhase::Hold);
+    r.update(35 * MIN_MS - 1, 80.0f);
+    TEST_ASSERT_TRUE(r.running());
+    r.update(35 * MIN_MS, 80.0f);
+    TEST_ASSERT_TRUE(r.finished());
+}
+
+void test_cooling_segment_holds_on_arrival(void) {
+    // 90 → 80 at 1 °C/min; the hold starts when the setpoint arrives, even
+    // though the room is still hotter than the new setpoint
+    ProfileRunner r;
+    r.start(parsed("1:80:5"), 0, 90.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 85.0f, r.update(5 * MIN_MS, 90.0f));
+    r.update(10 * MIN_MS, 89.0f);
+    TEST_ASSERT_TRUE(r.phase() == ProfilePhase::Hold);
+    r.update(15 * MIN_MS, 88.0f);
+    TEST_ASSERT_TRUE(r.finished());
+}
+
+void test_segments_chain_from_previous_hold(void) {
+    ProfileRunner r;
+    r.start(parsed("0:80:10;1:90:5"), 0, 40.0f);
+    r.update(0, 80.0f);                                 // Settled at once
+    TEST_ASSERT_TRUE(r.phase() == ProfilePhase::Hold);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 80.0f, r.update(10 * MIN_MS, 80.0f));
+    TEST_ASSERT_EQUAL_UINT8(1, r.segment());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 85.0f, r.update(15 * MIN_MS, 82.0f));
+}
+
+void test_long_gap_crosses_segments(void) {
+    // Cooling segments never wait, so one late update can skip past several
+    ProfileRunner r;
+    r.start(parsed("0:90:1;0:80:1;0:70:1;0:60:1"), 0, 90.0f);
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, r.update(3 * MIN_MS + 500, 90.0f));
+    TEST_ASSERT_EQUAL_UINT8(3, r.segment());
+    TEST_ASSERT_EQUAL_UINT32(MIN_MS - 500, r.remainingMs(3 * MIN_MS + 500));
+}
+
+void test_remaining_time(void) {
+    ProfileRunner r;
+    r.start(parsed("2:80:10;0:70:5"), 0, 60.0f);    // 10 min ramp + 10 hold + 5
+    r.update(0, 60.0f);
+    TEST_ASSERT_EQUAL_UINT32(20 * MIN_MS, r.segmentRemainingMs(0));
+    TEST_ASSERT_EQUAL_UINT32(25 * MIN_MS, r.remainingMs(0));
+    r.update(4 * MIN_MS, 65.0f);
+    TEST_ASSERT_EQUAL_UINT32(21 * MIN_MS, r.remainingMs(4 * MIN_MS));
+}
+
+void test_stop_and_wrap(void) {
+    ProfileRunner r;
+    r.start(parsed("0:80:1"), 0xFFFFFFFFu - 30000, 80.0f);
+    r.update(0xFFFFFFFFu - 30000, 80.0f);
+    r.update(29998, 80.0f);                          // 59.999 s across the wrap
+    TEST_ASSERT_TRUE(r.running());
+    r.update(29999, 80.0f);
+    TEST_ASSERT_TRUE(r.finished());
+    r.stop();
+    TEST_ASSERT_FALSE(r.running());
+    TEST_ASSERT_FALSE(r.finished());
+    TEST_ASSERT_EQUAL_UINT32(0, r.remainingMs(30000));
+}
+
+// =============================================================================
+// Test Runner
+// =============================================================================
+
+int main(void) {
+    UNITY_BEGIN();
+
+    // Parsing
+    RUN_TEST(test_parse_segments);
+    RUN_TEST(test_parse_rejects_malformed);
+    RUN_TEST(test_parse_rejects_out_of_range);
+    RUN_TEST(test_parse_too_many_segments);
+    RUN_TEST(test_parse_command_body);
+
+    // Validation
+    RUN_TEST(test_planned_duration_includes_ramps);
+    RUN_TEST(test_validate_session_limit);
+    RUN_TEST(test_validate_sensor_fault);
+    RUN_TEST(test_start_setpoint_clamped);
+
+    // Runner
+    RUN_TEST(test_ramp_interpolates_setpoint);
+    RUN_TEST(test_step_segment_sets_hold_immediately);
+    RUN_TEST(test_hold_waits_for_room_to_settle);
+    RUN_TEST(test_cooling_segment_holds_on_arrival);
+    RUN_TEST(test_segments_chain_from_previous_hold);
+    RUN_TEST(test_long_gap_crosses_segments);
+    RUN_TEST(test_remaining_time);
+    RUN_TEST(test_stop_and_wrap);
+
+    return UNITY_END();
+}
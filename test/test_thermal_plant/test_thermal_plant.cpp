@@ -0,0 +1,83 @@
+/**
+ * Unit tests for thermal_plant.h — runs on the host via PlatformIO native env.
+ *
+ * Sanity-checks the emulator's plant model against the behaviour it claims.
+ */
+
+#include <unity.h>
+#include "thermal_plant.h"
+#include "sauna_logic.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_plant_idle_stays_at_ambient(void) {
+    ThermalPlantParams p;
+    ThermalPlantState s;
+    thermalPlantStep(s, p, 3600.0f, false);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, p.ambientC, s.airC);
+}
+
+void test_plant_heats_to_80_in_about_45_minutes(void) {
+    ThermalPlantParams p;
+    ThermalPlantState s;
+    thermalPlantStep(s, p, 40 * 60.0f, true);
+    TEST_ASSERT_LESS_THAN(80.0f, s.airC);
+    thermalPlantStep(s, p, 10 * 60.0f, true);
+    TEST_ASSERT_GREATER_THAN(80.0f, s.airC);
+}
+
+void test_plant_ceiling_exceeds_safety_limit(void) {
+    // The emulator must be able to drive the firmware into its over-temp path
+    ThermalPlantParams p;
+    TEST_ASSERT_GREATER_THAN(TEMP_MAX_CELSIUS, plantEquilibriumC(p, true));
+}
+
+void test_plant_cools_when_off(void) {
+    ThermalPlantParams p;
+    ThermalPlantState s;
+    s.airC = s.sensorC = 80.0f;
+    thermalPlantStep(s, p, 600.0f, false);
+    TEST_ASSERT_LESS_THAN(80.0f, s.airC);
+    TEST_ASSERT_GREATER_THAN(p.ambientC, s.airC);
+}
+
+void test_plant_sensor_lags_air(void) {
+    ThermalPlantParams p;
+    ThermalPlantState s;
+    thermalPlantStep(s, p, 300.0f, true);
+    TEST_ASSERT_LESS_THAN(s.airC, s.sensorC);
+    TEST_ASSERT_GREATER_THAN(p.ambientC, s.sensorC);
+}
+
+void test_plant_step_size_independent(void) {
+    // One large step and many small steps must land in the same place
+    ThermalPlantParams p;
+    ThermalPlantState coarse, fine;
+    thermalPlantStep(coarse, p, 120.0f, true);
+    for (int i = 0; i < 1200; ++i) thermalPlantStep(fine, p, 0.1f, true);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, coarse.airC, fine.airC);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, coarse.sensorC, fine.sensorC);
+}
+
+void test_plant_ignores_non_positive_step(void) {
+    ThermalPlantParams p;
+    ThermalPlantState s;
+    thermalPlantStep(s, p, 0.0f, true);
+    thermalPlantStep(s, p, -5.0f, true);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, s.airC);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_plant_idle_stays_at_ambient);
+    RUN_TEST(test_plant_heats_to_80_in_about_45_minutes);
+    RUN_TEST(test_plant_ceiling_exceeds_safety_limit);
+    RUN_TEST(test_plant_cools_when_off);
+    RUN_TEST(test_plant_sensor_lags_air);
+    RUN_TEST(test_plant_step_size_independent);
+    RUN_TEST(test_plant_ignores_non_positive_step);
+
+    return UNITY_END();
+}
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""
+coapctl.py — Minimal CoAP client for the sauna controller's UDP endpoint.
+
+Talks to a device or the host emulator on port 5683:
+
+    tools/coapctl.py --host 192.168.1.50 get status
+    tools/coapctl.py --host 192.168.1.50 put target '{"temperature":85}'
+    tools/coapctl.py --host 192.168.1.50 observe status --seconds 60
+    tools/coapctl.py --host 127.0.0.1 --port 15683 ping --count 200
+
+`ping` sends confirmable GET status requests, --interval apart (default
+0.1 s, the per-client sustained rate limit), and reports round-trip
+p50/p99/max, for comparing against HTTP latency from tools/loadgen.py.
+
+Standard library only.
+"""
+
+import argparse
+import json
+import os
+import random
+import socket
+import struct
+import sys
+import time
+
+CON, NON, ACK, RST = 0, 1, 2, 3
+GET, POST, PUT = 1, 2, 3
+OPT_OBSERVE, OPT_URI_PATH, OPT_CONTENT_FORMAT, OPT_MAX_AGE = 6, 11, 12, 14
+FORMAT_JSON = 50
+
+
+def code_str(code):
+    return "%d.%02d" % (code >> 5, code & 0x1F)
+
+
+def encode_uint(v):
+    out = b""
+    while v:
+        out = bytes([v & 0xFF]) + out
+        v >>= 8
+    return out
+
+
+def encode_option(delta, value):
+    def nibble(n):
+        if n < 13:
+            return n, b""
+        if n < 269:
+            return 13, bytes([n - 13])
+        return 14, struct.pack("!H", n - 269)
+
+    dn, dext = nibble(delta)
+    ln, lext = nibble(len(value))
+    return bytes([dn << 4 | ln]) + dext + lext + value
+
+
+def encode(mtype, code, mid, token, options, payload=b""):
+    out = bytes([1 << 6 | mtype << 4 | len(token), code]) + struct.pack("!H", mid) + token
+    prev = 0
+    for number, value in sorted(options, key=lambda o: o[0]):
+        out += encode_option(number - prev, value)
+        prev = number
+    if payload:
+        out += b"\xff" + payload
+    return out
+
+
+def decode(data):
+    if len(data) < 4:
+        raise ValueError("short datagram")
+    tkl = data[0] & 0x0F
+    msg = {
+        "type": (data[0] >> 4) & 3,
+        "code": data[1],
+        "mid": struct.unpack("!H", data[2:4])[0],
+        "token": data[4:4 + tkl],
+        "options": {},
+        "payload": b"",
+    }
+    i = 4 + tkl
+    number = 0
+    while i < len(data):
+        if data[i] == 0xFF:
+            msg["payload"] = data[i + 1:]
+            break
+        dn, ln = data[i] >> 4, data[i] & 0x0F
+        i += 1
+        vals = []
+        for n in (dn, ln):
+            if n == 13:
+                vals.append(13 + data[i])
+                i += 1
+            elif n == 14:
+                vals.append(269 + struct.unpack("!H", data[i:i + 2])[0])
+                i += 2
+            else:
+                vals.append(n)
+        number += vals[0]
+        msg["options"][number] = data[i:i + vals[1]]
+        i += vals[1]
+    return msg
+
+
+class Client:
+    def __init__(self, host, port, timeout):
+        self.addr = (host, port)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.settimeout(timeout)
+        self.mid = random.randrange(0x10000)
+
+    def next_mid(self):
+        self.mid = (self.mid + 1) & 0xFFFF
+        return self.mid
+
+    def request(self, code, path, payload=b"", observe=None):
+        token = os.urandom(4)
+        options = [(OPT_URI_PATH, seg.encode()) for seg in path.split("/") if seg]
+        if payload:
+            options.append((OPT_CONTENT_FORMAT, encode_uint(FORMAT_JSON)))
+        if observe is not None:
+            options.append((OPT_OBSERVE, encode_uint(observe)))
+        mid = self.next_mid()
+        self.sock.sendto(encode(CON, code, mid, token, options, payload), self.addr)
+        while True:
+            msg = decode(self.sock.recvfrom(2048)[0])
+            if msg["mid"] == mid or msg["token"] == token:
+                return msg, token
+
+    def ack(self, msg):
+        self.sock.sendto(encode(ACK, 0, msg["mid"], b"", []), self.addr)
+
+
+def show(msg):
+    body = msg["payload"].decode(errors="replace")
+    extra = ""
+    if OPT_OBSERVE in msg["options"]:
+        extra += " obs=%d" % int.from_bytes(msg["options"][OPT_OBSERVE], "big")
+    if OPT_MAX_AGE in msg["options"]:
+        extra += " max-age=%d" % int.from_bytes(msg["options"][OPT_MAX_AGE], "big")
+    print("%s%s %s" % (code_str(msg["code"]), extra, body))
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    k = min(len(sorted_values) - 1, int(round(p / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[k]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=5683)
+    ap.add_argument("--timeout", type=float, default=2.0)
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("get")
+    p.add_argument("path")
+    for name in ("put", "post"):
+        p = sub.add_parser(name)
+        p.add_argument("path")
+        p.add_argument("body")
+    p = sub.add_parser("observe")
+    p.add_argument("path")
+    p.add_argument("--seconds", type=float, default=60.0)
+    p = sub.add_parser("ping")
+    p.add_argument("--count", type=int, default=100)
+    p.add_argument("--interval", type=float, default=0.1)
+    args = ap.parse_args()
+
+    c = Client(args.host, args.port, args.timeout)
+    try:
+        if args.cmd == "get":
+            show(c.request(GET, args.path)[0])
+        elif args.cmd in ("put", "post"):
+            json.loads(args.body)   # Fail early on a typo
+            show(c.request(PUT if args.cmd == "put" else POST, args.path, args.body.encode())[0])
+        elif args.cmd == "observe":
+            msg, token = c.request(GET, args.path, observe=0)
+            show(msg)
+            if OPT_OBSERVE not in msg["options"]:
+                print("not registered (observer table full?)", file=sys.stderr)
+                return 1
+            end = time.time() + args.seconds
+            c.sock.settimeout(1.0)
+            while time.time() < end:
+                try:
+                    msg = decode(c.sock.recvfrom(2048)[0])
+                except socket.timeout:
+                    continue
+                if msg["token"] != token:
+                    continue
+                if msg["type"] == CON:
+                    c.ack(msg)
+                show(msg)
+            c.sock.settimeout(args.timeout)
+            c.request(GET, args.path, observe=1)
+        elif args.cmd == "ping":
+            rtts = []
+            lost = refused = 0
+            for i in range(args.count):
+                if i:
+                    time.sleep(args.interval)
+                start = time.perf_counter()
+                try:
+                    msg, _ = c.request(GET, "status")
+                except socket.timeout:
+                    lost += 1
+                    continue
+                if msg["code"] >> 5 == 2:
+                    rtts.append((time.perf_counter() - start) * 1000.0)
+                else:
+                    refused += 1   # 5.03: rate limited
+            rtts.sort()
+            print("%d ok, %d refused, %d lost  rtt ms: p50 %.2f  p99 %.2f  max %.2f" % (
+                len(rtts), refused, lost, percentile(rtts, 50), percentile(rtts, 99),
+                rtts[-1] if rtts else 0.0))
+    except socket.timeout:
+        print("timeout", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""
+loadgen.py — REST API load and latency benchmark for the sauna controller.
+
+Replays a realistic client mix against the port-8080 API: many pollers on
+GET /status (the iOS app polls every 2 s), occasional /heater, /target and
+/session writes, and a share of malformed bodies. Runs against a real
+device or the host emulator (pio run -e emulator).
+
+Reports throughput, p50/p99/max latency per endpoint, error rates, how often
+a request landed while a DS18B20 conversion was pending (X-Sensor-Phase
+response header), and the device's worst control-loop gap (GET /diag).
+
+    tools/loadgen.py --host 192.168.1.50 --pollers 8 --duration 60
+    tools/loadgen.py --host 127.0.0.1 --sweep 1,2,4,8,16,32
+
+Safety: writes only ever send state=0 (OFF) unless --allow-heat is given.
+Never use --allow-heat against a real heater you are not watching.
+
+Standard library only.
+"""
+
+import argparse
+import http.client
+import json
+import random
+import threading
+import time
+
+STATUS_PATH = "/status"
+DIAG_PATH = "/diag"
+
+MALFORMED_BODIES = [
+    ("/heater", "application/json", '{"state":"on"}'),
+    ("/heater", "application/json", '{"state" 1}'),
+    ("/heater", "text/plain", '{"state":0}'),
+    ("/target", "application/json", '{"temperature":999}'),
+    ("/target", "application/json", '{"temperature":hot}'),
+    ("/target", "application/json", "{}"),
+    ("/session", "application/json", '{"state":2,"temperature":80}'),
+    ("/session", "application/json", "not json at all"),
+]
+
+
+class Stats:
+    """Thread-safe per-endpoint latency and outcome accumulator."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies = {}      # endpoint -> [seconds]
+        self.codes = {}          # endpoint -> {code: count}
+        self.failures = {}       # endpoint -> transport failures (timeout, reset)
+        self.converting = 0
+        self.phase_known = 0
+
+    def record(self, endpoint, seconds, code, phase):
+        with self.lock:
+            self.latencies.setdefault(endpoint, []).append(seconds)
+            by_code = self.codes.setdefault(endpoint, {})
+            by_code[code] = by_code.get(code, 0) + 1
+            if phase is not None:
+                self.phase_known += 1
+                if phase == "converting":
+                    self.converting += 1
+
+    def fail(self, endpoint):
+        with self.lock:
+            self.failures[endpoint] = self.failures.get(endpoint, 0) + 1
+
+
+def request(args, method, path, body=None, content_type=None):
+    """One request on a fresh connection (the device closes after each)."""
+    conn = http.client.HTTPConnection(args.host, args.port, timeout=args.timeout)
+    try:
+        headers = {}
+        if body is not None:
+            headers["Content-Type"] = content_type or "application/json"
+        start = time.perf_counter()
+        conn.request(method, path, body=body, headers=headers)
+        resp = conn.getresponse()
+        payload = resp.read()
+        elapsed = time.perf_counter() - start
+        return resp.status, elapsed, resp.getheader("X-Sensor-Phase"), payload
+    finally:
+        conn.close()
+
+
+def timed(args, stats, label, method, path, body=None, content_type=None):
+    try:
+        code, elapsed, phase, _ = request(args, method, path, body, content_type)
+        stats.record(label, elapsed, code, phase)
+    except (OSError, http.client.HTTPException):
+        stats.fail(label)
+
+
+def poller(args, stats, stop):
+    # Stagger start so pollers do not arrive in lockstep
+    stop.wait(random.uniform(0, args.poll_interval))
+    while not stop.is_set():
+        begin = time.monotonic()
+        timed(args, stats, "GET /status", "GET", STATUS_PATH)
+        stop.wait(max(0.0, args.poll_interval - (time.monotonic() - begin)))
+
+
+def writer(args, stats, stop):
+    stop.wait(random.uniform(0, args.write_interval))
+    while not stop.is_set():
+        if random.random() < args.malformed_rate:
+            path, ctype, body = random.choice(MALFORMED_BODIES)
+            timed(args, stats, "malformed", "POST", path, body, ctype)
+        else:
+            state = random.choice([0, 1]) if args.allow_heat else 0
+            temp = round(random.uniform(60.0, 90.0), 1)
+            path, body = random.choice([
+                ("/heater", json.dumps({"state": state})),
+                ("/target", json.dumps({"temperature": temp})),
+                ("/session", json.dumps({"state": state, "temperature": temp})),
+            ])
+            timed(args, stats, "POST " + path, "POST", path, body)
+        stop.wait(args.write_interval * random.uniform(0.5, 1.5))
+
+
+def read_diag(args):
+    """Returns the device's /diag JSON, or None if unavailable."""
+    try:
+        code, _, _, payload = request(args, "GET", DIAG_PATH)
+        return json.loads(payload) if code == 200 else None
+    except (OSError, http.client.HTTPException, ValueError):
+        return None
+
+
+def percentile(sorted_values, pct):
+    if not sorted_values:
+        return 0.0
+    idx = min(len(sorted_values) - 1, int(round(pct / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[idx]
+
+
+def run_stage(args, pollers):
+    stats = Stats()
+    stop = threading.Event()
+    read_diag(args)  # resets the device's loop-gap maximum
+
+    threads = [threading.Thread(target=poller, args=(args, stats, stop), daemon=True)
+               for _ in range(pollers)]
+    threads += [threading.Thread(target=writer, args=(args, stats, stop), daemon=True)
+                for _ in range(args.writers)]
+    start = time.monotonic()
+    for t in threads:
+        t.start()
+    time.sleep(args.duration)
+    stop.set()
+    for t in threads:
+        t.join(args.timeout + 1)
+    elapsed = time.monotonic() - start
+    return stats, elapsed, read_diag(args)
+
+
+def summarize(stats, elapsed):
+    total = sum(len(v) for v in stats.latencies.values())
+    failures = sum(stats.failures.values())
+    all_lat = sorted(x for v in stats.latencies.values() for x in v)
+    unexpected = 0
+    rate_limited = 0
+    for label, by_code in stats.codes.items():
+        for code, count in by_code.items():
+            expected_error = label == "malformed" and 400 <= code < 500
+            if code == 429:
+                rate_limited += count   # Admission control, not a failure
+            elif code >= 400 and not expected_error:
+                unexpected += count
+    return {
+        "requests": total,
+        "rps": total / elapsed if elapsed > 0 else 0.0,
+        "p50_ms": percentile(all_lat, 50) * 1000,
+        "p99_ms": percentile(all_lat, 99) * 1000,
+        "max_ms": (all_lat[-1] if all_lat else 0.0) * 1000,
+        "failures": failures,
+        "unexpected_status": unexpected,
+        "rate_limited": rate_limited,
+        "converting_pct": 100.0 * stats.converting / stats.phase_known if stats.phase_known else 0.0,
+    }
+
+
+def print_report(args, stats, elapsed, diag):
+    print("\n%-16s %7s %9s %9s %9s  %s" % ("endpoint", "count", "p50 ms", "p99 ms", "max ms", "status codes"))
+    for label in sorted(stats.latencies):
+        lat = sorted(stats.latencies[label])
+        codes = " ".join("%d:%d" % kv for kv in sorted(stats.codes[label].items()))
+        print("%-16s %7d %9.1f %9.1f %9.1f  %s" % (
+            label, len(lat), percentile(lat, 50) * 1000, percentile(lat, 99) * 1000,
+            lat[-1] * 1000, codes))
+    for label, count in sorted(stats.failures.items()):
+        print("%-16s %7d transport failures (timeout/reset/refused)" % (label, count))
+
+    s = summarize(stats, elapsed)
+    print("\nthroughput        %.1f req/s over %.1f s" % (s["rps"], elapsed))
+    print("latency (all)     p50 %.1f ms, p99 %.1f ms, max %.1f ms" % (s["p50_ms"], s["p99_ms"], s["max_ms"]))
+    print("errors            %d transport, %d unexpected HTTP status" % (s["failures"], s["unexpected_status"]))
+    print("rate limited      %d responses with 429 (all clients share this host's IP)" % s["rate_limited"])
+    print("sensor phase      %.1f%% of responses sent during a DS18B20 conversion" % s["converting_pct"])
+    if diag:
+        print("control loop      worst gap %.1f ms over %d passes" % (
+            diag.get("loop_gap_max_us", 0) / 1000.0, diag.get("loop_passes", 0)))
+        if "network_deferrals" in diag:
+            print("admission         %d rejected, %d network passes deferred (since boot)" % (
+                diag.get("http_rejected", 0), diag.get("network_deferrals", 0)))
+        jobs = diag.get("jobs", {})
+        if jobs:
+            late = ", ".join("%s %d ms" % (name, job.get("late_max_ms", 0)) for name, job in sorted(jobs.items()))
+            print("scheduler         %.1f%% idle; worst lateness: %s" % (diag.get("idle_pct", 0.0), late))
+    else:
+        print("control loop      (GET /diag unavailable)")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=8080)
+    ap.add_argument("--duration", type=float, default=30.0, help="seconds per stage (default 30)")
+    ap.add_argument("--pollers", type=int, default=4, help="concurrent /status pollers (default 4)")
+    ap.add_argument("--poll-interval", type=float, default=2.0, help="seconds between polls per poller (default 2, like the app)")
+    ap.add_argument("--writers", type=int, default=1, help="concurrent command writers (default 1)")
+    ap.add_argument("--write-interval", type=float, default=10.0, help="mean seconds between writes per writer (default 10)")
+    ap.add_argument("--malformed-rate", type=float, default=0.2, help="fraction of writes with a malformed body (default 0.2)")
+    ap.add_argument("--timeout", type=float, default=5.0, help="per-request timeout, matches the app (default 5)")
+    ap.add_argument("--sweep", help="comma-separated poller counts; prints one summary row per stage")
+    ap.add_argument("--gap-limit-ms", type=float, default=100.0,
+                    help="control-loop gap considered degraded in --sweep (default 100)")
+    ap.add_argument("--allow-heat", action="store_true", help="let writers send state=1 (turns the heater ON)")
+    ap.add_argument("--seed", type=int, help="random seed for a reproducible mix")
+    args = ap.parse_args()
+
+    if args.seed is not None:
+        random.seed(args.seed)
+
+    if not args.sweep:
+        stats, elapsed, diag = run_stage(args, args.pollers)
+        print_report(args, stats, elapsed, diag)
+        return
+
+    print("%8s %9s %9s %9s %9s %8s %6s %9s %11s" % (
+        "pollers", "req/s", "p50 ms", "p99 ms", "max ms", "errors", "429s", "conv %", "loop gap ms"))
+    for count in [int(x) for x in args.sweep.split(",") if x.strip()]:
+        stats, elapsed, diag = run_stage(args, count)
+        s = summarize(stats, elapsed)
+        gap = diag.get("loop_gap_max_us", 0) / 1000.0 if diag else float("nan")
+        flag = "  <- degraded" if gap > args.gap_limit_ms else ""
+        print("%8d %9.1f %9.1f %9.1f %9.1f %8d %6d %9.1f %11.1f%s" % (
+            count, s["rps"], s["p50_ms"], s["p99_ms"], s["max_ms"],
+            s["failures"] + s["unexpected_status"], s["rate_limited"], s["converting_pct"], gap, flag))
+
+
+if __name__ == "__main__":
+    main()
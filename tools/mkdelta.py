@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+mkdelta.py — Build and apply delta OTA patches (format in include/delta_patch.h).
+
+    tools/mkdelta.py diff old.bin new.bin -o update.delta
+    tools/mkdelta.py apply old.bin update.delta -o rebuilt.bin
+
+`old.bin` must be exactly the image currently running on the device
+(.pio/build/esp32/firmware.bin from the build you flashed) — the device
+rejects patches whose source hash does not match before writing anything.
+
+Upload with:
+
+    curl -H "X-OTA-Password: <password>" -F "patch=@update.delta" \\
+         http://<ESP32-IP>:8080/ota/delta
+
+Matching: every 4-byte-aligned BLOCK-byte window of the old image is
+indexed; the new image is scanned byte by byte, and hits are verified and
+extended in both directions. Unmatched bytes become INSERT ops.
+
+Standard library only.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+MAGIC = b"SDP1"
+OP_END, OP_COPY, OP_INSERT = 0x00, 0x01, 0x02
+BLOCK = 32          # Minimum match length worth a COPY op
+INDEX_STRIDE = 4    # ESP32 code and data are word-aligned
+
+
+def varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def read_varint(data, pos):
+    value, shift = 0, 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return value, pos
+        shift += 7
+        if shift > 28:
+            raise ValueError("varint too long")
+
+
+def build_index(old):
+    index = {}
+    for off in range(0, len(old) - BLOCK + 1, INDEX_STRIDE):
+        index.setdefault(old[off:off + BLOCK], off)
+    return index
+
+
+def diff(old, new):
+    index = build_index(old)
+    ops = []            # ("copy", off, len) | ("insert", bytes)
+    pending_start = 0   # start of bytes not yet covered by an op
+    pos = 0
+    while pos + BLOCK <= len(new):
+        src = index.get(new[pos:pos + BLOCK])
+        if src is None:
+            pos += 1
+            continue
+        # Extend backwards into the pending literal run, then forwards
+        start, s = pos, src
+        while start > pending_start and s > 0 and new[start - 1] == old[s - 1]:
+            start -= 1
+            s -= 1
+        end, e = pos + BLOCK, src + BLOCK
+        while end < len(new) and e < len(old) and new[end] == old[e]:
+            end += 1
+            e += 1
+        if start > pending_start:
+            ops.append(("insert", new[pending_start:start]))
+        ops.append(("copy", s, end - start))
+        pending_start = pos = end
+    if pending_start < len(new):
+        ops.append(("insert", new[pending_start:]))
+    return ops
+
+
+def encode(old, new, ops):
+    out = bytearray(MAGIC)
+    out += struct.pack("<II", len(old), len(new))
+    out += hashlib.sha256(old).digest()
+    out += hashlib.sha256(new).digest()
+    for op in ops:
+        if op[0] == "copy":
+            out.append(OP_COPY)
+            out += varint(op[1]) + varint(op[2])
+        else:
+            out.append(OP_INSERT)
+            out += varint(len(op[1])) + op[1]
+    out.append(OP_END)
+    return bytes(out)
+
+
+def apply(old, patch):
+    """Reference applier — mirrors DeltaPatchApplier, used for --verify."""
+    if patch[:4] != MAGIC:
+        raise ValueError("not a delta patch")
+    src_size, dst_size = struct.unpack_from("<II", patch, 4)
+    src_hash, dst_hash = patch[12:44], patch[44:76]
+    if src_size > len(old) or hashlib.sha256(old[:src_size]).digest() != src_hash:
+        raise ValueError("patch does not match source image")
+    out = bytearray()
+    pos = 76
+    while True:
+        op = patch[pos]
+        pos += 1
+        if op == OP_END:
+            break
+        if op == OP_COPY:
+            off, pos = read_varint(patch, pos)
+            length, pos = read_varint(patch, pos)
+            if off + length > src_size:
+                raise ValueError("copy out of range")
+            out += old[off:off + length]
+        elif op == OP_INSERT:
+            length, pos = read_varint(patch, pos)
+            out += patch[pos:pos + length]
+            pos += length
+        else:
+            raise ValueError("unknown op 0x%02x" % op)
+    if pos != len(patch):
+        raise ValueError("trailing bytes after END")
+    if len(out) != dst_size or hashlib.sha256(out).digest() != dst_hash:
+        raise ValueError("rebuilt image does not match target hash")
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    d = sub.add_parser("diff", help="build a patch from old.bin to new.bin")
+    d.add_argument("old")
+    d.add_argument("new")
+    d.add_argument("-o", "--output", required=True)
+    d.add_argument("--no-verify", action="store_true", help="skip re-applying the patch as a check")
+    a = sub.add_parser("apply", help="rebuild new.bin from old.bin and a patch")
+    a.add_argument("old")
+    a.add_argument("patch")
+    a.add_argument("-o", "--output", required=True)
+    args = ap.parse_args()
+
+    with open(args.old, "rb") as f:
+        old = f.read()
+
+    if args.cmd == "apply":
+        with open(args.patch, "rb") as f:
+            rebuilt = apply(old, f.read())
+        with open(args.output, "wb") as f:
+            f.write(rebuilt)
+        print("rebuilt %d bytes" % len(rebuilt))
+        return 0
+
+    with open(args.new, "rb") as f:
+        new = f.read()
+    ops = diff(old, new)
+    patch = encode(old, new, ops)
+    if not args.no_verify and apply(old, patch) != new:
+        print("internal error: patch does not reproduce new image", file=sys.stderr)
+        return 1
+    with open(args.output, "wb") as f:
+        f.write(patch)
+
+    copied = sum(op[2] for op in ops if op[0] == "copy")
+    print("%s: %d bytes (%.1f%% of %d-byte image), %d ops, %.1f%% of image reused" % (
+        args.output, len(patch), 100.0 * len(patch) / max(1, len(new)), len(new),
+        len(ops), 100.0 * copied / max(1, len(new))))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())